@@ -0,0 +1,62 @@
+/*
+ * Gerado por afd_gen a partir de src/lexer/datalang_afn.c -- NÃO EDITAR
+ * AFD mínimo: 25 estados, 22 classes de bytes
+ */
+
+#include "afd_table.h"
+
+const int datalang_afd_num_states = 25;
+const int datalang_afd_num_classes = 22;
+const int datalang_afd_start_state = 0;
+
+const unsigned char datalang_afd_byte_class[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   2,   0,   0,   3,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      1,   4,   5,   0,   0,   6,   7,   0,   8,   8,   9,  10,   6,  11,  12,  13,
+     14,  14,  14,  14,  14,  14,  14,  14,  14,  14,   6,   8,   4,  15,  16,   0,
+      0,  17,  17,  17,  17,  18,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,
+     17,  17,  17,  17,  17,  17,  17,  17,  17,  17,  17,   8,  19,   8,   0,  17,
+      0,  17,  17,  17,  17,  18,  17,  17,  17,  17,  17,  17,  17,  17,  20,  17,
+     17,  17,  20,  17,  20,  17,  17,  17,  17,  17,  17,   8,  21,   8,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+const short datalang_afd_transitions[550] = {
+    /*   0 */ -1, 1, 1, 1, 2, 3, 4, 5, 6, 4, 7, 8, 9, 10, 11, 2, 2, 12, 12, -1, 12, 13,
+    /*   1 */ -1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*   2 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, -1, -1, -1, -1, -1, -1,
+    /*   3 */ 3, 3, -1, 3, 3, 14, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 15, 3, 3,
+    /*   4 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*   5 */ -1, -1, -1, -1, -1, -1, -1, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*   6 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*   7 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, 11, -1, -1, -1, -1, -1, -1, -1,
+    /*   8 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, 11, -1, 4, -1, -1, -1, -1, -1,
+    /*   9 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 6, -1, 17, -1, -1, -1, -1, -1, -1, -1,
+    /*  10 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, 18, -1, -1, -1, 19, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*  11 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, 11, -1, -1, -1, 20, -1, -1, -1,
+    /*  12 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 12, -1, -1, 12, 12, -1, 12, -1,
+    /*  13 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, -1, -1, -1, -1, 4,
+    /*  14 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*  15 */ -1, -1, -1, -1, -1, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 3, 3, -1,
+    /*  16 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 17, -1, -1, -1, -1, -1, -1, -1,
+    /*  17 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 17, -1, -1, -1, 20, -1, -1, -1,
+    /*  18 */ 18, 18, 18, 18, 18, 18, 18, 18, 18, 21, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    /*  19 */ 19, 19, 22, 22, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    /*  20 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 23, 23, -1, -1, 24, -1, -1, -1, -1, -1, -1, -1,
+    /*  21 */ 18, 18, 18, 18, 18, 18, 18, 18, 18, 21, 18, 18, 18, 22, 18, 18, 18, 18, 18, 18, 18, 18,
+    /*  22 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    /*  23 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 24, -1, -1, -1, -1, -1, -1, -1,
+    /*  24 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 24, -1, -1, -1, -1, -1, -1, -1,
+};
+
+const unsigned char datalang_afd_token_types[25] = {
+     68,  66,  53,  68,  53,  53,  65,  53,  53,  53,  53,  33,  32,  53,  35,  68,
+     68,  34,  68,  67,  68,  68,  67,  68,  34,
+};
@@ -8,17 +8,20 @@
 #include <string.h>
 #include <stdarg.h>
 #include "codegen.h"
+#include "intern.h"
+#include "log.h"
 
 // ==================== FUNÇÕES AUXILIARES INTERNAS ====================
 
+// Nomes e valores gerados vivem até o fim da compilação: vêm da arena
 static char* gen_temp(CodeGenContext* ctx) {
-    char* temp = malloc(32);
+    char* temp = arena_alloc(ctx->arena, 32);
     snprintf(temp, 32, "%%t%d", ctx->temp_counter++);
     return temp;
 }
 
 static char* gen_label(CodeGenContext* ctx) {
-    char* label = malloc(32);
+    char* label = arena_alloc(ctx->arena, 32);
     snprintf(label, 32, "L%d", ctx->label_counter++);
     return label;
 }
@@ -30,14 +33,95 @@ static void emit(CodeGenContext* ctx, const char* format, ...) {
     va_end(args);
 }
 
+// ==================== SSA: BLOCOS, ALLOCAS E STRUCTS ====================
+
+// Os phis dos laços precisam do bloco de origem de cada aresta; como uma
+// expressão pode abrir blocos próprios (ex.: == de String), o bloco corrente
+// é rastreado a cada label emitido.
+static void set_current_block(CodeGenContext* ctx, const char* label) {
+    snprintf(ctx->current_block, sizeof(ctx->current_block), "%s", label);
+}
+
+static void emit_label(CodeGenContext* ctx, const char* label) {
+    emit(ctx, "\n%s:\n", label);
+    set_current_block(ctx, label);
+}
+
+// Slot de variável: vai sempre para o bloco de entrada da função, onde o
+// mem2reg consegue promovê-lo a registrador e a pilha não cresce em laços
+static char* emit_alloca(CodeGenContext* ctx, const char* llvm_type) {
+    char* slot = gen_temp(ctx);
+    fprintf(ctx->entry_allocas ? ctx->entry_allocas : ctx->output,
+            "  %s = alloca %s\n", slot, llvm_type);
+    return slot;
+}
+
+// Corpo de função em geração: o corpo e as allocas são acumulados em
+// buffers separados e só escritos no fim, com as allocas no bloco entry
+typedef struct {
+    FILE* output;
+    FILE* entry_allocas;
+    char current_block[64];
+    char* body;
+    size_t body_len;
+    char* allocas;
+    size_t allocas_len;
+} FunctionBody;
+
+static void begin_function_body(CodeGenContext* ctx, FunctionBody* fb) {
+    fb->output = ctx->output;
+    fb->entry_allocas = ctx->entry_allocas;
+    memcpy(fb->current_block, ctx->current_block, sizeof(fb->current_block));
+    fb->body = NULL;
+    fb->allocas = NULL;
+    ctx->output = open_memstream(&fb->body, &fb->body_len);
+    ctx->entry_allocas = open_memstream(&fb->allocas, &fb->allocas_len);
+    if (!ctx->output || !ctx->entry_allocas) {
+        log_error("Erro: falha ao alocar buffer de função\n");
+        exit(1);
+    }
+    set_current_block(ctx, "entry");
+}
+
+static void end_function_body(CodeGenContext* ctx, FunctionBody* fb) {
+    fclose(ctx->output);
+    fclose(ctx->entry_allocas);
+    ctx->output = fb->output;
+    ctx->entry_allocas = fb->entry_allocas;
+    memcpy(ctx->current_block, fb->current_block, sizeof(ctx->current_block));
+    emit(ctx, "entry:\n");
+    fwrite(fb->allocas, 1, fb->allocas_len, ctx->output);
+    fwrite(fb->body, 1, fb->body_len, ctx->output);
+    free(fb->allocas);
+    free(fb->body);
+}
+
+// Monta o valor {i64, T*} de um array direto em registradores
+static char* emit_array_struct(CodeGenContext* ctx, const char* elem_llvm,
+                               const char* size, const char* data) {
+    char* partial = gen_temp(ctx);
+    emit(ctx, "  %s = insertvalue {i64, %s*} undef, i64 %s, 0\n", partial, elem_llvm, size);
+    char* result = gen_temp(ctx);
+    emit(ctx, "  %s = insertvalue {i64, %s*} %s, %s* %s, 1\n", result, elem_llvm, partial, elem_llvm, data);
+    return result;
+}
+
+// Posição do literal (internado) na tabela hash: índice + 1, ou 0 se livre
+static int* string_literal_bucket(CodeGenContext* ctx, const char* value) {
+    unsigned mask = (unsigned)ctx->string_literals.bucket_capacity - 1;
+    unsigned i = intern_hash(value) & mask;
+    while (ctx->string_literals.buckets[i] &&
+           ctx->string_literals.values[ctx->string_literals.buckets[i] - 1] != value) {
+        i = (i + 1) & mask;
+    }
+    return &ctx->string_literals.buckets[i];
+}
+
 static char* register_string_literal(CodeGenContext* ctx, const char* value) {
-    if (!value) value = "";
+    value = intern_cstr(value ? value : "");
     
-    for (int i = 0; i < ctx->string_literals.count; i++) {
-        if (strcmp(ctx->string_literals.values[i], value) == 0) {
-            return ctx->string_literals.llvm_names[i];
-        }
-    }
+    int* bucket = string_literal_bucket(ctx, value);
+    if (*bucket) return ctx->string_literals.llvm_names[*bucket - 1];
     
     if (ctx->string_literals.count >= ctx->string_literals.capacity) {
         ctx->string_literals.capacity = (ctx->string_literals.capacity == 0) ? 16 : ctx->string_literals.capacity * 2;
@@ -47,37 +131,99 @@ static char* register_string_literal(CodeGenContext* ctx, const char* value) {
             ctx->string_literals.capacity * sizeof(char*));
     }
     
-    char* llvm_name = malloc(64);
+    char* llvm_name = arena_alloc(ctx->arena, 64);
     snprintf(llvm_name, 64, "@.str.%d", ctx->string_counter++);
     
-    ctx->string_literals.values[ctx->string_literals.count] = strdup(value);
+    ctx->string_literals.values[ctx->string_literals.count] = (char*)value;
     ctx->string_literals.llvm_names[ctx->string_literals.count] = llvm_name;
-    ctx->string_literals.count++;
+    *bucket = ++ctx->string_literals.count;
+    
+    // Mantém a ocupação abaixo de 50%
+    if (ctx->string_literals.count * 2 > ctx->string_literals.bucket_capacity) {
+        free(ctx->string_literals.buckets);
+        ctx->string_literals.bucket_capacity *= 2;
+        ctx->string_literals.buckets = calloc(ctx->string_literals.bucket_capacity, sizeof(int));
+        for (int i = 0; i < ctx->string_literals.count; i++) {
+            *string_literal_bucket(ctx, ctx->string_literals.values[i]) = i + 1;
+        }
+    }
     
     return llvm_name;
 }
 
+// Bucket do nome (internado) no mapa de variáveis; cria um vazio (head -1)
+// se pedido
+static VarMapBucket* var_map_bucket(CodeGenContext* ctx, const char* name, bool create) {
+    uint32_t hash = intern_hash(name);
+    unsigned mask = (unsigned)ctx->var_map.bucket_capacity - 1;
+    unsigned i = hash & mask;
+    for (; ctx->var_map.buckets[i].name; i = (i + 1) & mask) {
+        if (ctx->var_map.buckets[i].name == name) return &ctx->var_map.buckets[i];
+    }
+    if (!create) return NULL;
+
+    if ((ctx->var_map.bucket_count + 1) * 2 > ctx->var_map.bucket_capacity) {
+        // Rehash: as declarações guardam o índice do bucket, então são remapeadas
+        VarMapBucket* old = ctx->var_map.buckets;
+        int old_capacity = ctx->var_map.bucket_capacity;
+        int* remap = malloc(old_capacity * sizeof(int));
+        ctx->var_map.bucket_capacity *= 2;
+        ctx->var_map.buckets = calloc(ctx->var_map.bucket_capacity, sizeof(VarMapBucket));
+        mask = (unsigned)ctx->var_map.bucket_capacity - 1;
+        for (int j = 0; j < old_capacity; j++) {
+            if (!old[j].name) continue;
+            unsigned k = intern_hash(old[j].name) & mask;
+            while (ctx->var_map.buckets[k].name) k = (k + 1) & mask;
+            ctx->var_map.buckets[k] = old[j];
+            remap[j] = (int)k;
+        }
+        for (int j = 0; j < ctx->var_map.count; j++) {
+            ctx->var_map.slots[j] = remap[ctx->var_map.slots[j]];
+        }
+        free(remap);
+        free(old);
+        for (i = hash & mask; ctx->var_map.buckets[i].name; i = (i + 1) & mask) {}
+    }
+
+    VarMapBucket* bucket = &ctx->var_map.buckets[i];
+    bucket->name = name;
+    bucket->head = -1;
+    ctx->var_map.bucket_count++;
+    return bucket;
+}
+
 static void add_var_mapping(CodeGenContext* ctx, const char* name, const char* llvm_name) {
     if (ctx->var_map.count >= ctx->var_map.capacity) {
         ctx->var_map.capacity = (ctx->var_map.capacity == 0) ? 16 : ctx->var_map.capacity * 2;
-        ctx->var_map.names = realloc(ctx->var_map.names,
-            ctx->var_map.capacity * sizeof(char*));
         ctx->var_map.llvm_names = realloc(ctx->var_map.llvm_names,
             ctx->var_map.capacity * sizeof(char*));
+        ctx->var_map.slots = realloc(ctx->var_map.slots,
+            ctx->var_map.capacity * sizeof(int));
+        ctx->var_map.shadowed = realloc(ctx->var_map.shadowed,
+            ctx->var_map.capacity * sizeof(int));
+    }
+    
+    VarMapBucket* bucket = var_map_bucket(ctx, intern_cstr(name), true);
+    int index = ctx->var_map.count++;
+    ctx->var_map.llvm_names[index] = arena_strdup(ctx->arena, llvm_name);
+    ctx->var_map.slots[index] = (int)(bucket - ctx->var_map.buckets);
+    ctx->var_map.shadowed[index] = bucket->head;
+    bucket->head = index;
+}
+
+// Descarta as declarações feitas depois de saved_count (saída de escopo)
+static void truncate_var_mappings(CodeGenContext* ctx, int saved_count) {
+    while (ctx->var_map.count > saved_count) {
+        int index = --ctx->var_map.count;
+        ctx->var_map.buckets[ctx->var_map.slots[index]].head = ctx->var_map.shadowed[index];
     }
-    
-    ctx->var_map.names[ctx->var_map.count] = strdup(name);
-    ctx->var_map.llvm_names[ctx->var_map.count] = strdup(llvm_name);
-    ctx->var_map.count++;
 }
 
 static char* get_var_llvm_name(CodeGenContext* ctx, const char* name) {
-    for (int i = ctx->var_map.count - 1; i >= 0; i--) {
-        if (strcmp(ctx->var_map.names[i], name) == 0) {
-            return ctx->var_map.llvm_names[i];
-        }
-    }
-    return NULL;
+    const char* key = intern_find(name);
+    VarMapBucket* bucket = key ? var_map_bucket(ctx, key, false) : NULL;
+    if (!bucket || bucket->head < 0) return NULL;
+    return ctx->var_map.llvm_names[bucket->head];
 }
 
 // ==================== DATA TYPES MANAGEMENT ====================
@@ -174,6 +320,11 @@ static char* generate_groupby_from_array(CodeGenContext* ctx, ASTNode* node, cha
 static char* generate_dataframe_from_array(CodeGenContext* ctx, char* array_val, Type* array_type, DataTypeInfo* dt);
 static void generate_global_initializers_fn(CodeGenContext* ctx, ASTNode* program);
 static char* generate_reduce_transform(CodeGenContext* ctx, ASTNode* node, char* input_array, Type* array_type);
+static bool is_lambda_with_params(ASTNode* lambda, int count);
+static Type* lambda_param_type(CodeGenContext* ctx, ASTNode* lambda, int index, Type* fallback);
+static void enter_lambda_scope(CodeGenContext* ctx, ASTNode* lambda, Type** param_types, int count);
+static Type* analyze_lambda_body(CodeGenContext* ctx, ASTNode* lambda, Type** param_types, int count);
+static char* cast_value_if_needed(CodeGenContext* ctx, char* value, Type* from_type, Type* to_type);
 
 // Helpers para DataFrame pipelines
 static bool extract_df_filter_info(ASTNode* lambda, char** column, int* op, double* threshold) {
@@ -300,13 +451,13 @@ static char* generate_literal(CodeGenContext* ctx, ASTNode* node) {
     char* result = gen_temp(ctx);
     switch (node->literal.literal_type) {
         case TOKEN_INTEGER: {
-            char* val = malloc(32);
+            char* val = arena_alloc(ctx->arena, 32);
             snprintf(val, 32, "%lld", node->literal.int_value);
             return val;
         }
         case TOKEN_FLOAT: {
-            char* val = malloc(64);
-            snprintf(val, 64, "%.15e", node->literal.float_value);
+            char* val = arena_alloc(ctx->arena, 64);
+            snprintf(val, 64, "%.16e", node->literal.float_value);
             return val;
         }
         case TOKEN_STRING: {
@@ -330,7 +481,7 @@ static char* generate_identifier(CodeGenContext* ctx, ASTNode* node) {
         Symbol* symbol = lookup_symbol(ctx->analyzer->symbol_table, node->identifier.id_name);
         Type* var_type = symbol ? symbol->type : create_primitive_type(TYPE_INT);
 
-        char* default_val = malloc(64);
+        char* default_val = arena_alloc(ctx->arena, 64);
         switch (var_type->kind) {
             case TYPE_FLOAT:
                 strcpy(default_val, "0.000000e+00");
@@ -346,8 +497,8 @@ static char* generate_identifier(CodeGenContext* ctx, ASTNode* node) {
                 break;
         }
 
-        fprintf(stderr, "Aviso: Variável '%s' não encontrada. Usando %s.\n",
-                node->identifier.id_name, default_val);
+        log_warn("Aviso: Variável '%s' não encontrada. Usando %s.\n",
+                 node->identifier.id_name, default_val);
         return default_val;
     }
 
@@ -423,6 +574,8 @@ static char* generate_binary_expr(CodeGenContext* ctx, ASTNode* node) {
                 emit(ctx, "str_merge_%d:\n", ctx->temp_counter);
                 emit(ctx, "  %s = phi i1 [%s, %%str_null_%d], [%s, %%str_cmp_%d]\n",
                      result, both_null, ctx->temp_counter, strcmp_eq, ctx->temp_counter);
+                snprintf(ctx->current_block, sizeof(ctx->current_block),
+                         "str_merge_%d", ctx->temp_counter);
                 ctx->temp_counter++;
             } else if (is_bool) {
                 emit(ctx, "  %s = icmp eq i1 %s, %s\n", result, left, right);
@@ -561,8 +714,8 @@ static char* generate_call_expr(CodeGenContext* ctx, ASTNode* node) {
         
         // Validação: número correto de argumentos
         if (node->call_expr.arg_count != dt->field_count) {
-            fprintf(stderr, "Erro: Construtor '%s' espera %d argumentos, mas recebeu %d\n",
-                    func_name, dt->field_count, node->call_expr.arg_count);
+            log_error("Erro: Construtor '%s' espera %d argumentos, mas recebeu %d\n",
+                      func_name, dt->field_count, node->call_expr.arg_count);
             return "null";
         }
         
@@ -604,7 +757,7 @@ static char* generate_call_expr(CodeGenContext* ctx, ASTNode* node) {
     Symbol* func_symbol = lookup_symbol(ctx->analyzer->symbol_table, func_name);
     
     if (!func_symbol) {
-        fprintf(stderr, "Erro: Função '%s' não declarada\n", func_name);
+        log_error("Erro: Função '%s' não declarada\n", func_name);
         return "null";
     }
     
@@ -631,14 +784,14 @@ static char* generate_call_expr(CodeGenContext* ctx, ASTNode* node) {
     }
     
     if (func_symbol->kind != SYMBOL_FUNCTION) {
-        fprintf(stderr, "Erro: '%s' não é uma função\n", func_name);
+        log_error("Erro: '%s' não é uma função\n", func_name);
         return "null";
     }
     
     // Verifica número de argumentos
     if (node->call_expr.arg_count != func_symbol->param_count) {
-        fprintf(stderr, "Erro: Função '%s' espera %d args mas recebeu %d\n",
-                func_name, func_symbol->param_count, node->call_expr.arg_count);
+        log_error("Erro: Função '%s' espera %d args mas recebeu %d\n",
+                  func_name, func_symbol->param_count, node->call_expr.arg_count);
     }
     
     // Gera argumentos
@@ -681,7 +834,7 @@ static char* generate_call_expr(CodeGenContext* ctx, ASTNode* node) {
                arg_types[0] && arg_types[0]->kind == TYPE_ARRAY &&
                arg_types[0]->element_type && arg_types[0]->element_type->kind == TYPE_FLOAT) {
         // Agregado em Float array (exceto count) - use versão _float
-        char* float_func = malloc(128);
+        char* float_func = arena_alloc(ctx->arena, 128);
         snprintf(float_func, 128, "%s_float", func_name);
         llvm_func_name = float_func;
         is_float_aggregate = true;
@@ -824,57 +977,17 @@ static char* generate_array_literal(CodeGenContext* ctx, ASTNode* node) {
         emit(ctx, "  store %s %s, %s* %s\n", internal_type, val, internal_type, elem_ptr);
     }
 
-    // Create the array structure with internal type (always i64* for data)
-    char* struct_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca {i64, %s*}\n", struct_ptr, internal_type);
-
-    char* size_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 0\n",
-         size_ptr, internal_type, internal_type, struct_ptr);
-    emit(ctx, "  store i64 %d, i64* %s\n", count, size_ptr);
-
-    char* data_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 1\n",
-         data_ptr, internal_type, internal_type, struct_ptr);
-    emit(ctx, "  store %s* %s, %s** %s\n", internal_type, typed_ptr, internal_type, data_ptr);
-
-    char* loaded_array = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, %s*}, {i64, %s*}* %s\n",
-         loaded_array, internal_type, internal_type, struct_ptr);
+    char count_str[32];
+    snprintf(count_str, sizeof(count_str), "%d", count);
 
-    // If it's a custom type array, reconstruct with correct pointer type
+    // Custom type arrays expose the data with the struct pointer type
     if (is_custom) {
-        // Extract size and data pointer from the i64* array
-        char* size_val = gen_temp(ctx);
-        emit(ctx, "  %s = extractvalue {i64, i64*} %s, 0\n", size_val, loaded_array);
-        char* data_val = gen_temp(ctx);
-        emit(ctx, "  %s = extractvalue {i64, i64*} %s, 1\n", data_val, loaded_array);
-
-        // Bitcast the data pointer from i64* to the correct struct pointer type
         char* bitcast_data = gen_temp(ctx);
-        emit(ctx, "  %s = bitcast i64* %s to %s*\n", bitcast_data, data_val, external_type);
-
-        // Reconstruct the array with the correct type
-        char* final_struct = gen_temp(ctx);
-        emit(ctx, "  %s = alloca {i64, %s*}\n", final_struct, external_type);
-
-        char* final_size_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 0\n",
-             final_size_ptr, external_type, external_type, final_struct);
-        emit(ctx, "  store i64 %s, i64* %s\n", size_val, final_size_ptr);
-
-        char* final_data_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 1\n",
-             final_data_ptr, external_type, external_type, final_struct);
-        emit(ctx, "  store %s* %s, %s** %s\n", external_type, bitcast_data, external_type, final_data_ptr);
-
-        char* final_val = gen_temp(ctx);
-        emit(ctx, "  %s = load {i64, %s*}, {i64, %s*}* %s\n",
-             final_val, external_type, external_type, final_struct);
-        return final_val;
+        emit(ctx, "  %s = bitcast i64* %s to %s*\n", bitcast_data, typed_ptr, external_type);
+        return emit_array_struct(ctx, external_type, count_str, bitcast_data);
     }
 
-    return loaded_array;
+    return emit_array_struct(ctx, internal_type, count_str, typed_ptr);
 }
 
 static char* generate_range_expr(CodeGenContext* ctx, ASTNode* node) {
@@ -897,54 +1010,30 @@ static char* generate_range_expr(CodeGenContext* ctx, ASTNode* node) {
     char* loop_body = gen_label(ctx);
     char* loop_end = gen_label(ctx);
     
-    char* idx_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", idx_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", idx_ptr);
-    
-    char* val_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", val_ptr);
-    emit(ctx, "  store i64 %s, i64* %s\n", start, val_ptr);
+    // Índice como phi; o valor é start + idx
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
+    char* idx_val = gen_temp(ctx);
+    char* next_idx = gen_temp(ctx);
     
     emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
-    
-    char* idx_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", idx_val, idx_ptr);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", idx_val, preheader, next_idx, loop_body);
     char* cmp = gen_temp(ctx);
     emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, idx_val, size_plus_one);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
     
-    emit(ctx, "\n%s:\n", loop_body);
+    emit_label(ctx, loop_body);
     char* current_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", current_val, val_ptr);
+    emit(ctx, "  %s = add i64 %s, %s\n", current_val, start, idx_val);
     char* elem_ptr = gen_temp(ctx);
     emit(ctx, "  %s = getelementptr i64, i64* %s, i64 %s\n", elem_ptr, typed_ptr, idx_val);
     emit(ctx, "  store i64 %s, i64* %s\n", current_val, elem_ptr);
-    
-    char* next_val = gen_temp(ctx);
-    emit(ctx, "  %s = add i64 %s, 1\n", next_val, current_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_val, val_ptr);
-    char* next_idx = gen_temp(ctx);
     emit(ctx, "  %s = add i64 %s, 1\n", next_idx, idx_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_idx, idx_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
     
-    emit(ctx, "\n%s:\n", loop_end);
-    
-    char* struct_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca {i64, i64*}\n", struct_ptr);
-    
-    char* size_field = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, i64*}, {i64, i64*}* %s, i32 0, i32 0\n", size_field, struct_ptr);
-    emit(ctx, "  store i64 %s, i64* %s\n", size_plus_one, size_field);
-    
-    char* data_field = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, i64*}, {i64, i64*}* %s, i32 0, i32 1\n", data_field, struct_ptr);
-    emit(ctx, "  store i64* %s, i64** %s\n", typed_ptr, data_field);
-    
-    char* final_val = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, i64*}, {i64, i64*}* %s\n", final_val, struct_ptr);
-    return final_val;
+    emit_label(ctx, loop_end);
+    return emit_array_struct(ctx, "i64", size_plus_one, typed_ptr);
 }
 
 static char* generate_index_expr(CodeGenContext* ctx, ASTNode* node) {
@@ -1012,23 +1101,7 @@ static char* normalize_array_to_i64(CodeGenContext* ctx, char* array_val, Type*
     emit(ctx, "  %s = bitcast %s* %s to i64*\n", bitcast_data, elem_llvm_type, data_val);
 
     // Reconstruct as {i64, i64*}
-    char* generic_struct = gen_temp(ctx);
-    emit(ctx, "  %s = alloca {i64, i64*}\n", generic_struct);
-
-    char* size_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, i64*}, {i64, i64*}* %s, i32 0, i32 0\n",
-         size_ptr, generic_struct);
-    emit(ctx, "  store i64 %s, i64* %s\n", size_val, size_ptr);
-
-    char* data_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, i64*}, {i64, i64*}* %s, i32 0, i32 1\n",
-         data_ptr, generic_struct);
-    emit(ctx, "  store i64* %s, i64** %s\n", bitcast_data, data_ptr);
-
-    char* result = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, i64*}, {i64, i64*}* %s\n", result, generic_struct);
-
-    return result;
+    return emit_array_struct(ctx, "i64", size_val, bitcast_data);
 }
 
 // Wrapper for backward compatibility
@@ -1060,25 +1133,60 @@ static char* generate_filter_transform(CodeGenContext* ctx, ASTNode* node, char*
     char* output_data = gen_temp(ctx);
     emit(ctx, "  %s = bitcast i8* %s to i64*\n", output_data, output_raw);
     
-    // Índices
-    char* i_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", i_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", i_ptr);
-    
-    char* out_idx_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", out_idx_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", out_idx_ptr);
+    // Parâmetro da lambda: um slot no bloco de entrada, reescrito a cada elemento
+    ASTNode* lambda = node->filter_transform.filter_predicate;
+    bool has_param = lambda && lambda->type == AST_LAMBDA_EXPR && lambda->lambda_expr.lambda_param_count > 0;
+    Type* param_type = NULL;
+    char* param_ptr = NULL;
     
-    emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
+    if (has_param) {
+        char* param_name = lambda->lambda_expr.lambda_params[0]->param.param_name;
+        
+        if (lambda->lambda_expr.lambda_params[0]->param.param_type) {
+            param_type = ast_type_to_type(ctx->analyzer, 
+                                        lambda->lambda_expr.lambda_params[0]->param.param_type);
+        }
+        
+        if (!is_symbol_in_current_scope(ctx->analyzer->symbol_table, param_name)) {
+            Symbol* ps = declare_symbol(ctx->analyzer->symbol_table, param_name, SYMBOL_PARAMETER, 
+                        param_type ? param_type : create_primitive_type(TYPE_INT), 0, 0);
+            if (ps) ps->initialized = true;
+        }
+        
+        if (param_type && param_type->kind == TYPE_CUSTOM) {
+            // Variável do parâmetro aponta para a struct
+            char slot_type[128];
+            snprintf(slot_type, sizeof(slot_type), "%%struct.%s*", param_type->custom_name);
+            param_ptr = emit_alloca(ctx, slot_type);
+        } else {
+            param_ptr = emit_alloca(ctx, "i64");
+        }
+        add_var_mapping(ctx, param_name, param_ptr);
+        
+        // Marca símbolo como inicializado
+        Symbol* param_sym = lookup_symbol(ctx->analyzer->symbol_table, param_name);
+        if (param_sym) param_sym->initialized = true;
+    }
     
+    // Índices de entrada e saída em phis; skip_elem é o latch, que junta a
+    // aresta do predicado falso com a do elemento adicionado
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
     char* i_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", i_val, i_ptr);
+    char* out_idx = gen_temp(ctx);
+    char* next_i = gen_temp(ctx);
+    char* next_out_idx = gen_temp(ctx);
+    char* latch_out_idx = gen_temp(ctx);
+    
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, skip_elem);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", out_idx, preheader, latch_out_idx, skip_elem);
     char* cmp = gen_temp(ctx);
     emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, input_size);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
     
-    emit(ctx, "\n%s:\n", loop_body);
+    emit_label(ctx, loop_body);
     
     // Carrega elemento atual
     char* elem_ptr = gen_temp(ctx);
@@ -1087,92 +1195,44 @@ static char* generate_filter_transform(CodeGenContext* ctx, ASTNode* node, char*
     emit(ctx, "  %s = load i64, i64* %s\n", elem_val, elem_ptr);
     
     // Aplica o predicado lambda
-    ASTNode* lambda = node->filter_transform.filter_predicate;
     char* pred_result = "true";
     
-    if (lambda && lambda->type == AST_LAMBDA_EXPR && lambda->lambda_expr.lambda_param_count > 0) {
-        char* param_name = lambda->lambda_expr.lambda_params[0]->param.param_name;
-        Type* param_type = NULL;
-        
-        if (lambda->lambda_expr.lambda_params[0]->param.param_type) {
-            param_type = ast_type_to_type(ctx->analyzer, 
-                                        lambda->lambda_expr.lambda_params[0]->param.param_type);
-        }
-        
-        if (!is_symbol_in_current_scope(ctx->analyzer->symbol_table, param_name)) {
-            Symbol* ps = declare_symbol(ctx->analyzer->symbol_table, param_name, SYMBOL_PARAMETER, 
-                        param_type ? param_type : create_primitive_type(TYPE_INT), 0, 0);
-            if (ps) ps->initialized = true;
-        }
-        
+    if (has_param) {
         if (param_type && param_type->kind == TYPE_CUSTOM) {
-            // Cria variável para o parâmetro apontando para a struct
-            char* param_ptr = gen_temp(ctx);
-            emit(ctx, "  %s = alloca %%struct.%s*\n", param_ptr, param_type->custom_name);
-            
             // elem_val já é o ponteiro para struct, converte de i64
             char* struct_ptr = gen_temp(ctx);
             emit(ctx, "  %s = inttoptr i64 %s to %%struct.%s*\n", 
                 struct_ptr, elem_val, param_type->custom_name);
             emit(ctx, "  store %%struct.%s* %s, %%struct.%s** %s\n",
                 param_type->custom_name, struct_ptr, param_type->custom_name, param_ptr);
-            
-            add_var_mapping(ctx, param_name, param_ptr);
         } else {
-            // Tipo primitivo - comportamento atual
-            char* param_ptr = gen_temp(ctx);
-            emit(ctx, "  %s = alloca i64\n", param_ptr);
             emit(ctx, "  store i64 %s, i64* %s\n", elem_val, param_ptr);
-            add_var_mapping(ctx, param_name, param_ptr);
         }
         
-        // Marca símbolo como inicializado
-        Symbol* param_sym = lookup_symbol(ctx->analyzer->symbol_table, param_name);
-        if (param_sym) param_sym->initialized = true;
-        
         pred_result = generate_expr(ctx, lambda->lambda_expr.lambda_body);
     }
     
+    char pred_block[64];
+    snprintf(pred_block, sizeof(pred_block), "%s", ctx->current_block);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", pred_result, add_elem, skip_elem);
     
-    emit(ctx, "\n%s:\n", add_elem);
-    char* out_idx = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", out_idx, out_idx_ptr);
+    emit_label(ctx, add_elem);
     char* out_elem_ptr = gen_temp(ctx);
     emit(ctx, "  %s = getelementptr i64, i64* %s, i64 %s\n", out_elem_ptr, output_data, out_idx);
     emit(ctx, "  store i64 %s, i64* %s\n", elem_val, out_elem_ptr);
-    char* next_out_idx = gen_temp(ctx);
     emit(ctx, "  %s = add i64 %s, 1\n", next_out_idx, out_idx);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_out_idx, out_idx_ptr);
     emit(ctx, "  br label %%%s\n", skip_elem);
     
-    emit(ctx, "\n%s:\n", skip_elem);
-    char* next_i = gen_temp(ctx);
+    emit_label(ctx, skip_elem);
+    emit(ctx, "  %s = phi i64 [%s, %%%s], [%s, %%%s]\n",
+         latch_out_idx, out_idx, pred_block, next_out_idx, add_elem);
     emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_i, i_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
     
-    emit(ctx, "\n%s:\n", loop_end);
-    
-    // Cria struct do resultado
-    char* final_out_idx = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", final_out_idx, out_idx_ptr);
-    
-    char* result_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca {i64, i64*}\n", result_ptr);
+    emit_label(ctx, loop_end);
     
-    char* size_field = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, i64*}, {i64, i64*}* %s, i32 0, i32 0\n", size_field, result_ptr);
-    emit(ctx, "  store i64 %s, i64* %s\n", final_out_idx, size_field);
-    
-    char* data_field = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, i64*}, {i64, i64*}* %s, i32 0, i32 1\n", data_field, result_ptr);
-    emit(ctx, "  store i64* %s, i64** %s\n", output_data, data_field);
-    
-    char* result = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, i64*}, {i64, i64*}* %s\n", result, result_ptr);
-    
-    return result;
+    // Cria struct do resultado: o phi do cabeçalho já é a contagem final
+    return emit_array_struct(ctx, "i64", out_idx, output_data);
 }
 
 static char* generate_map_transform(CodeGenContext* ctx, ASTNode* node, char* input_array) {
@@ -1208,16 +1268,7 @@ static char* generate_map_transform(CodeGenContext* ctx, ASTNode* node, char* in
         emit(ctx, "  %s = extractvalue {i64, i64*} %s, 1\n", data, input_array);
         char* cast_data = gen_temp(ctx);
         emit(ctx, "  %s = bitcast i64* %s to %s*\n", cast_data, data, elem_llvm_type);
-        char* tmp = gen_temp(ctx);
-        emit(ctx, "  %s = alloca %s\n", tmp, struct_type);
-        char* sz_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr %s, %s* %s, i32 0, i32 0\n", sz_ptr, struct_type, struct_type, tmp);
-        emit(ctx, "  store i64 %s, i64* %s\n", sz, sz_ptr);
-        char* data_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr %s, %s* %s, i32 0, i32 1\n", data_ptr, struct_type, struct_type, tmp);
-        emit(ctx, "  store %s* %s, %s** %s\n", elem_llvm_type, cast_data, elem_llvm_type, data_ptr);
-        typed_array = gen_temp(ctx);
-        emit(ctx, "  %s = load %s, %s* %s\n", typed_array, struct_type, struct_type, tmp);
+        typed_array = emit_array_struct(ctx, elem_llvm_type, sz, cast_data);
     }
 
     char* input_size = gen_temp(ctx);
@@ -1264,20 +1315,54 @@ static char* generate_map_transform(CodeGenContext* ctx, ASTNode* node, char* in
     char* output_data = gen_temp(ctx);
     emit(ctx, "  %s = bitcast i8* %s to %s*\n", output_data, output_raw, output_llvm_type);
     
-    char* i_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", i_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", i_ptr);
+    // Parâmetro da lambda: um slot no bloco de entrada, reescrito a cada elemento
+    bool has_param = lambda && lambda->type == AST_LAMBDA_EXPR && lambda->lambda_expr.lambda_param_count > 0;
+    Type* param_type = NULL;
+    char* param_ptr = NULL;
     
-    emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
+    if (has_param) {
+        char* param_name = lambda->lambda_expr.lambda_params[0]->param.param_name;
+        
+        if (lambda->lambda_expr.lambda_params[0]->param.param_type) {
+            param_type = ast_type_to_type(ctx->analyzer,
+                                         lambda->lambda_expr.lambda_params[0]->param.param_type);
+        }
+        
+        if (!is_symbol_in_current_scope(ctx->analyzer->symbol_table, param_name)) {
+            Symbol* ps = declare_symbol(ctx->analyzer->symbol_table, param_name, SYMBOL_PARAMETER, 
+                          param_type ? param_type : create_primitive_type(TYPE_INT), 0, 0);
+            if (ps) ps->initialized = true;
+        }
+        
+        if (param_type && param_type->kind == TYPE_CUSTOM) {
+            char slot_type[128];
+            snprintf(slot_type, sizeof(slot_type), "%%struct.%s*", param_type->custom_name);
+            param_ptr = emit_alloca(ctx, slot_type);
+        } else {
+            param_ptr = emit_alloca(ctx, elem_llvm_type);
+        }
+        add_var_mapping(ctx, param_name, param_ptr);
+        
+        Symbol* param_sym = lookup_symbol(ctx->analyzer->symbol_table, param_name);
+        if (param_sym) param_sym->initialized = true;
+    }
     
+    // Índice em phi; o corpo da lambda pode abrir blocos, então o laço
+    // volta ao cabeçalho por um latch próprio
+    char* loop_next = gen_label(ctx);
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
     char* i_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", i_val, i_ptr);
+    char* next_i = gen_temp(ctx);
+    
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, loop_next);
     char* cmp = gen_temp(ctx);
     emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, input_size);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
     
-    emit(ctx, "\n%s:\n", loop_body);
+    emit_label(ctx, loop_body);
     
     char* elem_ptr = gen_temp(ctx);
     emit(ctx, "  %s = getelementptr %s, %s* %s, i64 %s\n", elem_ptr, elem_llvm_type, elem_llvm_type, input_data, i_val);
@@ -1286,24 +1371,8 @@ static char* generate_map_transform(CodeGenContext* ctx, ASTNode* node, char* in
     
     char* mapped_val = elem_val;
     
-    if (lambda && lambda->type == AST_LAMBDA_EXPR && lambda->lambda_expr.lambda_param_count > 0) {
-        char* param_name = lambda->lambda_expr.lambda_params[0]->param.param_name;
-        Type* param_type = NULL;
-        
-        if (lambda->lambda_expr.lambda_params[0]->param.param_type) {
-            param_type = ast_type_to_type(ctx->analyzer,
-                                         lambda->lambda_expr.lambda_params[0]->param.param_type);
-        }
-        
-        if (!is_symbol_in_current_scope(ctx->analyzer->symbol_table, param_name)) {
-            Symbol* ps = declare_symbol(ctx->analyzer->symbol_table, param_name, SYMBOL_PARAMETER, 
-                          param_type ? param_type : create_primitive_type(TYPE_INT), 0, 0);
-            if (ps) ps->initialized = true;
-        }
-        
+    if (has_param) {
         if (param_type && param_type->kind == TYPE_CUSTOM) {
-            char* param_ptr = gen_temp(ctx);
-            emit(ctx, "  %s = alloca %%struct.%s*\n", param_ptr, param_type->custom_name);
             char* struct_ptr = elem_val;
             if (strcmp(elem_llvm_type, "i64") == 0) {
                 struct_ptr = gen_temp(ctx);
@@ -1316,18 +1385,10 @@ static char* generate_map_transform(CodeGenContext* ctx, ASTNode* node, char* in
             }
             emit(ctx, "  store %%struct.%s* %s, %%struct.%s** %s\n",
                  param_type->custom_name, struct_ptr, param_type->custom_name, param_ptr);
-            
-            add_var_mapping(ctx, param_name, param_ptr);
         } else {
-            char* param_ptr = gen_temp(ctx);
-            emit(ctx, "  %s = alloca %s\n", param_ptr, elem_llvm_type);
             emit(ctx, "  store %s %s, %s* %s\n", elem_llvm_type, elem_val, elem_llvm_type, param_ptr);
-            add_var_mapping(ctx, param_name, param_ptr);
         }
         
-        Symbol* param_sym = lookup_symbol(ctx->analyzer->symbol_table, param_name);
-        if (param_sym) param_sym->initialized = true;
-        
         mapped_val = generate_expr(ctx, lambda->lambda_expr.lambda_body);
     }
     
@@ -1336,125 +1397,112 @@ static char* generate_map_transform(CodeGenContext* ctx, ASTNode* node, char* in
          out_elem_ptr, output_llvm_type, output_llvm_type, output_data, i_val);
     emit(ctx, "  store %s %s, %s* %s\n", 
          output_llvm_type, mapped_val, output_llvm_type, out_elem_ptr);
+    emit(ctx, "  br label %%%s\n", loop_next);
     
-    char* next_i = gen_temp(ctx);
+    emit_label(ctx, loop_next);
     emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_i, i_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
     
-    emit(ctx, "\n%s:\n", loop_end);
-    
-    char* result_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca {i64, %s*}\n", result_ptr, output_llvm_type);
-    
-    char* size_field = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 0\n", 
-         size_field, output_llvm_type, output_llvm_type, result_ptr);
-    emit(ctx, "  store i64 %s, i64* %s\n", input_size, size_field);
-    
-    char* data_field = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 1\n", 
-         data_field, output_llvm_type, output_llvm_type, result_ptr);
-    emit(ctx, "  store %s* %s, %s** %s\n", 
-         output_llvm_type, output_data, output_llvm_type, data_field);
-    
-    char* result = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, %s*}, {i64, %s*}* %s\n", 
-         result, output_llvm_type, output_llvm_type, result_ptr);
+    emit_label(ctx, loop_end);
     
-    return result;
+    return emit_array_struct(ctx, output_llvm_type, input_size, output_data);
 }
 
+// reduce estágio a estágio (quando a fusão não se aplica). O redutor é
+// baixado como no laço fundido: acumulador e elemento vão para os slots dos
+// parâmetros da lambda e o corpo produz o novo acumulador, então o resultado
+// não depende de o pipeline ter sido fundido ou não.
 static char* generate_reduce_transform(CodeGenContext* ctx, ASTNode* node, char* input_array, Type* array_type) {
-    char* loop_cond = gen_label(ctx);
-    char* loop_body = gen_label(ctx);
-    char* loop_end = gen_label(ctx);
-    
-    Type* elem_type = (array_type && array_type->kind == TYPE_ARRAY) ? array_type->element_type : NULL;
-    const char* elem_llvm = "i64";
-    bool is_float = false;
-    if (elem_type && elem_type->kind == TYPE_FLOAT) {
-        elem_llvm = "double";
-        is_float = true;
+    ASTNode* lambda = node->reduce_transform.reducer;
+    if (!node->reduce_transform.initial_value || !is_lambda_with_params(lambda, 2)) {
+        log_error("Erro [linha %d]: reduce requer valor inicial e uma lambda |acc, valor|\n", node->line);
+        ctx->had_error = true;
+        return "0";
     }
 
-    char array_struct_type[64];
-    snprintf(array_struct_type, 64, "{i64, %s*}", elem_llvm);
-
-    // Converte {i64, i64*} genérico para {i64, T*} tipado apenas para tipos customizados
-    char* typed_array = input_array;
-    if (elem_type && elem_type->kind == TYPE_CUSTOM) {
-        char* sz = gen_temp(ctx);
-        char* data = gen_temp(ctx);
-        emit(ctx, "  %s = extractvalue {i64, i64*} %s, 0\n", sz, input_array);
-        emit(ctx, "  %s = extractvalue {i64, i64*} %s, 1\n", data, input_array);
-        char* cast_data = gen_temp(ctx);
-        emit(ctx, "  %s = bitcast i64* %s to %s*\n", cast_data, data, elem_llvm);
-        char* tmp = gen_temp(ctx);
-        emit(ctx, "  %s = alloca %s\n", tmp, array_struct_type);
-        char* sz_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr %s, %s* %s, i32 0, i32 0\n", sz_ptr, array_struct_type, array_struct_type, tmp);
-        emit(ctx, "  store i64 %s, i64* %s\n", sz, sz_ptr);
-        char* data_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr %s, %s* %s, i32 0, i32 1\n", data_ptr, array_struct_type, array_struct_type, tmp);
-        emit(ctx, "  store %s* %s, %s** %s\n", elem_llvm, cast_data, elem_llvm, data_ptr);
-        typed_array = gen_temp(ctx);
-        emit(ctx, "  %s = load %s, %s* %s\n", typed_array, array_struct_type, array_struct_type, tmp);
-    }
+    // Arrays de tipos customizados chegam normalizados para {i64, i64*}
+    Type* elem_type = (array_type && array_type->kind == TYPE_ARRAY) ? array_type->element_type : NULL;
+    if (!elem_type) elem_type = create_primitive_type(TYPE_INT);
+    bool is_custom = elem_type->kind == TYPE_CUSTOM;
+    const char* elem_llvm = is_custom ? "i64" : type_to_llvm(elem_type);
+
+    Type* init_type = analyze_expression(ctx->analyzer, node->reduce_transform.initial_value);
+    Type* acc_type = lambda_param_type(ctx, lambda, 0, init_type);
+    Type* val_type = lambda_param_type(ctx, lambda, 1, elem_type);
+    const char* acc_llvm = type_to_llvm(acc_type);
+    const char* val_llvm = type_to_llvm(val_type);
+    Type* params[2] = { acc_type, val_type };
+    Type* body_type = analyze_lambda_body(ctx, lambda, params, 2);
+    int saved_vars = ctx->var_map.count;
 
     char* input_size = gen_temp(ctx);
-    emit(ctx, "  %s = extractvalue %s %s, 0\n", input_size, array_struct_type, typed_array);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 0\n", input_size, elem_llvm, input_array);
     char* input_data = gen_temp(ctx);
-    emit(ctx, "  %s = extractvalue %s %s, 1\n", input_data, array_struct_type, typed_array);
-    
-    // Valor inicial
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 1\n", input_data, elem_llvm, input_array);
+
+    // Slots dos parâmetros da lambda, no bloco de entrada da função
+    char* acc_ptr = emit_alloca(ctx, acc_llvm);
+    char* val_ptr = emit_alloca(ctx, val_llvm);
+
     char* init_val = generate_expr(ctx, node->reduce_transform.initial_value);
-    
-    char* acc_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca %s\n", acc_ptr, elem_llvm);
-    emit(ctx, "  store %s %s, %s* %s\n", elem_llvm, init_val, elem_llvm, acc_ptr);
-    
-    char* i_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", i_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", i_ptr);
-    
-    emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
-    
+    init_val = cast_value_if_needed(ctx, init_val, init_type, acc_type);
+
+    // Índice e acumulador em phis; o corpo da lambda pode abrir blocos, então
+    // o laço volta ao cabeçalho por um latch próprio
+    char* loop_cond = gen_label(ctx);
+    char* loop_body = gen_label(ctx);
+    char* loop_next = gen_label(ctx);
+    char* loop_end = gen_label(ctx);
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
     char* i_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", i_val, i_ptr);
+    char* acc_val = gen_temp(ctx);
+    char* next_i = gen_temp(ctx);
+    char* latch_acc = gen_temp(ctx);
+
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, loop_next);
+    emit(ctx, "  %s = phi %s [%s, %%%s], [%s, %%%s]\n", acc_val, acc_llvm, init_val, preheader,
+         latch_acc, loop_next);
     char* cmp = gen_temp(ctx);
     emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, input_size);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
-    
-    emit(ctx, "\n%s:\n", loop_body);
-    
-    char* acc_val = gen_temp(ctx);
-    emit(ctx, "  %s = load %s, %s* %s\n", acc_val, elem_llvm, elem_llvm, acc_ptr);
-    
+
+    emit_label(ctx, loop_body);
     char* elem_ptr = gen_temp(ctx);
     emit(ctx, "  %s = getelementptr %s, %s* %s, i64 %s\n", elem_ptr, elem_llvm, elem_llvm, input_data, i_val);
     char* elem_val = gen_temp(ctx);
     emit(ctx, "  %s = load %s, %s* %s\n", elem_val, elem_llvm, elem_llvm, elem_ptr);
-    
-    // Operação padrão: acc + val (somatório)
-    char* new_acc = gen_temp(ctx);
-    if (is_float) emit(ctx, "  %s = fadd double %s, %s\n", new_acc, acc_val, elem_val);
-    else emit(ctx, "  %s = add i64 %s, %s\n", new_acc, acc_val, elem_val);
-    
-    emit(ctx, "  store %s %s, %s* %s\n", elem_llvm, new_acc, elem_llvm, acc_ptr);
-    
-    char* next_i = gen_temp(ctx);
+    if (is_custom) {
+        char* struct_ptr = gen_temp(ctx);
+        emit(ctx, "  %s = inttoptr i64 %s to %s\n", struct_ptr, elem_val, val_llvm);
+        elem_val = struct_ptr;
+    } else {
+        elem_val = cast_value_if_needed(ctx, elem_val, elem_type, val_type);
+    }
+
+    emit(ctx, "  store %s %s, %s* %s\n", acc_llvm, acc_val, acc_llvm, acc_ptr);
+    emit(ctx, "  store %s %s, %s* %s\n", val_llvm, elem_val, val_llvm, val_ptr);
+    enter_lambda_scope(ctx, lambda, params, 2);
+    add_var_mapping(ctx, lambda->lambda_expr.lambda_params[0]->param.param_name, acc_ptr);
+    add_var_mapping(ctx, lambda->lambda_expr.lambda_params[1]->param.param_name, val_ptr);
+    char* body_val = generate_expr(ctx, lambda->lambda_expr.lambda_body);
+    exit_scope(ctx->analyzer->symbol_table);
+    body_val = cast_value_if_needed(ctx, body_val, body_type, acc_type);
+    char body_end[64];
+    snprintf(body_end, sizeof(body_end), "%s", ctx->current_block);
+    emit(ctx, "  br label %%%s\n", loop_next);
+
+    emit_label(ctx, loop_next);
+    emit(ctx, "  %s = phi %s [%s, %%%s]\n", latch_acc, acc_llvm, body_val, body_end);
     emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_i, i_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
-    
-    emit(ctx, "\n%s:\n", loop_end);
-    
-    char* result = gen_temp(ctx);
-    emit(ctx, "  %s = load %s, %s* %s\n", result, elem_llvm, elem_llvm, acc_ptr);
-    
-    return result;
+
+    emit_label(ctx, loop_end);
+    truncate_var_mappings(ctx, saved_vars);
+
+    return acc_val;
 }
 
 static char* generate_select_transform(CodeGenContext* ctx, ASTNode* node, char* input_df) {
@@ -1507,6 +1555,36 @@ static char* generate_groupby_transform(CodeGenContext* ctx, ASTNode* node, char
     return result;
 }
 
+// groupby(chaves) |> agg(colunas) em uma única chamada de agregação por hash;
+// o código da agregação no runtime é o próprio AggregateType (0 sum .. 4 max)
+static char* generate_groupby_aggregate(CodeGenContext* ctx, ASTNode* groupby, AggregateType agg,
+                                        ASTNode** value_args, int value_count, char* input_df) {
+    int key_count = groupby->groupby_transform.group_column_count;
+    int total = key_count + value_count;
+    char** col_ptrs = malloc((total > 0 ? total : 1) * sizeof(char*));
+
+    emit(ctx, "  ; groupby aggregate with %d keys and %d values\n", key_count, value_count);
+    for (int i = 0; i < total; i++) {
+        const char* name = i < key_count ? groupby->groupby_transform.group_columns[i]
+                                         : value_args[i - key_count]->identifier.id_name;
+        char* col_str = register_string_literal(ctx, name);
+        int len = strlen(name);
+        col_ptrs[i] = gen_temp(ctx);
+        emit(ctx, "  %s = getelementptr [%d x i8], [%d x i8]* %s, i32 0, i32 0\n",
+             col_ptrs[i], len + 1, len + 1, col_str);
+    }
+    char* result = gen_temp(ctx);
+    emit(ctx, "  %s = call i8* (i8*, i32, i32, i32, ...) @datalang_groupby_agg(i8* %s, i32 %d, i32 %d, i32 %d",
+         result, input_df, (int)agg, key_count, value_count);
+    for (int i = 0; i < total; i++) {
+        emit(ctx, ", i8* %s", col_ptrs[i]);
+    }
+    emit(ctx, ")\n");
+    free(col_ptrs);
+
+    return result;
+}
+
 // ==================== SELECT / GROUPBY PARA ARRAYS ====================
 
 static char* generate_select_from_array(CodeGenContext* ctx, ASTNode* node, char* array_val, Type* array_type) {
@@ -1541,36 +1619,31 @@ static char* generate_select_from_array(CodeGenContext* ctx, ASTNode* node, char
     }
     emit(ctx, ")\n");
     
-    // Normaliza array para {i64, i64*}
-    char* arr_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca %s\n", arr_ptr, type_to_llvm(array_type));
-    emit(ctx, "  store %s %s, %s* %s\n", type_to_llvm(array_type), array_val, type_to_llvm(array_type), arr_ptr);
-    char* cast_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = bitcast %s* %s to {i64, i64*}*\n", cast_ptr, type_to_llvm(array_type), arr_ptr);
-    char* casted = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, i64*}, {i64, i64*}* %s\n", casted, cast_ptr);
-    
+    // Normaliza array para i64* (structs guardadas como ponteiros)
+    const char* elem_llvm = type_to_llvm(array_type->element_type);
     char* size = gen_temp(ctx);
-    emit(ctx, "  %s = extractvalue {i64, i64*} %s, 0\n", size, casted);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 0\n", size, elem_llvm, array_val);
+    char* typed_data = gen_temp(ctx);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 1\n", typed_data, elem_llvm, array_val);
     char* data_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = extractvalue {i64, i64*} %s, 1\n", data_ptr, casted);
+    emit(ctx, "  %s = bitcast %s* %s to i64*\n", data_ptr, elem_llvm, typed_data);
     
     // Loop
     char* loop_cond = gen_label(ctx);
     char* loop_body = gen_label(ctx);
     char* loop_end = gen_label(ctx);
-    char* i_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", i_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", i_ptr);
-    emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
     char* i_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", i_val, i_ptr);
+    char* next_i = gen_temp(ctx);
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, loop_body);
     char* cmp = gen_temp(ctx);
     emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, size);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
     
-    emit(ctx, "\n%s:\n", loop_body);
+    emit_label(ctx, loop_body);
     char* elem_ptr = gen_temp(ctx);
     emit(ctx, "  %s = getelementptr i64, i64* %s, i64 %s\n", elem_ptr, data_ptr, i_val);
     char* elem_raw = gen_temp(ctx);
@@ -1623,12 +1696,10 @@ static char* generate_select_from_array(CodeGenContext* ctx, ASTNode* node, char
     emit(ctx, ")\n");
     free(value_ptrs);
     
-    char* next_i = gen_temp(ctx);
     emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_i, i_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
     
-    emit(ctx, "\n%s:\n", loop_end);
+    emit_label(ctx, loop_end);
     free(col_ptrs);
     return df;
 }
@@ -1663,89 +1734,424 @@ static char* generate_dataframe_from_array(CodeGenContext* ctx, char* array_val,
     }
     emit(ctx, ")\n");
     
-    // Normaliza array para {i64, i64*}
-    char* arr_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca %s\n", arr_ptr, type_to_llvm(array_type));
-    emit(ctx, "  store %s %s, %s* %s\n", type_to_llvm(array_type), array_val, type_to_llvm(array_type), arr_ptr);
-    char* cast_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = bitcast %s* %s to {i64, i64*}*\n", cast_ptr, type_to_llvm(array_type), arr_ptr);
-    char* casted = gen_temp(ctx);
-    emit(ctx, "  %s = load {i64, i64*}, {i64, i64*}* %s\n", casted, cast_ptr);
-    
+    // Normaliza array para i64* (structs guardadas como ponteiros)
+    const char* elem_llvm = type_to_llvm(array_type->element_type);
     char* size = gen_temp(ctx);
-    emit(ctx, "  %s = extractvalue {i64, i64*} %s, 0\n", size, casted);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 0\n", size, elem_llvm, array_val);
+    char* typed_data = gen_temp(ctx);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 1\n", typed_data, elem_llvm, array_val);
     char* data_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = extractvalue {i64, i64*} %s, 1\n", data_ptr, casted);
+    emit(ctx, "  %s = bitcast %s* %s to i64*\n", data_ptr, elem_llvm, typed_data);
     
     // Loop sobre elementos
     char* loop_cond = gen_label(ctx);
     char* loop_body = gen_label(ctx);
     char* loop_end = gen_label(ctx);
-    char* i_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", i_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", i_ptr);
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
+    char* i_val = gen_temp(ctx);
+    char* next_i = gen_temp(ctx);
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, loop_body);
+    char* cmp = gen_temp(ctx);
+    emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, size);
+    emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
+    
+    emit_label(ctx, loop_body);
+    char* elem_ptr = gen_temp(ctx);
+    emit(ctx, "  %s = getelementptr i64, i64* %s, i64 %s\n", elem_ptr, data_ptr, i_val);
+    char* elem_raw = gen_temp(ctx);
+    emit(ctx, "  %s = load i64, i64* %s\n", elem_raw, elem_ptr);
+    char* elem_struct = gen_temp(ctx);
+    emit(ctx, "  %s = inttoptr i64 %s to %%struct.%s*\n", elem_struct, elem_raw, dt->name);
+    
+    // Extrai todos os campos
+    char** value_ptrs = malloc(dt->field_count * sizeof(char*));
+    for (int f = 0; f < dt->field_count; f++) {
+        char* field_ptr = gen_temp(ctx);
+        emit(ctx, "  %s = getelementptr %%struct.%s, %%struct.%s* %s, i32 0, i32 %d\n",
+             field_ptr, dt->name, dt->name, elem_struct, f);
+        
+        const char* ftype = dt->field_types[f];
+        if (strcmp(ftype, "i8*") == 0) {
+            value_ptrs[f] = gen_temp(ctx);
+            emit(ctx, "  %s = load i8*, i8** %s\n", value_ptrs[f], field_ptr);
+        } else if (strcmp(ftype, "double") == 0) {
+            char* fval = gen_temp(ctx);
+            emit(ctx, "  %s = load double, double* %s\n", fval, field_ptr);
+            value_ptrs[f] = gen_temp(ctx);
+            emit(ctx, "  %s = call i8* @datalang_format_float(double %s)\n", value_ptrs[f], fval);
+        } else if (strcmp(ftype, "i64") == 0) {
+            char* fval = gen_temp(ctx);
+            emit(ctx, "  %s = load i64, i64* %s\n", fval, field_ptr);
+            value_ptrs[f] = gen_temp(ctx);
+            emit(ctx, "  %s = call i8* @datalang_format_int(i64 %s)\n", value_ptrs[f], fval);
+        } else if (strcmp(ftype, "i1") == 0) {
+            char* fval = gen_temp(ctx);
+            emit(ctx, "  %s = load i1, i1* %s\n", fval, field_ptr);
+            value_ptrs[f] = gen_temp(ctx);
+            emit(ctx, "  %s = call i8* @datalang_format_bool(i1 %s)\n", value_ptrs[f], fval);
+        } else {
+            value_ptrs[f] = register_string_literal(ctx, "null");
+        }
+    }
+    
+    emit(ctx, "  call void (i8*, i32, ...) @datalang_df_add_row(i8* %s, i32 %d", df, dt->field_count);
+    for (int f = 0; f < dt->field_count; f++) {
+        emit(ctx, ", i8* %s", value_ptrs[f]);
+    }
+    emit(ctx, ")\n");
+    free(value_ptrs);
+    
+    emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    
+    emit_label(ctx, loop_end);
+    free(col_ptrs);
+    return df;
+}
+
+// Como generate_dataframe_from_array, mas com colunas tipadas: os campos
+// Int/Float/Bool entram direto do registro, sem formatar e reinterpretar texto.
+// Os códigos de tipo são o ColumnType do runtime (0 Int, 1 Float, 2 Bool, 3 String).
+static char* generate_typed_dataframe_from_array(CodeGenContext* ctx, char* array_val, Type* array_type, DataTypeInfo* dt) {
+    if (!dt || !array_type || array_type->kind != TYPE_ARRAY) return "null";
+
+    char** col_ptrs = malloc((dt->field_count > 0 ? dt->field_count : 1) * sizeof(char*));
+    int* col_types = malloc((dt->field_count > 0 ? dt->field_count : 1) * sizeof(int));
+    for (int i = 0; i < dt->field_count; i++) {
+        char* col_str = register_string_literal(ctx, dt->field_names[i]);
+        int len = strlen(dt->field_names[i]);
+        col_ptrs[i] = gen_temp(ctx);
+        emit(ctx, "  %s = getelementptr [%d x i8], [%d x i8]* %s, i32 0, i32 0\n",
+             col_ptrs[i], len + 1, len + 1, col_str);
+        const char* ftype = dt->field_types[i];
+        col_types[i] = strcmp(ftype, "i64") == 0 ? 0 :
+                       strcmp(ftype, "double") == 0 ? 1 :
+                       strcmp(ftype, "i1") == 0 ? 2 : 3;
+    }
+
+    char* df = gen_temp(ctx);
+    emit(ctx, "  %s = call i8* (i32, ...) @datalang_df_create_typed(i32 %d", df, dt->field_count);
+    for (int i = 0; i < dt->field_count; i++) {
+        emit(ctx, ", i8* %s, i32 %d", col_ptrs[i], col_types[i]);
+    }
+    emit(ctx, ")\n");
+
+    // Normaliza array para i64* (structs guardadas como ponteiros)
+    const char* elem_llvm = type_to_llvm(array_type->element_type);
+    char* size = gen_temp(ctx);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 0\n", size, elem_llvm, array_val);
+    char* typed_data = gen_temp(ctx);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 1\n", typed_data, elem_llvm, array_val);
+    char* data_ptr = gen_temp(ctx);
+    emit(ctx, "  %s = bitcast %s* %s to i64*\n", data_ptr, elem_llvm, typed_data);
+
+    char* loop_cond = gen_label(ctx);
+    char* loop_body = gen_label(ctx);
+    char* loop_end = gen_label(ctx);
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
+    char* i_val = gen_temp(ctx);
+    char* next_i = gen_temp(ctx);
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, loop_body);
+    char* cmp = gen_temp(ctx);
+    emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, size);
+    emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
+
+    emit_label(ctx, loop_body);
+    char* elem_ptr = gen_temp(ctx);
+    emit(ctx, "  %s = getelementptr i64, i64* %s, i64 %s\n", elem_ptr, data_ptr, i_val);
+    char* elem_raw = gen_temp(ctx);
+    emit(ctx, "  %s = load i64, i64* %s\n", elem_raw, elem_ptr);
+    char* elem_struct = gen_temp(ctx);
+    emit(ctx, "  %s = inttoptr i64 %s to %%struct.%s*\n", elem_struct, elem_raw, dt->name);
+
+    // Argumentos variádicos: Bool vai promovido para i32, como em C
+    char** value_args = malloc((dt->field_count > 0 ? dt->field_count : 1) * sizeof(char*));
+    for (int f = 0; f < dt->field_count; f++) {
+        char* field_ptr = gen_temp(ctx);
+        emit(ctx, "  %s = getelementptr %%struct.%s, %%struct.%s* %s, i32 0, i32 %d\n",
+             field_ptr, dt->name, dt->name, elem_struct, f);
+        const char* ftype = dt->field_types[f];
+        char* fval = gen_temp(ctx);
+        char buf[128];
+        if (col_types[f] == 2) {
+            emit(ctx, "  %s = load i1, i1* %s\n", fval, field_ptr);
+            char* wide = gen_temp(ctx);
+            emit(ctx, "  %s = zext i1 %s to i32\n", wide, fval);
+            snprintf(buf, sizeof(buf), "i32 %s", wide);
+        } else if (col_types[f] == 3 && strcmp(ftype, "i8*") != 0) {
+            snprintf(buf, sizeof(buf), "i8* null");
+        } else {
+            emit(ctx, "  %s = load %s, %s* %s\n", fval, ftype, ftype, field_ptr);
+            snprintf(buf, sizeof(buf), "%s %s", ftype, fval);
+        }
+        value_args[f] = arena_strdup(ctx->arena, buf);
+    }
+
+    emit(ctx, "  call void (i8*, i32, ...) @datalang_df_add_typed_row(i8* %s, i32 %d", df, dt->field_count);
+    for (int f = 0; f < dt->field_count; f++) {
+        emit(ctx, ", %s", value_args[f]);
+    }
+    emit(ctx, ")\n");
+    free(value_args);
+
+    emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
+    emit(ctx, "  br label %%%s\n", loop_cond);
+
+    emit_label(ctx, loop_end);
+    free(col_ptrs);
+    free(col_types);
+    return df;
+}
+
+// ==================== FUSÃO DE FILTER/MAP/REDUCE ====================
+
+#define FUSED_MAX_STAGES 64
+
+// Estágio de um laço fundido: tipo do elemento que entra e tipo produzido
+// (map: elemento de saída; reduce: acumulador)
+typedef struct {
+    ASTNode* stage;
+    Type* in_type;
+    Type* out_type;
+} FusedStage;
+
+static bool is_fusable_elem_type(Type* t) {
+    return t && (t->kind == TYPE_INT || t->kind == TYPE_FLOAT ||
+                 t->kind == TYPE_BOOL || t->kind == TYPE_STRING);
+}
+
+// Tipo do parâmetro da lambda: anotação explícita ou o tipo que chega no estágio
+static Type* lambda_param_type(CodeGenContext* ctx, ASTNode* lambda, int index, Type* fallback) {
+    ASTNode* param = lambda->lambda_expr.lambda_params[index];
+    if (param->param.param_type) return ast_type_to_type(ctx->analyzer, param->param.param_type);
+    return fallback;
+}
+
+// Declara os parâmetros da lambda num escopo novo (o chamador fecha o escopo);
+// o símbolo fica com uma cópia do tipo, liberada no exit_scope
+static void enter_lambda_scope(CodeGenContext* ctx, ASTNode* lambda, Type** param_types, int count) {
+    enter_scope(ctx->analyzer->symbol_table);
+    for (int p = 0; p < count; p++) {
+        Symbol* ps = declare_symbol(ctx->analyzer->symbol_table,
+                                    lambda->lambda_expr.lambda_params[p]->param.param_name,
+                                    SYMBOL_PARAMETER, clone_type(param_types[p]), 0, 0);
+        if (ps) ps->initialized = true;
+    }
+}
+
+static Type* analyze_lambda_body(CodeGenContext* ctx, ASTNode* lambda, Type** param_types, int count) {
+    enter_lambda_scope(ctx, lambda, param_types, count);
+    Type* body_type = analyze_expression(ctx->analyzer, lambda->lambda_expr.lambda_body);
+    exit_scope(ctx->analyzer->symbol_table);
+    return body_type;
+}
+
+static bool is_lambda_with_params(ASTNode* lambda, int count) {
+    return lambda && lambda->type == AST_LAMBDA_EXPR &&
+           lambda->lambda_expr.lambda_param_count == count && lambda->lambda_expr.lambda_body;
+}
+
+// Planeja a sequência máxima de filter/map (opcionalmente terminada por reduce)
+// a partir de `start` sobre um array de tipo primitivo. Retorna quantos
+// estágios podem virar um único laço (0 = usar a geração estágio a estágio).
+static int plan_fused_pipeline(CodeGenContext* ctx, ASTNode* node, int start, Type* input_type, FusedStage* plan) {
+    if (!input_type || input_type->kind != TYPE_ARRAY) return 0;
+    Type* elem = input_type->element_type;
+    if (!is_fusable_elem_type(elem)) return 0;
+
+    int count = 0;
+    for (int j = start; j < node->pipeline_expr.stage_count && count < FUSED_MAX_STAGES; j++) {
+        ASTNode* stage = node->pipeline_expr.stages[j];
+        if (stage->type == AST_FILTER_TRANSFORM || stage->type == AST_MAP_TRANSFORM) {
+            ASTNode* lambda = stage->type == AST_FILTER_TRANSFORM
+                ? stage->filter_transform.filter_predicate
+                : stage->map_transform.map_function;
+            if (!is_lambda_with_params(lambda, 1)) break;
+            Type* param_type = lambda_param_type(ctx, lambda, 0, elem);
+            if (!param_type || param_type->kind != elem->kind) break;
+            Type* body_type = analyze_lambda_body(ctx, lambda, &elem, 1);
+            if (stage->type == AST_FILTER_TRANSFORM) {
+                if (!body_type || body_type->kind != TYPE_BOOL) break;
+                plan[count++] = (FusedStage){stage, elem, elem};
+            } else {
+                if (!is_fusable_elem_type(body_type)) break;
+                plan[count++] = (FusedStage){stage, elem, body_type};
+                elem = body_type;
+            }
+        } else if (stage->type == AST_REDUCE_TRANSFORM) {
+            ASTNode* lambda = stage->reduce_transform.reducer;
+            if (!stage->reduce_transform.initial_value || !is_lambda_with_params(lambda, 2)) break;
+            Type* acc_type = analyze_expression(ctx->analyzer, stage->reduce_transform.initial_value);
+            if (!acc_type || (acc_type->kind != TYPE_INT && acc_type->kind != TYPE_FLOAT)) break;
+            Type* acc_param = lambda_param_type(ctx, lambda, 0, acc_type);
+            Type* val_param = lambda_param_type(ctx, lambda, 1, elem);
+            if (!acc_param || acc_param->kind != acc_type->kind ||
+                !val_param || val_param->kind != elem->kind) break;
+            Type* params[2] = { acc_type, elem };
+            Type* body_type = analyze_lambda_body(ctx, lambda, params, 2);
+            if (!body_type || body_type->kind != acc_type->kind) break;
+            plan[count++] = (FusedStage){stage, elem, acc_type};
+            break;  // reduce produz escalar: fim do laço fundido
+        } else {
+            break;
+        }
+    }
+    return count;
+}
+
+// Emite um único laço para os estágios planejados: cada elemento passa pelos
+// predicados e mapeamentos em registradores, sem arrays intermediários. Só o
+// resultado final é materializado (array de saída ou acumulador do reduce).
+static char* generate_fused_pipeline(CodeGenContext* ctx, char* input_array, Type* input_type,
+                                     FusedStage* plan, int count, Type** result_type) {
+    const char* in_llvm = type_to_llvm(input_type->element_type);
+    FusedStage* last = &plan[count - 1];
+    bool has_reduce = last->stage->type == AST_REDUCE_TRANSFORM;
+    Type* out_elem = has_reduce ? last->in_type : last->out_type;
+    const char* out_llvm = type_to_llvm(out_elem);
+    int saved_vars = ctx->var_map.count;
+
+    emit(ctx, "  ; fused pipeline with %d stages\n", count);
+    char* input_size = gen_temp(ctx);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 0\n", input_size, in_llvm, input_array);
+    char* input_data = gen_temp(ctx);
+    emit(ctx, "  %s = extractvalue {i64, %s*} %s, 1\n", input_data, in_llvm, input_array);
+
+    // Slots dos parâmetros das lambdas, no bloco de entrada da função
+    char* param_ptrs[FUSED_MAX_STAGES][2];
+    for (int k = 0; k < count; k++) {
+        Type* first = plan[k].stage->type == AST_REDUCE_TRANSFORM ? plan[k].out_type : plan[k].in_type;
+        param_ptrs[k][0] = emit_alloca(ctx, type_to_llvm(first));
+        param_ptrs[k][1] = NULL;
+        if (plan[k].stage->type == AST_REDUCE_TRANSFORM) {
+            param_ptrs[k][1] = emit_alloca(ctx, type_to_llvm(plan[k].in_type));
+        }
+    }
+
+    // Índice, posição de saída e acumulador ficam em phis. loop_next é o
+    // latch: recebe a aresta de cada filtro que rejeita o elemento (com os
+    // valores do cabeçalho) e a do fim do corpo (com os valores novos)
+    const char* acc_llvm = NULL;
+    char* init_val = NULL;
+    char* output_data = NULL;
+    if (has_reduce) {
+        acc_llvm = type_to_llvm(last->out_type);
+        init_val = generate_expr(ctx, last->stage->reduce_transform.initial_value);
+    } else {
+        char* output_bytes = gen_temp(ctx);
+        emit(ctx, "  %s = mul i64 %s, 8\n", output_bytes, input_size);
+        char* output_raw = gen_temp(ctx);
+        emit(ctx, "  %s = call i8* @malloc(i64 %s)\n", output_raw, output_bytes);
+        output_data = gen_temp(ctx);
+        emit(ctx, "  %s = bitcast i8* %s to %s*\n", output_data, output_raw, out_llvm);
+    }
+
+    char* loop_cond = gen_label(ctx);
+    char* loop_body = gen_label(ctx);
+    char* loop_next = gen_label(ctx);
+    char* loop_end = gen_label(ctx);
+
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
+    char* i_val = gen_temp(ctx);
+    char* next_i = gen_temp(ctx);
+    char* state_val = gen_temp(ctx);     // acumulador ou posição de saída
+    char* latch_state = gen_temp(ctx);
+    const char* state_llvm = has_reduce ? acc_llvm : "i64";
+
     emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
-    char* i_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", i_val, i_ptr);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, next_i, loop_next);
+    emit(ctx, "  %s = phi %s [%s, %%%s], [%s, %%%s]\n", state_val, state_llvm,
+         has_reduce ? init_val : "0", preheader, latch_state, loop_next);
     char* cmp = gen_temp(ctx);
-    emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, size);
+    emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, input_size);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
-    
-    emit(ctx, "\n%s:\n", loop_body);
+
+    emit_label(ctx, loop_body);
     char* elem_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = getelementptr i64, i64* %s, i64 %s\n", elem_ptr, data_ptr, i_val);
-    char* elem_raw = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", elem_raw, elem_ptr);
-    char* elem_struct = gen_temp(ctx);
-    emit(ctx, "  %s = inttoptr i64 %s to %%struct.%s*\n", elem_struct, elem_raw, dt->name);
-    
-    // Extrai todos os campos
-    char** value_ptrs = malloc(dt->field_count * sizeof(char*));
-    for (int f = 0; f < dt->field_count; f++) {
-        char* field_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr %%struct.%s, %%struct.%s* %s, i32 0, i32 %d\n",
-             field_ptr, dt->name, dt->name, elem_struct, f);
-        
-        const char* ftype = dt->field_types[f];
-        if (strcmp(ftype, "i8*") == 0) {
-            value_ptrs[f] = gen_temp(ctx);
-            emit(ctx, "  %s = load i8*, i8** %s\n", value_ptrs[f], field_ptr);
-        } else if (strcmp(ftype, "double") == 0) {
-            char* fval = gen_temp(ctx);
-            emit(ctx, "  %s = load double, double* %s\n", fval, field_ptr);
-            value_ptrs[f] = gen_temp(ctx);
-            emit(ctx, "  %s = call i8* @datalang_format_float(double %s)\n", value_ptrs[f], fval);
-        } else if (strcmp(ftype, "i64") == 0) {
-            char* fval = gen_temp(ctx);
-            emit(ctx, "  %s = load i64, i64* %s\n", fval, field_ptr);
-            value_ptrs[f] = gen_temp(ctx);
-            emit(ctx, "  %s = call i8* @datalang_format_int(i64 %s)\n", value_ptrs[f], fval);
-        } else if (strcmp(ftype, "i1") == 0) {
-            char* fval = gen_temp(ctx);
-            emit(ctx, "  %s = load i1, i1* %s\n", fval, field_ptr);
-            value_ptrs[f] = gen_temp(ctx);
-            emit(ctx, "  %s = call i8* @datalang_format_bool(i1 %s)\n", value_ptrs[f], fval);
+    emit(ctx, "  %s = getelementptr %s, %s* %s, i64 %s\n", elem_ptr, in_llvm, in_llvm, input_data, i_val);
+    char* value = gen_temp(ctx);
+    emit(ctx, "  %s = load %s, %s* %s\n", value, in_llvm, in_llvm, elem_ptr);
+
+    char reject_blocks[FUSED_MAX_STAGES][64];
+    int reject_count = 0;
+    char* new_state = NULL;
+
+    for (int k = 0; k < count; k++) {
+        ASTNode* stage = plan[k].stage;
+        const char* elem_llvm = type_to_llvm(plan[k].in_type);
+        if (stage->type == AST_REDUCE_TRANSFORM) {
+            ASTNode* lambda = stage->reduce_transform.reducer;
+            emit(ctx, "  store %s %s, %s* %s\n", acc_llvm, state_val, acc_llvm, param_ptrs[k][0]);
+            emit(ctx, "  store %s %s, %s* %s\n", elem_llvm, value, elem_llvm, param_ptrs[k][1]);
+            Type* params[2] = { plan[k].out_type, plan[k].in_type };
+            enter_lambda_scope(ctx, lambda, params, 2);
+            add_var_mapping(ctx, lambda->lambda_expr.lambda_params[0]->param.param_name, param_ptrs[k][0]);
+            add_var_mapping(ctx, lambda->lambda_expr.lambda_params[1]->param.param_name, param_ptrs[k][1]);
+            new_state = generate_expr(ctx, lambda->lambda_expr.lambda_body);
+            exit_scope(ctx->analyzer->symbol_table);
+            continue;
+        }
+
+        ASTNode* lambda = stage->type == AST_FILTER_TRANSFORM
+            ? stage->filter_transform.filter_predicate
+            : stage->map_transform.map_function;
+        emit(ctx, "  store %s %s, %s* %s\n", elem_llvm, value, elem_llvm, param_ptrs[k][0]);
+        enter_lambda_scope(ctx, lambda, &plan[k].in_type, 1);
+        add_var_mapping(ctx, lambda->lambda_expr.lambda_params[0]->param.param_name, param_ptrs[k][0]);
+        char* body_val = generate_expr(ctx, lambda->lambda_expr.lambda_body);
+        exit_scope(ctx->analyzer->symbol_table);
+
+        if (stage->type == AST_FILTER_TRANSFORM) {
+            char* keep = gen_label(ctx);
+            snprintf(reject_blocks[reject_count++], 64, "%s", ctx->current_block);
+            emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", body_val, keep, loop_next);
+            emit_label(ctx, keep);
         } else {
-            value_ptrs[f] = register_string_literal(ctx, "null");
+            value = body_val;
         }
     }
-    
-    emit(ctx, "  call void (i8*, i32, ...) @datalang_df_add_row(i8* %s, i32 %d", df, dt->field_count);
-    for (int f = 0; f < dt->field_count; f++) {
-        emit(ctx, ", i8* %s", value_ptrs[f]);
+
+    if (!has_reduce) {
+        char* out_elem_ptr = gen_temp(ctx);
+        emit(ctx, "  %s = getelementptr %s, %s* %s, i64 %s\n", out_elem_ptr, out_llvm, out_llvm, output_data, state_val);
+        emit(ctx, "  store %s %s, %s* %s\n", out_llvm, value, out_llvm, out_elem_ptr);
+        new_state = gen_temp(ctx);
+        emit(ctx, "  %s = add i64 %s, 1\n", new_state, state_val);
     }
-    emit(ctx, ")\n");
-    free(value_ptrs);
-    
-    char* next_i = gen_temp(ctx);
+    char body_end[64];
+    snprintf(body_end, sizeof(body_end), "%s", ctx->current_block);
+    emit(ctx, "  br label %%%s\n", loop_next);
+
+    emit_label(ctx, loop_next);
+    emit(ctx, "  %s = phi %s [%s, %%%s]", latch_state, state_llvm, new_state, body_end);
+    for (int r = 0; r < reject_count; r++) {
+        emit(ctx, ", [%s, %%%s]", state_val, reject_blocks[r]);
+    }
+    emit(ctx, "\n");
     emit(ctx, "  %s = add i64 %s, 1\n", next_i, i_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", next_i, i_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
-    
-    emit(ctx, "\n%s:\n", loop_end);
-    free(col_ptrs);
-    return df;
+
+    emit_label(ctx, loop_end);
+
+    // Parâmetros das lambdas saem de escopo junto com o laço
+    truncate_var_mappings(ctx, saved_vars);
+
+    // O phi do cabeçalho já tem o acumulador/contagem final
+    if (has_reduce) {
+        *result_type = last->out_type;
+        return state_val;
+    }
+
+    *result_type = create_array_type(out_elem);
+    return emit_array_struct(ctx, out_llvm, state_val, output_data);
 }
 
 static char* generate_pipeline_expr(CodeGenContext* ctx, ASTNode* node) {
@@ -1761,6 +2167,19 @@ static char* generate_pipeline_expr(CodeGenContext* ctx, ASTNode* node) {
         ASTNode* stage = node->pipeline_expr.stages[i];
         Type* stage_type = current_type;
 
+        // filter/map/reduce consecutivos sobre arrays primitivos: um único laço
+        if (stage->type == AST_FILTER_TRANSFORM || stage->type == AST_MAP_TRANSFORM ||
+            stage->type == AST_REDUCE_TRANSFORM) {
+            FusedStage plan[FUSED_MAX_STAGES];
+            int fused = plan_fused_pipeline(ctx, node, i, stage_type, plan);
+            if (fused > 0) {
+                current = generate_fused_pipeline(ctx, current, stage_type, plan, fused, &current_type);
+                current_is_generic_custom = false;
+                i += fused - 1;
+                continue;
+            }
+        }
+
         switch (stage->type) {
             case AST_FILTER_TRANSFORM: {
                 // Normalize custom type arrays to {i64, i64*} before filtering
@@ -1895,7 +2314,25 @@ static char* generate_pipeline_expr(CodeGenContext* ctx, ASTNode* node) {
                 break;
             }
             case AST_GROUPBY_TRANSFORM: {
-                if (stage_type && stage_type->kind == TYPE_ARRAY) {
+                AggregateType agg = AGG_SUM; ASTNode** agg_args = NULL; int agg_arg_count = 0;
+                bool grouped = i + 1 < node->pipeline_expr.stage_count &&
+                    extract_group_aggregate(node->pipeline_expr.stages[i + 1], &agg, &agg_args, &agg_arg_count);
+                DataTypeInfo* row_type = (stage_type && stage_type->kind == TYPE_ARRAY &&
+                                          stage_type->element_type &&
+                                          stage_type->element_type->kind == TYPE_CUSTOM)
+                    ? find_data_type(stage_type->element_type->custom_name) : NULL;
+                if (grouped && stage_type && stage_type->kind == TYPE_DATAFRAME) {
+                    // groupby seguido de agregação: funde os dois estágios
+                    current = generate_groupby_aggregate(ctx, stage, agg, agg_args, agg_arg_count, current);
+                    current_type = create_primitive_type(TYPE_DATAFRAME);
+                    i++;
+                } else if (grouped && row_type) {
+                    // Array de registros: vira DataFrame tipado com todos os campos e agrega igual
+                    char* df = generate_typed_dataframe_from_array(ctx, current, stage_type, row_type);
+                    current = generate_groupby_aggregate(ctx, stage, agg, agg_args, agg_arg_count, df);
+                    current_type = create_primitive_type(TYPE_DATAFRAME);
+                    i++;
+                } else if (stage_type && stage_type->kind == TYPE_ARRAY) {
                     current = generate_groupby_from_array(ctx, stage, current, stage_type);
                     current_type = create_primitive_type(TYPE_DATAFRAME);
                 } else {
@@ -1961,7 +2398,7 @@ static char* generate_pipeline_expr(CodeGenContext* ctx, ASTNode* node) {
 
                     if (is_float_array && strcmp(func_name, "count") != 0) {
                         // Use Float-specific aggregate functions (except count)
-                        char* float_func = malloc(128);
+                        char* float_func = arena_alloc(ctx->arena, 128);
                         snprintf(float_func, 128, "%s_float", func_name);
                         actual_func_name = float_func;
                         ret_type = "double";
@@ -2032,23 +2469,7 @@ static char* generate_pipeline_expr(CodeGenContext* ctx, ASTNode* node) {
         emit(ctx, "  %s = bitcast i64* %s to %s*\n", bitcast_data, data_val, elem_llvm_type);
 
         // Reconstruct as {i64, %struct.Foo**}
-        char* final_struct = gen_temp(ctx);
-        emit(ctx, "  %s = alloca {i64, %s*}\n", final_struct, elem_llvm_type);
-
-        char* final_size_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 0\n",
-             final_size_ptr, elem_llvm_type, elem_llvm_type, final_struct);
-        emit(ctx, "  store i64 %s, i64* %s\n", size_val, final_size_ptr);
-
-        char* final_data_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = getelementptr {i64, %s*}, {i64, %s*}* %s, i32 0, i32 1\n",
-             final_data_ptr, elem_llvm_type, elem_llvm_type, final_struct);
-        emit(ctx, "  store %s* %s, %s** %s\n", elem_llvm_type, bitcast_data, elem_llvm_type, final_data_ptr);
-
-        char* result = gen_temp(ctx);
-        emit(ctx, "  %s = load {i64, %s*}, {i64, %s*}* %s\n",
-             result, elem_llvm_type, elem_llvm_type, final_struct);
-        return result;
+        return emit_array_struct(ctx, elem_llvm_type, size_val, bitcast_data);
     }
 
     return current;
@@ -2088,14 +2509,14 @@ static char* generate_member_expr(CodeGenContext* ctx, ASTNode* node) {
     
     DataTypeInfo* dt = find_data_type(object_type->custom_name);
     if (!dt) {
-        fprintf(stderr, "Erro: Tipo '%s' não encontrado\n", object_type->custom_name);
+        log_error("Erro: Tipo '%s' não encontrado\n", object_type->custom_name);
         return "0";
     }
     
     int field_idx = get_field_index(dt, node->member_expr.member);
     if (field_idx < 0) {
-        fprintf(stderr, "Erro: Campo '%s' não encontrado no tipo '%s'\n", 
-                node->member_expr.member, object_type->custom_name);
+        log_error("Erro: Campo '%s' não encontrado no tipo '%s'\n", 
+                  node->member_expr.member, object_type->custom_name);
         return "0";
     }
     
@@ -2107,7 +2528,7 @@ static char* generate_member_expr(CodeGenContext* ctx, ASTNode* node) {
         const char* var_mapping = get_var_llvm_name(ctx, var_name);
 
         if (!var_mapping) {
-            fprintf(stderr, "Erro: Variável '%s' não encontrada\n", var_name);
+            log_error("Erro: Variável '%s' não encontrada\n", var_name);
             return "0";
         }
         
@@ -2234,7 +2655,9 @@ static char* generate_lambda_as_value(CodeGenContext* ctx, ASTNode* node) {
         Type* param_type = ast_type_to_type(ctx->analyzer, param->param.param_type);
         emit(ctx, "%s %%p%d", type_to_llvm(param_type), i);
     }
-    emit(ctx, ") {\nentry:\n");
+    emit(ctx, ") {\n");
+    FunctionBody body;
+    begin_function_body(ctx, &body);
     
     // Corpo da função
     enter_scope(ctx->analyzer->symbol_table);
@@ -2246,20 +2669,21 @@ static char* generate_lambda_as_value(CodeGenContext* ctx, ASTNode* node) {
         
         declare_symbol(ctx->analyzer->symbol_table, param_name, SYMBOL_PARAMETER, param_type, 0, 0);
         
-        char* param_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = alloca %s\n", param_ptr, type_to_llvm(param_type));
+        char* param_ptr = emit_alloca(ctx, type_to_llvm(param_type));
         emit(ctx, "  store %s %%p%d, %s* %s\n", 
              type_to_llvm(param_type), i, type_to_llvm(param_type), param_ptr);
         add_var_mapping(ctx, param_name, param_ptr);
     }
     
     char* result = generate_expr(ctx, node->lambda_expr.lambda_body);
-    emit(ctx, "  ret %s %s\n}\n", type_to_llvm(ret_type), result);
+    emit(ctx, "  ret %s %s\n", type_to_llvm(ret_type), result);
+    end_function_body(ctx, &body);
+    emit(ctx, "}\n");
     
     exit_scope(ctx->analyzer->symbol_table);
     
     // Retorna ponteiro para a função
-    char* func_ptr = malloc(128);
+    char* func_ptr = arena_alloc(ctx->arena, 128);
     snprintf(func_ptr, 128, "@%s", func_name);
     return func_ptr;
 }
@@ -2369,8 +2793,7 @@ static void generate_let_decl(CodeGenContext* ctx, ASTNode* node) {
         char* lambda_func = generate_lambda_as_value(ctx, node->let_decl.initializer);
         
         // Armazena ponteiro de função
-        char* var_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = alloca i8*\n", var_ptr);
+        char* var_ptr = emit_alloca(ctx, "i8*");
         
         // Converte ponteiro de função para i8*
         char* func_as_ptr = gen_temp(ctx);
@@ -2414,8 +2837,7 @@ static void generate_let_decl(CodeGenContext* ctx, ASTNode* node) {
     char type_str[256];
     strncpy(type_str, type_to_llvm(var_type), 255);
 
-    char* var_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca %s\n", var_ptr, type_str);
+    char* var_ptr = emit_alloca(ctx, type_str);
     add_var_mapping(ctx, node->let_decl.name, var_ptr);
 
     if (node->let_decl.initializer) {
@@ -2439,16 +2861,16 @@ static void generate_if_stmt(CodeGenContext* ctx, ASTNode* node) {
     char* merge_label = gen_label(ctx);
     
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cond, then_label, node->if_stmt.else_block ? else_label : merge_label);
-    emit(ctx, "\n%s:\n", then_label);
+    emit_label(ctx, then_label);
     generate_stmt(ctx, node->if_stmt.then_block);
     emit(ctx, "  br label %%%s\n", merge_label);
     
     if (node->if_stmt.else_block) {
-        emit(ctx, "\n%s:\n", else_label);
+        emit_label(ctx, else_label);
         generate_stmt(ctx, node->if_stmt.else_block);
         emit(ctx, "  br label %%%s\n", merge_label);
     }
-    emit(ctx, "\n%s:\n", merge_label);
+    emit_label(ctx, merge_label);
 }
 
 static void generate_for_stmt(CodeGenContext* ctx, ASTNode* node) {
@@ -2490,30 +2912,31 @@ static void generate_for_stmt(CodeGenContext* ctx, ASTNode* node) {
          "  %s = extractvalue {i64, %s*} %s, 1\n",
          data_ptr, elem_llvm_type, array_struct);
 
-    char* i_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca i64\n", i_ptr);
-    emit(ctx, "  store i64 0, i64* %s\n", i_ptr);
-
-    // Aloca variável do iterador com tipo correto
-    char* iter_ptr = gen_temp(ctx);
-    emit(ctx, "  %s = alloca %s\n", iter_ptr, elem_type_str);
+    // Aloca variável do iterador com tipo correto (bloco de entrada)
+    char* iter_ptr = emit_alloca(ctx, elem_type_str);
     add_var_mapping(ctx, node->for_stmt.iterator, iter_ptr);
 
     char* loop_cond = gen_label(ctx);
     char* loop_body = gen_label(ctx);
+    char* loop_next = gen_label(ctx);
     char* loop_end  = gen_label(ctx);
 
-    emit(ctx, "  br label %%%s\n", loop_cond);
-    emit(ctx, "\n%s:\n", loop_cond);
-
+    // Índice em phi; o corpo pode abrir blocos, então o laço volta ao
+    // cabeçalho por um latch próprio
+    char preheader[64];
+    snprintf(preheader, sizeof(preheader), "%s", ctx->current_block);
     char* i_val = gen_temp(ctx);
-    emit(ctx, "  %s = load i64, i64* %s\n", i_val, i_ptr);
+    char* i_next = gen_temp(ctx);
+
+    emit(ctx, "  br label %%%s\n", loop_cond);
+    emit_label(ctx, loop_cond);
+    emit(ctx, "  %s = phi i64 [0, %%%s], [%s, %%%s]\n", i_val, preheader, i_next, loop_next);
 
     char* cmp = gen_temp(ctx);
     emit(ctx, "  %s = icmp slt i64 %s, %s\n", cmp, i_val, size);
     emit(ctx, "  br i1 %s, label %%%s, label %%%s\n", cmp, loop_body, loop_end);
 
-    emit(ctx, "\n%s:\n", loop_body);
+    emit_label(ctx, loop_body);
 
     // Load element from array (using actual element type)
     char* elem_ptr = gen_temp(ctx);
@@ -2537,12 +2960,13 @@ static void generate_for_stmt(CodeGenContext* ctx, ASTNode* node) {
 
     generate_stmt(ctx, node->for_stmt.body);
 
-    char* i_next = gen_temp(ctx);
+    emit(ctx, "  br label %%%s\n", loop_next);
+
+    emit_label(ctx, loop_next);
     emit(ctx, "  %s = add i64 %s, 1\n", i_next, i_val);
-    emit(ctx, "  store i64 %s, i64* %s\n", i_next, i_ptr);
     emit(ctx, "  br label %%%s\n", loop_cond);
 
-    emit(ctx, "\n%s:\n", loop_end);
+    emit_label(ctx, loop_end);
 
     exit_scope(ctx->analyzer->symbol_table);
 }
@@ -2727,15 +3151,15 @@ static void generate_data_decl(CodeGenContext* ctx, ASTNode* node) {
         const char* llvm_type = type_to_llvm(field_type);
         emit(ctx, "%s", llvm_type);
         
-        field_names[i] = strdup(node->data_decl.fields[i]->field_decl.field_name);
-        field_types[i] = strdup(llvm_type);
+        field_names[i] = node->data_decl.fields[i]->field_decl.field_name;
+        field_types[i] = arena_strdup(ctx->arena, llvm_type);
     }
     emit(ctx, " }\n");
     
-    // Registra o tipo para uso posterior
+    // Registra o tipo para uso posterior (register_data_type faz cópias)
     register_data_type(node->data_decl.name, field_names, field_types, node->data_decl.field_count);
-    
-    // Não precisa liberar field_names e field_types aqui pois register_data_type faz cópias
+    free(field_names);
+    free(field_types);
 }
 
 static void generate_function(CodeGenContext* ctx, ASTNode* node) {
@@ -2772,7 +3196,9 @@ static void generate_function(CodeGenContext* ctx, ASTNode* node) {
         Type* param_type = ast_type_to_type(ctx->analyzer, param->param.param_type);
         emit(ctx, "%s %%p%d", type_to_llvm(param_type), i);
     }
-    emit(ctx, ") {\nentry:\n");
+    emit(ctx, ") {\n");
+    FunctionBody body;
+    begin_function_body(ctx, &body);
     
     for (int i = 0; i < node->fn_decl.param_count; i++) {
         ASTNode* param = node->fn_decl.params[i];
@@ -2784,8 +3210,7 @@ static void generate_function(CodeGenContext* ctx, ASTNode* node) {
         char param_type_str[64];
         strncpy(param_type_str, type_to_llvm(param_type), 63);
         
-        char* var_ptr = gen_temp(ctx);
-        emit(ctx, "  %s = alloca %s\n", var_ptr, param_type_str);
+        char* var_ptr = emit_alloca(ctx, param_type_str);
         emit(ctx, "  store %s %%p%d, %s* %s\n", param_type_str, i, param_type_str, var_ptr);
         add_var_mapping(ctx, param_name, var_ptr);
     }
@@ -2814,17 +3239,20 @@ static void generate_function(CodeGenContext* ctx, ASTNode* node) {
             emit(ctx, "  ret %s 0\n", ret_type_str);
         }
     }
+    end_function_body(ctx, &body);
     emit(ctx, "}\n");
     
     exit_scope(ctx->analyzer->symbol_table);
     ctx->analyzer->current_function_return_type = prev_ret_type;
     ctx->in_function = false;
-    ctx->var_map.count = saved_var_count; // drop local/param mappings
+    truncate_var_mappings(ctx, saved_var_count); // drop local/param mappings
 }
 
 static void generate_main_function(CodeGenContext* ctx, ASTNode* program) {
     int saved_var_count = ctx->var_map.count;
-    emit(ctx, "define i64 @user_main() {\nentry:\n");
+    emit(ctx, "define i64 @user_main() {\n");
+    FunctionBody body;
+    begin_function_body(ctx, &body);
 
     // Garante que variáveis globais com inicializadores complexos sejam avaliadas
     emit(ctx, "  call void @__init_globals()\n");
@@ -2839,8 +3267,23 @@ static void generate_main_function(CodeGenContext* ctx, ASTNode* program) {
         else if (decl->type == AST_EXPR_STMT) generate_stmt(ctx, decl);
     }
 
-    emit(ctx, "  ret i64 0\n}\n");
-    ctx->var_map.count = saved_var_count;
+    emit(ctx, "  ret i64 0\n");
+    end_function_body(ctx, &body);
+    emit(ctx, "}\n");
+    truncate_var_mappings(ctx, saved_var_count);
+}
+
+// Literal do mesmo tipo da global: vira o valor inicial do próprio global
+// e dispensa o store em __init_globals
+static bool is_static_global_initializer(ASTNode* init, Type* type) {
+    if (!init || init->type != AST_LITERAL || !type) return false;
+    switch (type->kind) {
+        case TYPE_INT: return init->literal.literal_type == TOKEN_INTEGER;
+        case TYPE_FLOAT: return init->literal.literal_type == TOKEN_FLOAT;
+        case TYPE_BOOL: return init->literal.literal_type == TOKEN_BOOL_TYPE;
+        case TYPE_STRING: return init->literal.literal_type == TOKEN_STRING;
+        default: return false;
+    }
 }
 
 // Gera uma função especial que avalia inicializadores de variáveis globais
@@ -2851,7 +3294,9 @@ static void generate_global_initializers_fn(CodeGenContext* ctx, ASTNode* progra
     ctx->current_function = "__init_globals";
 
     emit(ctx, "\n; Inicialização de variáveis globais\n");
-    emit(ctx, "define void @__init_globals() {\nentry:\n");
+    emit(ctx, "define void @__init_globals() {\n");
+    FunctionBody body;
+    begin_function_body(ctx, &body);
 
     for (int i = 0; i < program->program.decl_count; i++) {
         ASTNode* decl = program->program.declarations[i];
@@ -2872,17 +3317,187 @@ static void generate_global_initializers_fn(CodeGenContext* ctx, ASTNode* progra
         Type* var_type = decl->let_decl.type_annotation ?
             ast_type_to_type(ctx->analyzer, decl->let_decl.type_annotation) :
             analyze_expression(ctx->analyzer, decl->let_decl.initializer);
+        if (is_static_global_initializer(decl->let_decl.initializer, var_type)) continue;
         const char* llvm_type = type_to_llvm(var_type);
 
         char* init_val = generate_expr(ctx, decl->let_decl.initializer);
         emit(ctx, "  store %s %s, %s* %s\n", llvm_type, init_val, llvm_type, global_ptr);
     }
 
-    emit(ctx, "  ret void\n}\n");
-    ctx->var_map.count = saved_var_count;
+    emit(ctx, "  ret void\n");
+    end_function_body(ctx, &body);
+    emit(ctx, "}\n");
+    truncate_var_mappings(ctx, saved_var_count);
     ctx->in_function = prev_in_function;
 }
 
+// ==================== KERNELS DE AGREGAÇÃO ====================
+
+// Os agregados de array (sum/min/max e variantes Float) processam
+// AGG_ACCUMULATORS vetores <AGG_LANES x T> independentes por iteração:
+// as cadeias de dependência ficam curtas e o llc já recebe instruções
+// vetoriais, sem depender do vetorizador do opt. O resto (size % 16)
+// passa por um laço escalar.
+#define AGG_LANES 4
+#define AGG_ACCUMULATORS 4
+
+typedef enum {
+    AGG_KERNEL_SUM,
+    AGG_KERNEL_MIN,
+    AGG_KERNEL_MAX
+} AggKernelOp;
+
+// dst = a <op> b, com b sendo o valor novo (min/max preservam "a" no empate,
+// como no laço sequencial). type pode ser escalar ou vetor.
+static void emit_agg_combine(CodeGenContext* ctx, AggKernelOp op, bool is_float,
+                             const char* fadd_flags, const char* type,
+                             const char* dst, const char* a, const char* b) {
+    if (op == AGG_KERNEL_SUM) {
+        emit(ctx, "  %s = %s%s %s %s, %s\n", dst, is_float ? "fadd" : "add",
+             is_float ? fadd_flags : "", type, a, b);
+        return;
+    }
+
+    const char* pred;
+    if (op == AGG_KERNEL_MIN) pred = is_float ? "olt" : "slt";
+    else pred = is_float ? "ogt" : "sgt";
+
+    char cond_type[32];
+    if (type[0] == '<') snprintf(cond_type, sizeof(cond_type), "<%d x i1>", AGG_LANES);
+    else snprintf(cond_type, sizeof(cond_type), "i1");
+
+    emit(ctx, "  %s.cmp = %s %s %s %s, %s\n", dst, is_float ? "fcmp" : "icmp", pred, type, b, a);
+    emit(ctx, "  %s = select %s %s.cmp, %s %s, %s %s\n", dst, cond_type, dst, type, b, type, a);
+}
+
+// Emite @name({i64, T*}) -> T. Sem vetorização, o corpo é o laço escalar
+// sequencial (soma Float estrita, sem reassociação).
+static void emit_agg_kernel(CodeGenContext* ctx, const char* name, const char* elem,
+                            AggKernelOp op, bool vectorize) {
+    bool is_float = strcmp(elem, "double") == 0;
+    const char* zero = is_float ? "0.0" : "0";
+    const char* fadd_flags = (is_float && ctx->fast_math) ? " reassoc nsz" : "";
+    int block = AGG_LANES * AGG_ACCUMULATORS;
+
+    char vec[32];
+    snprintf(vec, sizeof(vec), "<%d x %s>", AGG_LANES, elem);
+
+    emit(ctx, "define %s @%s({i64, %s*} %%array) {\n", elem, name, elem);
+    emit(ctx, "entry:\n");
+    emit(ctx, "  %%size = extractvalue {i64, %s*} %%array, 0\n", elem);
+    emit(ctx, "  %%data = extractvalue {i64, %s*} %%array, 1\n", elem);
+    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
+    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%init\n");
+    emit(ctx, "return_zero:\n");
+    emit(ctx, "  ret %s %s\n", elem, zero);
+    emit(ctx, "init:\n");
+
+    // Valor inicial: 0 para soma, primeiro elemento para min/max
+    const char* init_scalar = zero;
+    const char* init_vec = "zeroinitializer";
+    if (op != AGG_KERNEL_SUM) {
+        emit(ctx, "  %%first_val = load %s, %s* %%data\n", elem, elem);
+        init_scalar = "%first_val";
+        if (vectorize) {
+            emit(ctx, "  %%first_ins = insertelement %s undef, %s %%first_val, i32 0\n", vec, elem);
+            emit(ctx, "  %%first_vec = shufflevector %s %%first_ins, %s undef, <%d x i32> zeroinitializer\n",
+                 vec, vec, AGG_LANES);
+            init_vec = "%first_vec";
+        }
+    }
+
+    const char* tail_pred = "init";
+    const char* tail_start = "0";
+    const char* tail_init = init_scalar;
+
+    if (vectorize) {
+        emit(ctx, "  %%vec_end = and i64 %%size, -%d\n", block);
+        emit(ctx, "  br label %%vec_cond\n");
+
+        emit(ctx, "vec_cond:\n");
+        emit(ctx, "  %%i = phi i64 [0, %%init], [%%i_next, %%vec_body]\n");
+        for (int k = 0; k < AGG_ACCUMULATORS; k++) {
+            emit(ctx, "  %%acc%d = phi %s [%s, %%init], [%%acc%d_next, %%vec_body]\n",
+                 k, vec, init_vec, k);
+        }
+        emit(ctx, "  %%vec_more = icmp slt i64 %%i, %%vec_end\n");
+        emit(ctx, "  br i1 %%vec_more, label %%vec_body, label %%vec_reduce\n");
+
+        emit(ctx, "vec_body:\n");
+        for (int k = 0; k < AGG_ACCUMULATORS; k++) {
+            emit(ctx, "  %%off%d = add i64 %%i, %d\n", k, k * AGG_LANES);
+            emit(ctx, "  %%ptr%d = getelementptr %s, %s* %%data, i64 %%off%d\n", k, elem, elem, k);
+            emit(ctx, "  %%vptr%d = bitcast %s* %%ptr%d to %s*\n", k, elem, k, vec);
+            emit(ctx, "  %%v%d = load %s, %s* %%vptr%d, align 8\n", k, vec, vec, k);
+            char dst[16], a[16], b[16];
+            snprintf(dst, sizeof(dst), "%%acc%d_next", k);
+            snprintf(a, sizeof(a), "%%acc%d", k);
+            snprintf(b, sizeof(b), "%%v%d", k);
+            emit_agg_combine(ctx, op, is_float, fadd_flags, vec, dst, a, b);
+        }
+        emit(ctx, "  %%i_next = add i64 %%i, %d\n", block);
+        emit(ctx, "  br label %%vec_cond\n");
+
+        // Redução em árvore: acumuladores, depois lanes (ordem fixa)
+        emit(ctx, "vec_reduce:\n");
+        emit_agg_combine(ctx, op, is_float, fadd_flags, vec, "%acc01", "%acc0", "%acc1");
+        emit_agg_combine(ctx, op, is_float, fadd_flags, vec, "%acc23", "%acc2", "%acc3");
+        emit_agg_combine(ctx, op, is_float, fadd_flags, vec, "%accv", "%acc01", "%acc23");
+        for (int l = 0; l < AGG_LANES; l++) {
+            emit(ctx, "  %%lane%d = extractelement %s %%accv, i32 %d\n", l, vec, l);
+        }
+        emit_agg_combine(ctx, op, is_float, fadd_flags, elem, "%lane01", "%lane0", "%lane1");
+        emit_agg_combine(ctx, op, is_float, fadd_flags, elem, "%lane23", "%lane2", "%lane3");
+        emit_agg_combine(ctx, op, is_float, fadd_flags, elem, "%vec_total", "%lane01", "%lane23");
+
+        tail_pred = "vec_reduce";
+        tail_start = "%vec_end";
+        tail_init = "%vec_total";
+    }
+    emit(ctx, "  br label %%tail_cond\n");
+
+    emit(ctx, "tail_cond:\n");
+    emit(ctx, "  %%j = phi i64 [%s, %%%s], [%%j_next, %%tail_body]\n", tail_start, tail_pred);
+    emit(ctx, "  %%acc = phi %s [%s, %%%s], [%%acc_next, %%tail_body]\n", elem, tail_init, tail_pred);
+    emit(ctx, "  %%tail_more = icmp slt i64 %%j, %%size\n");
+    emit(ctx, "  br i1 %%tail_more, label %%tail_body, label %%done\n");
+    emit(ctx, "tail_body:\n");
+    emit(ctx, "  %%ptr = getelementptr %s, %s* %%data, i64 %%j\n", elem, elem);
+    emit(ctx, "  %%val = load %s, %s* %%ptr\n", elem, elem);
+    emit_agg_combine(ctx, op, is_float, fadd_flags, elem, "%acc_next", "%acc", "%val");
+    emit(ctx, "  %%j_next = add i64 %%j, 1\n");
+    emit(ctx, "  br label %%tail_cond\n");
+    emit(ctx, "done:\n");
+    emit(ctx, "  ret %s %%acc\n", elem);
+    emit(ctx, "}\n\n");
+}
+
+// mean = soma / size, reaproveitando o kernel de soma
+static void emit_mean_kernel(CodeGenContext* ctx, const char* name, const char* elem,
+                             const char* sum_fn) {
+    bool is_float = strcmp(elem, "double") == 0;
+
+    emit(ctx, "define double @%s({i64, %s*} %%array) {\n", name, elem);
+    emit(ctx, "entry:\n");
+    emit(ctx, "  %%size = extractvalue {i64, %s*} %%array, 0\n", elem);
+    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
+    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%compute\n");
+    emit(ctx, "return_zero:\n");
+    emit(ctx, "  ret double 0.0\n");
+    emit(ctx, "compute:\n");
+    emit(ctx, "  %%sum = call %s @%s({i64, %s*} %%array)\n", elem, sum_fn, elem);
+    if (is_float) {
+        emit(ctx, "  %%size_f = sitofp i64 %%size to double\n");
+        emit(ctx, "  %%result = fdiv double %%sum, %%size_f\n");
+    } else {
+        emit(ctx, "  %%sum_f = sitofp i64 %%sum to double\n");
+        emit(ctx, "  %%size_f = sitofp i64 %%size to double\n");
+        emit(ctx, "  %%result = fdiv double %%sum_f, %%size_f\n");
+    }
+    emit(ctx, "  ret double %%result\n");
+    emit(ctx, "}\n\n");
+}
+
 void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "; ==================== RUNTIME FUNCTIONS ====================\n\n");
     emit(ctx, "declare i32 @printf(i8*, ...)\n");
@@ -2912,6 +3527,7 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "; DataFrame operations\n");
     emit(ctx, "declare i8* @datalang_select(i8*, i32, ...)\n");
     emit(ctx, "declare i8* @datalang_groupby(i8*, i32, ...)\n");
+    emit(ctx, "declare i8* @datalang_groupby_agg(i8*, i32, i32, i32, ...)\n");
     emit(ctx, "declare i64 @datalang_df_count(i8*)\n");
     emit(ctx, "declare i8* @datalang_df_filter_numeric(i8*, i8*, i32, double)\n");
     emit(ctx, "declare i8* @datalang_df_filter_string(i8*, i8*, i8*, i32)\n");
@@ -2921,6 +3537,8 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "declare void @datalang_print_dataframe(i8*)\n");
     emit(ctx, "declare i8* @datalang_df_create(i32, ...)\n");
     emit(ctx, "declare void @datalang_df_add_row(i8*, i32, ...)\n");
+    emit(ctx, "declare i8* @datalang_df_create_typed(i32, ...)\n");
+    emit(ctx, "declare void @datalang_df_add_typed_row(i8*, i32, ...)\n");
     emit(ctx, "declare i8* @datalang_format_int(i64)\n");
     emit(ctx, "declare i8* @datalang_format_float(double)\n");
     emit(ctx, "declare i8* @datalang_format_bool(i1)\n");
@@ -3001,11 +3619,9 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%data = extractvalue {i64, i64*} %%array, 1\n");
     emit(ctx, "  %%fmt_lb = getelementptr [2 x i8], [2 x i8]* @.fmt.lbracket, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_lb)\n");
-    emit(ctx, "  %%i = alloca i64\n");
-    emit(ctx, "  store i64 0, i64* %%i\n");
     emit(ctx, "  br label %%loop_cond\n");
     emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i_val = load i64, i64* %%i\n");
+    emit(ctx, "  %%i_val = phi i64 [0, %%entry], [%%i_next, %%loop_body], [%%i_next, %%print_sep]\n");
     emit(ctx, "  %%cmp = icmp slt i64 %%i_val, %%size\n");
     emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
     emit(ctx, "loop_body:\n");
@@ -3014,7 +3630,6 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%fmt_elem = getelementptr [5 x i8], [5 x i8]* @.fmt.int_no_nl, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_elem, i64 %%val)\n");
     emit(ctx, "  %%i_next = add i64 %%i_val, 1\n");
-    emit(ctx, "  store i64 %%i_next, i64* %%i\n");
     emit(ctx, "  %%has_next = icmp slt i64 %%i_next, %%size\n");
     emit(ctx, "  br i1 %%has_next, label %%print_sep, label %%loop_cond\n");
     emit(ctx, "print_sep:\n");
@@ -3033,11 +3648,9 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%data = extractvalue {i64, double*} %%array, 1\n");
     emit(ctx, "  %%fmt_lb = getelementptr [2 x i8], [2 x i8]* @.fmt.lbracket, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_lb)\n");
-    emit(ctx, "  %%i = alloca i64\n");
-    emit(ctx, "  store i64 0, i64* %%i\n");
     emit(ctx, "  br label %%loop_cond\n");
     emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i_val = load i64, i64* %%i\n");
+    emit(ctx, "  %%i_val = phi i64 [0, %%entry], [%%i_next, %%loop_body], [%%i_next, %%print_sep]\n");
     emit(ctx, "  %%cmp = icmp slt i64 %%i_val, %%size\n");
     emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
     emit(ctx, "loop_body:\n");
@@ -3046,7 +3659,6 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%fmt_elem = getelementptr [6 x i8], [6 x i8]* @.fmt.float_no_nl, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_elem, double %%val)\n");
     emit(ctx, "  %%i_next = add i64 %%i_val, 1\n");
-    emit(ctx, "  store i64 %%i_next, i64* %%i\n");
     emit(ctx, "  %%has_next = icmp slt i64 %%i_next, %%size\n");
     emit(ctx, "  br i1 %%has_next, label %%print_sep, label %%loop_cond\n");
     emit(ctx, "print_sep:\n");
@@ -3065,11 +3677,9 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%data = extractvalue {i64, i1*} %%array, 1\n");
     emit(ctx, "  %%fmt_lb = getelementptr [2 x i8], [2 x i8]* @.fmt.lbracket, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_lb)\n");
-    emit(ctx, "  %%i = alloca i64\n");
-    emit(ctx, "  store i64 0, i64* %%i\n");
     emit(ctx, "  br label %%loop_cond\n");
     emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i_val = load i64, i64* %%i\n");
+    emit(ctx, "  %%i_val = phi i64 [0, %%entry], [%%i_next, %%after_print], [%%i_next, %%print_sep]\n");
     emit(ctx, "  %%cmp = icmp slt i64 %%i_val, %%size\n");
     emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
     emit(ctx, "loop_body:\n");
@@ -3085,9 +3695,7 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_f)\n");
     emit(ctx, "  br label %%after_print\n");
     emit(ctx, "after_print:\n");
-    emit(ctx, "  %%i_val2 = load i64, i64* %%i\n");
-    emit(ctx, "  %%i_next = add i64 %%i_val2, 1\n");
-    emit(ctx, "  store i64 %%i_next, i64* %%i\n");
+    emit(ctx, "  %%i_next = add i64 %%i_val, 1\n");
     emit(ctx, "  %%has_next = icmp slt i64 %%i_next, %%size\n");
     emit(ctx, "  br i1 %%has_next, label %%print_sep, label %%loop_cond\n");
     emit(ctx, "print_sep:\n");
@@ -3106,11 +3714,9 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%data = extractvalue {i64, i8**} %%array, 1\n");
     emit(ctx, "  %%fmt_lb = getelementptr [2 x i8], [2 x i8]* @.fmt.lbracket, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_lb)\n");
-    emit(ctx, "  %%i = alloca i64\n");
-    emit(ctx, "  store i64 0, i64* %%i\n");
     emit(ctx, "  br label %%loop_cond\n");
     emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i_val = load i64, i64* %%i\n");
+    emit(ctx, "  %%i_val = phi i64 [0, %%entry], [%%i_next, %%loop_body], [%%i_next, %%print_sep]\n");
     emit(ctx, "  %%cmp = icmp slt i64 %%i_val, %%size\n");
     emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
     emit(ctx, "loop_body:\n");
@@ -3119,7 +3725,6 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "  %%fmt_elem = getelementptr [3 x i8], [3 x i8]* @.fmt.str_no_nl, i32 0, i32 0\n");
     emit(ctx, "  call i32 (i8*, ...) @printf(i8* %%fmt_elem, i8* %%val)\n");
     emit(ctx, "  %%i_next = add i64 %%i_val, 1\n");
-    emit(ctx, "  store i64 %%i_next, i64* %%i\n");
     emit(ctx, "  %%has_next = icmp slt i64 %%i_next, %%size\n");
     emit(ctx, "  br i1 %%has_next, label %%print_sep, label %%loop_cond\n");
     emit(ctx, "print_sep:\n");
@@ -3133,236 +3738,46 @@ void emit_runtime_functions(CodeGenContext* ctx) {
     emit(ctx, "}\n\n");
     
     // Aggregate functions
+    // Soma Int é associativa (wraparound) e min/max não dependem da ordem:
+    // sempre vetorizados. A soma Float só é reassociada com --fast-math.
     emit(ctx, "; sum: sums all elements in an integer array\n");
-    emit(ctx, "define i64 @sum({i64, i64*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, i64*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, i64*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%loop_cond\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret i64 0\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [0, %%entry], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%acc = phi i64 [0, %%entry], [%%acc_next, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr i64, i64* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load i64, i64* %%ptr\n");
-    emit(ctx, "  %%acc_next = add i64 %%acc, %%val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  ret i64 %%acc\n");
-    emit(ctx, "}\n\n");
-    
+    emit_agg_kernel(ctx, "sum", "i64", AGG_KERNEL_SUM, true);
+
     emit(ctx, "; mean: calculates the average of an integer array, returns double\n");
-    emit(ctx, "define double @mean({i64, i64*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, i64*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, i64*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%loop_cond\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret double 0.0\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [0, %%entry], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%acc = phi i64 [0, %%entry], [%%acc_next, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr i64, i64* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load i64, i64* %%ptr\n");
-    emit(ctx, "  %%acc_next = add i64 %%acc, %%val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  %%sum_f = sitofp i64 %%acc to double\n");
-    emit(ctx, "  %%size_f = sitofp i64 %%size to double\n");
-    emit(ctx, "  %%result = fdiv double %%sum_f, %%size_f\n");
-    emit(ctx, "  ret double %%result\n");
-    emit(ctx, "}\n\n");
-    
+    emit_mean_kernel(ctx, "mean", "i64", "sum");
+
     emit(ctx, "; count: returns the number of elements in an array\n");
     emit(ctx, "define i64 @count({i64, i64*} %%array) {\n");
     emit(ctx, "  %%size = extractvalue {i64, i64*} %%array, 0\n");
     emit(ctx, "  ret i64 %%size\n");
     emit(ctx, "}\n\n");
-    
+
     emit(ctx, "; min: finds the minimum element in an integer array\n");
-    emit(ctx, "define i64 @min({i64, i64*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, i64*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, i64*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%init\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret i64 0\n");
-    emit(ctx, "init:\n");
-    emit(ctx, "  %%first_ptr = getelementptr i64, i64* %%data, i64 0\n");
-    emit(ctx, "  %%first_val = load i64, i64* %%first_ptr\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [1, %%init], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%min_val = phi i64 [%%first_val, %%init], [%%new_min, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr i64, i64* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load i64, i64* %%ptr\n");
-    emit(ctx, "  %%is_less = icmp slt i64 %%val, %%min_val\n");
-    emit(ctx, "  %%new_min = select i1 %%is_less, i64 %%val, i64 %%min_val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  ret i64 %%min_val\n");
-    emit(ctx, "}\n\n");
+    emit_agg_kernel(ctx, "min", "i64", AGG_KERNEL_MIN, true);
 
     emit(ctx, "; max: finds the maximum element in an integer array\n");
-    emit(ctx, "define i64 @max({i64, i64*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, i64*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, i64*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%init\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret i64 0\n");
-    emit(ctx, "init:\n");
-    emit(ctx, "  %%first_ptr = getelementptr i64, i64* %%data, i64 0\n");
-    emit(ctx, "  %%first_val = load i64, i64* %%first_ptr\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [1, %%init], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%max_val = phi i64 [%%first_val, %%init], [%%new_max, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr i64, i64* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load i64, i64* %%ptr\n");
-    emit(ctx, "  %%is_greater = icmp sgt i64 %%val, %%max_val\n");
-    emit(ctx, "  %%new_max = select i1 %%is_greater, i64 %%val, i64 %%max_val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  ret i64 %%max_val\n");
-    emit(ctx, "}\n\n");
+    emit_agg_kernel(ctx, "max", "i64", AGG_KERNEL_MAX, true);
 
     // ==================== FLOAT ARRAY AGGREGATES ====================
 
-    emit(ctx, "; sum_float: sums all elements in a float array\n");
-    emit(ctx, "define double @sum_float({i64, double*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, double*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, double*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%loop_cond\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret double 0.0\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [0, %%entry], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%acc = phi double [0.0, %%entry], [%%acc_next, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr double, double* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load double, double* %%ptr\n");
-    emit(ctx, "  %%acc_next = fadd double %%acc, %%val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  ret double %%acc\n");
-    emit(ctx, "}\n\n");
+    emit(ctx, "; sum_float: sums all elements in a float array%s\n",
+         ctx->fast_math ? " (fast-math: reassociated)" : "");
+    emit_agg_kernel(ctx, "sum_float", "double", AGG_KERNEL_SUM, ctx->fast_math);
 
     emit(ctx, "; mean_float: calculates the average of a float array\n");
-    emit(ctx, "define double @mean_float({i64, double*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, double*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, double*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%loop_cond\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret double 0.0\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [0, %%entry], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%acc = phi double [0.0, %%entry], [%%acc_next, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr double, double* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load double, double* %%ptr\n");
-    emit(ctx, "  %%acc_next = fadd double %%acc, %%val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  %%size_f = sitofp i64 %%size to double\n");
-    emit(ctx, "  %%result = fdiv double %%acc, %%size_f\n");
-    emit(ctx, "  ret double %%result\n");
-    emit(ctx, "}\n\n");
+    emit_mean_kernel(ctx, "mean_float", "double", "sum_float");
 
     emit(ctx, "; min_float: finds the minimum element in a float array\n");
-    emit(ctx, "define double @min_float({i64, double*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, double*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, double*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%init\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret double 0.0\n");
-    emit(ctx, "init:\n");
-    emit(ctx, "  %%first_ptr = getelementptr double, double* %%data, i64 0\n");
-    emit(ctx, "  %%first_val = load double, double* %%first_ptr\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [1, %%init], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%min_val = phi double [%%first_val, %%init], [%%new_min, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr double, double* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load double, double* %%ptr\n");
-    emit(ctx, "  %%is_less = fcmp olt double %%val, %%min_val\n");
-    emit(ctx, "  %%new_min = select i1 %%is_less, double %%val, double %%min_val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  ret double %%min_val\n");
-    emit(ctx, "}\n\n");
+    emit_agg_kernel(ctx, "min_float", "double", AGG_KERNEL_MIN, true);
 
     emit(ctx, "; max_float: finds the maximum element in a float array\n");
-    emit(ctx, "define double @max_float({i64, double*} %%array) {\n");
-    emit(ctx, "entry:\n");
-    emit(ctx, "  %%size = extractvalue {i64, double*} %%array, 0\n");
-    emit(ctx, "  %%data = extractvalue {i64, double*} %%array, 1\n");
-    emit(ctx, "  %%size_zero = icmp eq i64 %%size, 0\n");
-    emit(ctx, "  br i1 %%size_zero, label %%return_zero, label %%init\n");
-    emit(ctx, "return_zero:\n");
-    emit(ctx, "  ret double 0.0\n");
-    emit(ctx, "init:\n");
-    emit(ctx, "  %%first_ptr = getelementptr double, double* %%data, i64 0\n");
-    emit(ctx, "  %%first_val = load double, double* %%first_ptr\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_cond:\n");
-    emit(ctx, "  %%i = phi i64 [1, %%init], [%%i_next, %%loop_body]\n");
-    emit(ctx, "  %%max_val = phi double [%%first_val, %%init], [%%new_max, %%loop_body]\n");
-    emit(ctx, "  %%cmp = icmp slt i64 %%i, %%size\n");
-    emit(ctx, "  br i1 %%cmp, label %%loop_body, label %%loop_end\n");
-    emit(ctx, "loop_body:\n");
-    emit(ctx, "  %%ptr = getelementptr double, double* %%data, i64 %%i\n");
-    emit(ctx, "  %%val = load double, double* %%ptr\n");
-    emit(ctx, "  %%is_greater = fcmp ogt double %%val, %%max_val\n");
-    emit(ctx, "  %%new_max = select i1 %%is_greater, double %%val, double %%max_val\n");
-    emit(ctx, "  %%i_next = add i64 %%i, 1\n");
-    emit(ctx, "  br label %%loop_cond\n");
-    emit(ctx, "loop_end:\n");
-    emit(ctx, "  ret double %%max_val\n");
-    emit(ctx, "}\n\n");
+    emit_agg_kernel(ctx, "max_float", "double", AGG_KERNEL_MAX, true);
 }
 
 bool generate_llvm_ir(CodeGenContext* ctx, ASTNode* program) {
     if (!ctx || !program || program->type != AST_PROGRAM) return false;
     
-    printf("\n[CodeGen] Iniciando geração de código LLVM IR...\n");
+    log_info("\n[CodeGen] Iniciando geração de código LLVM IR...\n");
     
     emit(ctx, "; DataLang - LLVM IR\n\n");
     emit_runtime_functions(ctx);
@@ -3400,20 +3815,20 @@ bool generate_llvm_ir(CodeGenContext* ctx, ASTNode* program) {
             }
 
             const char* llvm_type = type_to_llvm(var_type);
-            char* global_name = malloc(256);
+            char* global_name = arena_alloc(ctx->arena, 256);
             snprintf(global_name, 256, "@global_%s", decl->let_decl.name);
 
             // Declare the global variable
             emit(ctx, "%s = global %s ", global_name, llvm_type);
 
             // Initialize with default value or initializer
-            if (decl->let_decl.initializer && decl->let_decl.initializer->type == AST_LITERAL) {
+            if (is_static_global_initializer(decl->let_decl.initializer, var_type)) {
                 switch (var_type->kind) {
                     case TYPE_INT:
                         emit(ctx, "%lld\n", decl->let_decl.initializer->literal.int_value);
                         break;
                     case TYPE_FLOAT:
-                        emit(ctx, "%e\n", decl->let_decl.initializer->literal.float_value);
+                        emit(ctx, "%.16e\n", decl->let_decl.initializer->literal.float_value);
                         break;
                     case TYPE_BOOL:
                         emit(ctx, "%s\n", decl->let_decl.initializer->literal.bool_value ? "true" : "false");
@@ -3480,27 +3895,41 @@ bool generate_llvm_ir(CodeGenContext* ctx, ASTNode* program) {
         }
     }
     
-    return true;
+    return !ctx->had_error;
 }
 
 CodeGenContext* create_codegen_context(SemanticAnalyzer* analyzer, FILE* output) {
     CodeGenContext* ctx = calloc(1, sizeof(CodeGenContext));
     ctx->output = output;
     ctx->analyzer = analyzer;
+    ctx->arena = analyzer->arena;
+    if (!ctx->arena) {
+        ctx->arena = arena_create(0);
+        ctx->owns_arena = true;
+    }
     ctx->var_map.capacity = 16;
-    ctx->var_map.names = malloc(16 * sizeof(char*));
     ctx->var_map.llvm_names = malloc(16 * sizeof(char*));
+    ctx->var_map.slots = malloc(16 * sizeof(int));
+    ctx->var_map.shadowed = malloc(16 * sizeof(int));
+    ctx->var_map.bucket_capacity = 64;
+    ctx->var_map.buckets = calloc(ctx->var_map.bucket_capacity, sizeof(VarMapBucket));
     ctx->string_literals.capacity = 16;
     ctx->string_literals.values = malloc(16 * sizeof(char*));
     ctx->string_literals.llvm_names = malloc(16 * sizeof(char*));
+    ctx->string_literals.bucket_capacity = 64;
+    ctx->string_literals.buckets = calloc(ctx->string_literals.bucket_capacity, sizeof(int));
     return ctx;
 }
 
 void free_codegen_context(CodeGenContext* ctx) {
     if (!ctx) return;
-    free(ctx->var_map.names);
     free(ctx->var_map.llvm_names);
+    free(ctx->var_map.slots);
+    free(ctx->var_map.shadowed);
+    free(ctx->var_map.buckets);
     free(ctx->string_literals.values);
     free(ctx->string_literals.llvm_names);
+    free(ctx->string_literals.buckets);
+    if (ctx->owns_arena) arena_destroy(ctx->arena);
     free(ctx);
 }
@@ -12,6 +12,12 @@
 
 // ==================== ESTRUTURAS ====================
 
+// Nome de variável no mapa do codegen
+typedef struct {
+    const char* name;                // Internado: comparado por ponteiro
+    int head;                        // Declaração visível (-1 = fora de escopo)
+} VarMapBucket;
+
 // Contexto de geração de código
 typedef struct CodeGenContext {
     FILE* output;                    // Arquivo de saída para LLVM IR
@@ -25,21 +31,41 @@ typedef struct CodeGenContext {
     // Estado atual
     char* current_function;          // Função sendo gerada
     bool in_function;                // Se está dentro de função
-    
-    // Mapeamento de variáveis para valores LLVM
+    char current_block[64];          // Bloco básico onde o código está sendo emitido
+    FILE* entry_allocas;             // Allocas do bloco de entrada da função atual
+
+    // Memória de temporários, labels e nomes gerados
+    Arena* arena;
+    bool owns_arena;                 // Criada aqui quando o analisador não tem arena
+
+    // Opções de geração
+    bool fast_math;                  // Permite reassociar somas Float (kernels vetoriais)
+
+    // Construção que o codegen não consegue gerar fielmente: o IR é descartado
+    bool had_error;
+
+    // Mapeamento de variáveis para valores LLVM: pilha de declarações
+    // (truncada ao sair de escopos) indexada por uma tabela hash de nomes
+    // que aponta para a declaração visível mais recente
     struct {
-        char** names;
         char** llvm_names;
+        int* slots;                  // Entrada de buckets de cada declaração
+        int* shadowed;               // Declaração anterior do mesmo nome (-1 = nenhuma)
         int count;
         int capacity;
+        VarMapBucket* buckets;       // Endereçamento aberto, potência de 2
+        int bucket_count;
+        int bucket_capacity;
     } var_map;
     
-    // Strings literais globais
+    // Strings literais globais (valores internados, deduplicados por ponteiro)
     struct {
         char** values;
         char** llvm_names;
         int count;
         int capacity;
+        int* buckets;                // Índice + 1 em values (0 = livre)
+        int bucket_capacity;
     } string_literals;
     
 } CodeGenContext;
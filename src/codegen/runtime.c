@@ -3,13 +3,23 @@
  * Suporte para concatenação de strings, DataFrames e I/O com CSV real
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 #include <stdarg.h>
+#include <errno.h>
+#include <math.h>
 
 // ==================== STRING CONCATENATION ====================
 
@@ -34,13 +44,68 @@ char* __str_concat(char* s1, char* s2) {
 
 // ==================== DATAFRAME ESTRUTURA ====================
 
+// Tipo físico de uma coluna do DataFrame
+typedef enum {
+    COL_INT,
+    COL_FLOAT,
+    COL_BOOL,
+    COL_STRING
+} ColumnType;
+
+// Bloco de cópias materializadas (strings que não podem ser views diretas do
+// arquivo, ex.: campos com aspas escapadas ou valores vindos do programa)
+typedef struct StringBlock {
+    struct StringBlock* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} StringBlock;
+
+// Armazenamento compartilhado (contagem de referências) das strings de uma
+// coluna: o CSV de origem mapeado em memória + blocos de cópias
 typedef struct {
+    int refcount;
+    char* map;           // arquivo de origem (mmap, ou lido quando mmap falha)
+    size_t map_size;
+    bool map_is_mmap;
+    StringBlock* blocks;
+} StringStore;
+
+// Valor String: view (ponteiro + tamanho) para dentro de um StringStore
+typedef struct {
+    const char* ptr;
+    int64_t len;
+} StrView;
+
+// Coluna tipada (armazenamento colunar): valores contíguos + bitmap de validade.
+// Células null têm o bit de validade zerado e valor neutro no buffer.
+typedef struct {
+    char* name;
+    ColumnType type;
+    int64_t length;
+    int64_t capacity;
+    uint8_t* validity;   // bit r = 1 -> valor presente, 0 -> null
+    union {
+        void* raw;
+        int64_t* ints;
+        double* floats;
+        uint8_t* bools;
+        StrView* strings;
+    } as;
+    StringStore* store;  // dono da memória apontada pelas views (só String)
+} Column;
+
+// Um DataFrame pode ser uma visão (resultado de filter): as colunas são as do
+// pai e `selection` lista, para cada linha lógica, a linha física no pai. O
+// pai precisa continuar vivo enquanto houver visões sobre ele.
+typedef struct DataFrame {
     int64_t id;
     char* source_file;
     int64_t row_count;
     int64_t col_count;
-    char** column_names;
-    char*** data;  // [row][col] = string value
+    Column* columns;            // [col] -> coluna (emprestada do pai numa visão)
+    struct DataFrame* parent;   // != NULL: visão sobre as colunas do pai
+    int64_t* selection;         // visão: linha física de cada linha lógica
 } DataFrame;
 static int64_t df_counter = 0;
 
@@ -56,10 +121,19 @@ bool file_exists(const char* path) {
     return (stat(path, &buffer) == 0);
 }
 
+static void* xrealloc(void* ptr, size_t size) {
+    void* result = realloc(ptr, size ? size : 1);
+    if (!result) {
+        fprintf(stderr, "Erro: Falha ao alocar memória para DataFrame\n");
+        exit(1);
+    }
+    return result;
+}
+
 static int find_column_index(DataFrame* df, const char* name) {
     if (!df || !name) return -1;
     for (int64_t i = 0; i < df->col_count; i++) {
-        if (strcmp(df->column_names[i], name) == 0) return (int)i;
+        if (strcmp(df->columns[i].name, name) == 0) return (int)i;
     }
     return -1;
 }
@@ -68,147 +142,1040 @@ static char* strdup_or_null(const char* s) {
     return s ? strdup(s) : NULL;
 }
 
-char* trim_whitespace(char* str) {
-    char* end;
-    
-    // Trim leading space
-    while (*str == ' ' || *str == '\t') str++;
-    
-    if (*str == 0) return str;
-    
-    // Trim trailing space
-    end = str + strlen(str) - 1;
-    while (end > str && (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r')) {
-        end--;
+static const char* column_type_name(ColumnType type) {
+    switch (type) {
+        case COL_INT: return "Int";
+        case COL_FLOAT: return "Float";
+        case COL_BOOL: return "Bool";
+        case COL_STRING: return "String";
     }
-    
-    *(end + 1) = '\0';
-    return str;
+    return "String";
 }
 
-char** parse_csv_line(char* line, int* count) {
-    int capacity = 10;
-    char** fields = malloc(capacity * sizeof(char*));
-    *count = 0;
-    
-    char* start = line;
-    char* current = line;
-    bool in_quotes = false;
-    
-    while (*current) {
-        if (*current == '"') {
-            in_quotes = !in_quotes;
-        } else if (*current == ',' && !in_quotes) {
-            // End of field
-            *current = '\0';
-            
-            char* field = trim_whitespace(start);
-            
-            // Remove quotes if present
-            if (*field == '"' && field[strlen(field)-1] == '"') {
-                field++;
-                field[strlen(field)-1] = '\0';
-            }
-            
-            if (*count >= capacity) {
+// ==================== STRING STORE ====================
+
+static StringStore* store_create(void) {
+    StringStore* store = (StringStore*)calloc(1, sizeof(StringStore));
+    store->refcount = 1;
+    return store;
+}
+
+static StringStore* store_retain(StringStore* store) {
+    if (store) store->refcount++;
+    return store;
+}
+
+static void store_release(StringStore* store) {
+    if (!store || --store->refcount > 0) return;
+    if (store->map) {
+        if (store->map_is_mmap) munmap(store->map, store->map_size);
+        else free(store->map);
+    }
+    StringBlock* block = store->blocks;
+    while (block) {
+        StringBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(store);
+}
+
+// Reserva `size` bytes estáveis dentro do store (blocos nunca são realocados)
+static char* store_alloc(StringStore* store, size_t size) {
+    StringBlock* block = store->blocks;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > 4096 ? size : 4096;
+        block = (StringBlock*)malloc(sizeof(StringBlock) + capacity);
+        if (!block) {
+            fprintf(stderr, "Erro: Falha ao alocar memória para DataFrame\n");
+            exit(1);
+        }
+        block->used = 0;
+        block->capacity = capacity;
+        block->next = store->blocks;
+        store->blocks = block;
+    }
+    char* result = block->data + block->used;
+    block->used += size;
+    return result;
+}
+
+// Materializa uma cópia terminada em '\0' de ptr[0..len)
+static const char* store_copy(StringStore* store, const char* ptr, int64_t len) {
+    char* copy = store_alloc(store, (size_t)len + 1);
+    memcpy(copy, ptr, (size_t)len);
+    copy[len] = '\0';
+    return copy;
+}
+
+// Transfere os blocos de `src` para `dst` (os ponteiros continuam válidos) e
+// libera `src`
+static void store_absorb(StringStore* dst, StringStore* src) {
+    StringBlock* block = src->blocks;
+    while (block) {
+        StringBlock* next = block->next;
+        block->next = dst->blocks;
+        dst->blocks = block;
+        block = next;
+    }
+    src->blocks = NULL;
+    store_release(src);
+}
+
+// ==================== COLUNAS TIPADAS ====================
+
+static size_t column_value_size(ColumnType type) {
+    switch (type) {
+        case COL_INT: return sizeof(int64_t);
+        case COL_FLOAT: return sizeof(double);
+        case COL_BOOL: return sizeof(uint8_t);
+        case COL_STRING: return sizeof(StrView);
+    }
+    return sizeof(int64_t);
+}
+
+static void column_reserve(Column* col, int64_t needed) {
+    if (needed <= col->capacity) return;
+    int64_t capacity = col->capacity > 0 ? col->capacity : 16;
+    while (capacity < needed) capacity *= 2;
+
+    col->as.raw = xrealloc(col->as.raw, (size_t)capacity * column_value_size(col->type));
+
+    int64_t old_bytes = (col->capacity + 7) / 8;
+    int64_t new_bytes = (capacity + 7) / 8;
+    col->validity = (uint8_t*)xrealloc(col->validity, (size_t)new_bytes);
+    memset(col->validity + old_bytes, 0, (size_t)(new_bytes - old_bytes));
+
+    col->capacity = capacity;
+}
+
+static void column_init(Column* col, const char* name, ColumnType type, int64_t capacity) {
+    memset(col, 0, sizeof(Column));
+    col->name = strdup(name ? name : "col");
+    col->type = type;
+    column_reserve(col, capacity > 0 ? capacity : 1);
+}
+
+static void column_free(Column* col) {
+    store_release(col->store);
+    free(col->as.raw);
+    free(col->validity);
+    free(col->name);
+    memset(col, 0, sizeof(Column));
+}
+
+static inline bool column_is_valid(const Column* col, int64_t row) {
+    return (col->validity[row >> 3] >> (row & 7)) & 1;
+}
+
+static inline void column_set_valid(Column* col, int64_t row, bool valid) {
+    if (valid) col->validity[row >> 3] |= (uint8_t)(1u << (row & 7));
+    else col->validity[row >> 3] &= (uint8_t)~(1u << (row & 7));
+}
+
+static void column_append_null(Column* col) {
+    column_reserve(col, col->length + 1);
+    switch (col->type) {
+        case COL_INT: col->as.ints[col->length] = 0; break;
+        case COL_FLOAT: col->as.floats[col->length] = 0.0; break;
+        case COL_BOOL: col->as.bools[col->length] = 0; break;
+        case COL_STRING: col->as.strings[col->length] = (StrView){NULL, 0}; break;
+    }
+    column_set_valid(col, col->length, false);
+    col->length++;
+}
+
+static void column_append_int(Column* col, int64_t value) {
+    column_reserve(col, col->length + 1);
+    col->as.ints[col->length] = value;
+    column_set_valid(col, col->length++, true);
+}
+
+static void column_append_float(Column* col, double value) {
+    column_reserve(col, col->length + 1);
+    col->as.floats[col->length] = value;
+    column_set_valid(col, col->length++, true);
+}
+
+static void column_append_bool(Column* col, bool value) {
+    column_reserve(col, col->length + 1);
+    col->as.bools[col->length] = value ? 1 : 0;
+    column_set_valid(col, col->length++, true);
+}
+
+// Acrescenta uma view sem copiar; `ptr` precisa viver tanto quanto col->store
+static void column_append_view(Column* col, const char* ptr, int64_t len) {
+    column_reserve(col, col->length + 1);
+    col->as.strings[col->length] = (StrView){ptr, len};
+    column_set_valid(col, col->length++, true);
+}
+
+// Acrescenta uma cópia de ptr[0..len) materializada no store da coluna
+static void column_append_string(Column* col, const char* ptr, int64_t len) {
+    if (!col->store) col->store = store_create();
+    column_append_view(col, store_copy(col->store, ptr, len), len);
+}
+
+// Copia as linhas `rows[0..n)` de `src` para uma nova coluna `dst`.
+// Com rows == NULL copia as n primeiras linhas (identidade).
+static void column_gather(Column* dst, const Column* src, const int64_t* rows, int64_t n) {
+    column_init(dst, src->name, src->type, n);
+    dst->store = store_retain(src->store);  // views continuam válidas sem cópia
+    for (int64_t i = 0; i < n; i++) {
+        int64_t r = rows ? rows[i] : i;
+        bool valid = column_is_valid(src, r);
+        switch (src->type) {
+            case COL_INT: dst->as.ints[i] = src->as.ints[r]; break;
+            case COL_FLOAT: dst->as.floats[i] = src->as.floats[r]; break;
+            case COL_BOOL: dst->as.bools[i] = src->as.bools[r]; break;
+            case COL_STRING: dst->as.strings[i] = src->as.strings[r]; break;
+        }
+        column_set_valid(dst, i, valid);
+    }
+    dst->length = n;
+}
+
+static bool column_cells_equal(const Column* a, int64_t ra, const Column* b, int64_t rb) {
+    bool va = column_is_valid(a, ra);
+    bool vb = column_is_valid(b, rb);
+    if (!va || !vb) return va == vb;
+    switch (a->type) {
+        case COL_INT: return a->as.ints[ra] == b->as.ints[rb];
+        case COL_FLOAT: return a->as.floats[ra] == b->as.floats[rb];
+        case COL_BOOL: return a->as.bools[ra] == b->as.bools[rb];
+        case COL_STRING: {
+            StrView x = a->as.strings[ra], y = b->as.strings[rb];
+            return x.len == y.len && memcmp(x.ptr, y.ptr, (size_t)x.len) == 0;
+        }
+    }
+    return false;
+}
+
+// strtod sobre uma view (que não é terminada em '\0')
+static double view_to_double(StrView v) {
+    char buf[64];
+    size_t len = v.len < (int64_t)sizeof(buf) - 1 ? (size_t)v.len : sizeof(buf) - 1;
+    memcpy(buf, v.ptr, len);
+    buf[len] = '\0';
+    return strtod(buf, NULL);
+}
+
+// Valor numérico da célula; retorna false para null
+static bool column_get_double(const Column* col, int64_t row, double* out) {
+    if (!column_is_valid(col, row)) return false;
+    switch (col->type) {
+        case COL_INT: *out = (double)col->as.ints[row]; return true;
+        case COL_FLOAT: *out = col->as.floats[row]; return true;
+        case COL_BOOL: *out = col->as.bools[row] ? 1.0 : 0.0; return true;
+        case COL_STRING: *out = view_to_double(col->as.strings[row]); return true;
+    }
+    return false;
+}
+
+// Formata Float de forma que o texto volte ao mesmo double e mantenha um ponto
+// decimal ("7500.0" continua "7500.0", não "7500")
+static void format_float_cell(double value, char* buf, size_t size) {
+    snprintf(buf, size, "%.15g", value);
+    if (strtod(buf, NULL) != value) snprintf(buf, size, "%.17g", value);
+    if (!strpbrk(buf, ".eEni")) {
+        size_t len = strlen(buf);
+        if (len + 2 < size) memcpy(buf + len, ".0", 3);
+    }
+}
+
+// Representação textual da célula (ptr NULL para null). Strings são
+// devolvidas como a própria view; os demais tipos são formatados em `buf`.
+static StrView column_format(const Column* col, int64_t row, char* buf, size_t size) {
+    if (!column_is_valid(col, row)) return (StrView){NULL, 0};
+    switch (col->type) {
+        case COL_INT:
+            snprintf(buf, size, "%lld", (long long)col->as.ints[row]);
+            return (StrView){buf, (int64_t)strlen(buf)};
+        case COL_FLOAT:
+            format_float_cell(col->as.floats[row], buf, size);
+            return (StrView){buf, (int64_t)strlen(buf)};
+        case COL_BOOL:
+            return col->as.bools[row] ? (StrView){"true", 4} : (StrView){"false", 5};
+        case COL_STRING:
+            return col->as.strings[row];
+    }
+    return (StrView){NULL, 0};
+}
+
+// ==================== TIPAGEM DE COLUNAS (CSV) ====================
+
+// Copia a view para `buf` terminado em '\0'; false se não couber
+static bool view_to_cstr(StrView v, char* buf, size_t size) {
+    if (v.len <= 0 || (size_t)v.len >= size) return false;
+    memcpy(buf, v.ptr, (size_t)v.len);
+    buf[v.len] = '\0';
+    return true;
+}
+
+// Inteiro canônico: [-]dígitos, sem zeros à esquerda ("007" e CEPs continuam String)
+static bool parse_int_text(StrView v, int64_t* out) {
+    char s[32];
+    if (!view_to_cstr(v, s, sizeof(s))) return false;
+    const char* p = s;
+    if (*p == '-') p++;
+    if (!*p) return false;
+    if (*p == '0' && p[1] != '\0') return false;
+    for (const char* q = p; *q; q++) {
+        if (*q < '0' || *q > '9') return false;
+    }
+    errno = 0;
+    long long n = strtoll(s, NULL, 10);
+    if (errno == ERANGE) return false;
+    *out = (int64_t)n;
+    return true;
+}
+
+static bool parse_float_text(StrView v, double* out) {
+    char s[64];
+    if (!view_to_cstr(v, s, sizeof(s))) return false;
+    const char* p = s;
+    if (*p == '-' || *p == '+') p++;
+    if (!((*p >= '0' && *p <= '9') || *p == '.')) return false;  // rejeita inf/nan
+    if (*p == '0' && p[1] >= '0' && p[1] <= '9') return false;   // "007" continua String
+    for (const char* q = p; *q; q++) {
+        if (*q == 'x' || *q == 'X') return false;                // rejeita hexadecimal
+    }
+    char* end = NULL;
+    double n = strtod(s, &end);
+    if (end == s || *end != '\0') return false;
+    *out = n;
+    return true;
+}
+
+static bool parse_bool_text(StrView v, bool* out) {
+    if (v.len == 4 && memcmp(v.ptr, "true", 4) == 0) { *out = true; return true; }
+    if (v.len == 5 && memcmp(v.ptr, "false", 5) == 0) { *out = false; return true; }
+    return false;
+}
+
+// ==================== LEITOR CSV (MMAP) ====================
+
+// Campo de um registro: intervalo [start, start+len) no arquivo, já sem
+// espaços e aspas externas. `escaped` indica aspas duplicadas ("") internas.
+typedef struct {
+    size_t start;
+    size_t len;
+    bool escaped;
+} FieldSpan;
+
+typedef struct {
+    FieldSpan* fields;
+    int count;
+    int capacity;
+} CsvRecord;
+
+// Mapeia o arquivo inteiro somente-leitura; se mmap não for possível (ex.:
+// pipes) lê o conteúdo para memória
+static StringStore* csv_map_file(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    StringStore* store = store_create();
+    store->map_size = (size_t)st.st_size;
+    if (store->map_size > 0) {
+        void* map = mmap(NULL, store->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, store->map_size, MADV_SEQUENTIAL);
+            store->map = (char*)map;
+            store->map_is_mmap = true;
+        }
+    }
+    if (!store->map) {
+        size_t capacity = store->map_size > 0 ? store->map_size : 4096;
+        size_t used = 0;
+        char* buffer = (char*)xrealloc(NULL, capacity);
+        ssize_t n;
+        while ((n = read(fd, buffer + used, capacity - used)) > 0) {
+            used += (size_t)n;
+            if (used == capacity) {
                 capacity *= 2;
-                fields = realloc(fields, capacity * sizeof(char*));
+                buffer = (char*)xrealloc(buffer, capacity);
             }
-            
-            fields[(*count)++] = strdup(field);
-            start = current + 1;
         }
-        current++;
+        store->map = buffer;
+        store->map_size = used;
     }
-    
-    // Last field
-    char* field = trim_whitespace(start);
-    if (*field == '"' && field[strlen(field)-1] == '"') {
-        field++;
-        field[strlen(field)-1] = '\0';
+    close(fd);
+    return store;
+}
+
+// Campo [start, end): remove espaços e aspas externas; aspas restantes no
+// conteúdo de um campo entre aspas indicam "" a desfazer
+static void csv_push_field(const char* data, size_t start, size_t end, CsvRecord* rec) {
+    while (start < end && (data[start] == ' ' || data[start] == '\t')) start++;
+    while (end > start && (data[end - 1] == ' ' || data[end - 1] == '\t' ||
+                           data[end - 1] == '\r' || data[end - 1] == '\n')) end--;
+
+    // Remove aspas externas
+    bool escaped = false;
+    if (end - start >= 2 && data[start] == '"' && data[end - 1] == '"') {
+        start++;
+        end--;
+        escaped = end > start && memchr(data + start, '"', end - start) != NULL;
     }
-    
-    if (*count >= capacity) {
-        capacity *= 2;
-        fields = realloc(fields, capacity * sizeof(char*));
+
+    if (rec->count >= rec->capacity) {
+        rec->capacity = rec->capacity ? rec->capacity * 2 : 16;
+        rec->fields = (FieldSpan*)xrealloc(rec->fields, rec->capacity * sizeof(FieldSpan));
+    }
+    rec->fields[rec->count++] = (FieldSpan){start, end - start, escaped};
+}
+
+// ==================== SCANNER CSV (SIMD) ====================
+
+// O scanner indexa uma janela do arquivo por vez: para cada bloco de 64 bytes
+// calcula máscaras de aspas, vírgulas e quebras de linha (SSE2/AVX2 ou escalar),
+// deriva a máscara "dentro de aspas" por XOR prefixado e achata os bits dos
+// separadores fora de aspas em uma lista de índices consumida pelo leitor de
+// registros.
+
+#define CSV_BLOCK_BYTES 64
+#define CSV_WINDOW_BYTES (256 * CSV_BLOCK_BYTES)
+
+typedef struct {
+    uint64_t quotes;
+    uint64_t commas;
+    uint64_t newlines;
+} CsvBlockMasks;
+
+typedef void (*CsvMaskKernel)(const char* block, CsvBlockMasks* masks);
+
+typedef struct {
+    const char* data;
+    size_t end;              // fim do intervalo varrido
+    size_t window_start;     // janela indexada atual
+    size_t window_end;
+    bool in_quotes;          // estado ao fim da janela indexada
+    uint32_t indices[CSV_WINDOW_BYTES];  // separadores (relativos à janela)
+    size_t count;
+    size_t next;
+} CsvScanner;
+
+static void csv_masks_scalar(const char* block, CsvBlockMasks* masks) {
+    uint64_t quotes = 0, commas = 0, newlines = 0;
+    for (int i = 0; i < CSV_BLOCK_BYTES; i++) {
+        char ch = block[i];
+        quotes |= (uint64_t)(ch == '"') << i;
+        commas |= (uint64_t)(ch == ',') << i;
+        newlines |= (uint64_t)(ch == '\n') << i;
+    }
+    masks->quotes = quotes;
+    masks->commas = commas;
+    masks->newlines = newlines;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static void csv_masks_sse2(const char* block, CsvBlockMasks* masks) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t quotes = 0, commas = 0, newlines = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        quotes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << (16 * i);
+        commas |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, comma)) << (16 * i);
+        newlines |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)) << (16 * i);
+    }
+    masks->quotes = quotes;
+    masks->commas = commas;
+    masks->newlines = newlines;
+}
+
+__attribute__((target("avx2")))
+static void csv_masks_avx2(const char* block, CsvBlockMasks* masks) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256((const __m256i*)block);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(block + 32));
+    masks->quotes = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote)) |
+                    (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)) << 32;
+    masks->commas = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, comma)) |
+                    (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, comma)) << 32;
+    masks->newlines = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, newline)) |
+                      (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, newline)) << 32;
+}
+#endif
+
+static CsvMaskKernel csv_mask_kernel = csv_masks_scalar;
+
+// Escolhe o kernel uma vez por carga (antes de criar threads). DATALANG_SIMD
+// força "scalar", "sse2" ou "avx2".
+static void csv_select_kernel(void) {
+    const char* env = getenv("DATALANG_SIMD");
+    csv_mask_kernel = csv_masks_scalar;
+    if (env && strcmp(env, "scalar") == 0) return;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) csv_mask_kernel = csv_masks_sse2;
+    if (env && strcmp(env, "sse2") == 0) return;
+    if (__builtin_cpu_supports("avx2")) csv_mask_kernel = csv_masks_avx2;
+#endif
+}
+
+// XOR prefixado: bit i = paridade das aspas em [0, i]
+static inline uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Indexa a próxima janela: posições de vírgulas/quebras de linha fora de aspas
+static void csv_index_window(CsvScanner* sc) {
+    size_t start = sc->window_end;
+    size_t end = start + CSV_WINDOW_BYTES < sc->end ? start + CSV_WINDOW_BYTES : sc->end;
+    sc->count = 0;
+    sc->next = 0;
+
+    for (size_t block = start; block < end; block += CSV_BLOCK_BYTES) {
+        size_t len = end - block < CSV_BLOCK_BYTES ? end - block : CSV_BLOCK_BYTES;
+        CsvBlockMasks masks;
+        if (len == CSV_BLOCK_BYTES) {
+            csv_mask_kernel(sc->data + block, &masks);
+        } else {
+            char tail[CSV_BLOCK_BYTES] = {0};
+            memcpy(tail, sc->data + block, len);
+            csv_mask_kernel(tail, &masks);
+        }
+
+        uint64_t inside = prefix_xor(masks.quotes) ^ (sc->in_quotes ? ~0ULL : 0ULL);
+        sc->in_quotes = (inside >> (len - 1)) & 1;
+
+        uint64_t separators = (masks.commas | masks.newlines) & ~inside;
+        if (len < CSV_BLOCK_BYTES) separators &= (1ULL << len) - 1;
+        while (separators) {
+            sc->indices[sc->count++] = (uint32_t)(block - start) + (uint32_t)__builtin_ctzll(separators);
+            separators &= separators - 1;
+        }
+    }
+    sc->window_start = start;
+    sc->window_end = end;
+}
+
+// `start` precisa ser início de registro (fora de aspas)
+static void csv_scanner_init(CsvScanner* sc, const char* data, size_t start, size_t end) {
+    sc->data = data;
+    sc->end = end;
+    sc->window_start = start;
+    sc->window_end = start;
+    sc->in_quotes = false;
+    sc->count = 0;
+    sc->next = 0;
+}
+
+// Próximo separador fora de aspas, ou sc->end se não houver mais
+static size_t csv_scanner_next(CsvScanner* sc) {
+    while (sc->next >= sc->count) {
+        if (sc->window_end >= sc->end) return sc->end;
+        csv_index_window(sc);
+    }
+    return sc->window_start + sc->indices[sc->next++];
+}
+
+// Lê o registro que começa em `*pos` (quebras de linha entre aspas fazem
+// parte do campo) e avança `*pos` para o registro seguinte
+static void csv_scan_record(CsvScanner* sc, size_t* pos, CsvRecord* rec) {
+    rec->count = 0;
+    size_t field_start = *pos;
+    for (;;) {
+        size_t sep = csv_scanner_next(sc);
+        if (sep >= sc->end) {
+            csv_push_field(sc->data, field_start, sc->end, rec);
+            *pos = sc->end;
+            return;
+        }
+        csv_push_field(sc->data, field_start, sep, rec);
+        field_start = sep + 1;
+        if (sc->data[sep] == '\n') {
+            *pos = sep + 1;
+            return;
+        }
+    }
+}
+
+static bool csv_record_is_blank(const CsvRecord* rec) {
+    return rec->count == 1 && rec->fields[0].len == 0;
+}
+
+// Copia o campo desfazendo as aspas duplicadas ("" -> ")
+static StrView csv_unescape(StringStore* store, const char* data, FieldSpan f) {
+    char* out = store_alloc(store, f.len + 1);
+    size_t n = 0;
+    for (size_t i = 0; i < f.len; i++) {
+        out[n++] = data[f.start + i];
+        if (data[f.start + i] == '"' && i + 1 < f.len && data[f.start + i + 1] == '"') i++;
+    }
+    out[n] = '\0';
+    return (StrView){out, (int64_t)n};
+}
+
+// ==================== INFERÊNCIA DE ESQUEMA ====================
+
+// Número de linhas de dados amostradas para inferir o tipo de cada coluna
+// (pode ser alterado com a variável de ambiente DATALANG_INFER_ROWS)
+#define INFER_SAMPLE_ROWS 1000
+
+static int64_t infer_sample_rows(void) {
+    const char* env = getenv("DATALANG_INFER_ROWS");
+    if (env && *env) {
+        long long n = strtoll(env, NULL, 10);
+        if (n > 0) return (int64_t)n;
+    }
+    return INFER_SAMPLE_ROWS;
+}
+
+// Decide o tipo mais estreito (Int -> Float -> Bool -> String) que representa
+// todos os valores não vazios da coluna `col` nos registros amostrados.
+static ColumnType infer_column_type(const char* data, const CsvRecord* sample, int64_t sample_rows, int64_t col) {
+    bool can_int = true, can_float = true, can_bool = true, any_value = false;
+    for (int64_t r = 0; r < sample_rows && (can_int || can_float || can_bool); r++) {
+        if (col >= sample[r].count) continue;
+        FieldSpan f = sample[r].fields[col];
+        if (f.len == 0) continue;
+        StrView v = {data + f.start, (int64_t)f.len};
+        any_value = true;
+        int64_t iv; double fv; bool bv;
+        if (can_int && !parse_int_text(v, &iv)) can_int = false;
+        if (can_float && !parse_float_text(v, &fv)) can_float = false;
+        if (can_bool && !parse_bool_text(v, &bv)) can_bool = false;
+    }
+    if (!any_value) return COL_STRING;
+    if (can_int) return COL_INT;
+    if (can_float) return COL_FLOAT;
+    if (can_bool) return COL_BOOL;
+    return COL_STRING;
+}
+
+// Menor tipo que representa valores de `a` e de `b`
+static ColumnType column_type_join(ColumnType a, ColumnType b) {
+    if (a == b) return a;
+    if ((a == COL_INT && b == COL_FLOAT) || (a == COL_FLOAT && b == COL_INT)) return COL_FLOAT;
+    return COL_STRING;
+}
+
+// Converte a coluna para um tipo mais largo (Int -> Float, qualquer -> String);
+// valores já convertidos são re-formatados como texto em `strings`.
+static void column_convert(Column* col, ColumnType target, StringStore* strings) {
+    if (col->type == target) return;
+
+    Column wide;
+    column_init(&wide, col->name, target, col->capacity);
+    if (target == COL_STRING) wide.store = store_retain(strings);
+    char buf[64];
+    for (int64_t r = 0; r < col->length; r++) {
+        if (!column_is_valid(col, r)) { column_append_null(&wide); continue; }
+        if (target == COL_FLOAT) {
+            column_append_float(&wide, (double)col->as.ints[r]);
+        } else {
+            StrView v = column_format(col, r, buf, sizeof(buf));
+            column_append_string(&wide, v.ptr, v.len);
+        }
+    }
+    column_free(col);
+    *col = wide;
+}
+
+// Alarga a coluna quando um valor fora da amostra não cabe no tipo inferido:
+// Int -> Float se `text` for numérico, senão qualquer tipo -> String.
+static void column_widen(Column* col, StrView text, StringStore* strings) {
+    double fv;
+    ColumnType target = (col->type == COL_INT && parse_float_text(text, &fv)) ? COL_FLOAT : COL_STRING;
+    column_convert(col, target, strings);
+}
+
+// Acrescenta todas as linhas de `src` ao fim de `dst` (mesmo tipo). Views de
+// String são copiadas como estão: o store de `src` precisa continuar vivo.
+static void column_append_column(Column* dst, const Column* src) {
+    size_t size = column_value_size(dst->type);
+    column_reserve(dst, dst->length + src->length);
+    memcpy((char*)dst->as.raw + (size_t)dst->length * size, src->as.raw, (size_t)src->length * size);
+    for (int64_t r = 0; r < src->length; r++) {
+        column_set_valid(dst, dst->length + r, column_is_valid(src, r));
+    }
+    dst->length += src->length;
+}
+
+// Converte o campo `f` de `data` uma única vez para o tipo da coluna.
+// Strings viram views para o mapeamento (cópia em `strings` apenas se houver
+// ""); campos vazios viram null em colunas não-String.
+static void column_append_field(Column* col, const char* data, FieldSpan f, StringStore* strings) {
+    StrView v = {data + f.start, (int64_t)f.len};
+    if (v.len == 0 && col->type != COL_STRING) {
+        column_append_null(col);
+        return;
+    }
+    for (;;) {
+        int64_t iv; double fv; bool bv;
+        switch (col->type) {
+            case COL_INT:
+                if (parse_int_text(v, &iv)) { column_append_int(col, iv); return; }
+                break;
+            case COL_FLOAT:
+                if (parse_float_text(v, &fv)) { column_append_float(col, fv); return; }
+                break;
+            case COL_BOOL:
+                if (parse_bool_text(v, &bv)) { column_append_bool(col, bv); return; }
+                break;
+            case COL_STRING:
+                if (f.escaped) v = csv_unescape(strings, data, f);
+                column_append_view(col, v.ptr, v.len);
+                return;
+        }
+        column_widen(col, v, strings);
+    }
+}
+
+static void column_append_record(Column* columns, int64_t col_count, const char* data,
+                                 const CsvRecord* rec, StringStore* strings) {
+    // Campos faltantes viram null; excedentes são descartados
+    for (int64_t c = 0; c < col_count; c++) {
+        if (c < rec->count) column_append_field(&columns[c], data, rec->fields[c], strings);
+        else column_append_null(&columns[c]);
     }
-    fields[(*count)++] = strdup(field);
-    
-    return fields;
+}
+
+// ==================== CARGA PARALELA ====================
+
+// Abaixo deste tamanho (restante após a amostra) a carga é sequencial
+#define PARALLEL_MIN_CHUNK_BYTES (1 << 20)
+#define PARALLEL_MAX_THREADS 64
+
+// Intervalo [start, end) do arquivo processado por uma thread
+typedef struct {
+    const char* data;
+    size_t start;
+    size_t end;
+    size_t quotes;           // fase 1: aspas no intervalo nominal
+    Column* columns;         // fase 2: colunas do pedaço (esquema do DataFrame)
+    int64_t col_count;
+    StringStore* strings;    // cópias materializadas por este pedaço
+    int64_t rows;
+    int64_t* bad_rows;       // registros com número de campos inesperado
+    int* bad_counts;
+    int64_t bad_total;
+    int64_t bad_capacity;
+} CsvChunk;
+
+static int csv_thread_count(void) {
+    const char* env = getenv("DATALANG_THREADS");
+    long n = (env && *env) ? strtol(env, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > PARALLEL_MAX_THREADS) n = PARALLEL_MAX_THREADS;
+    return (int)n;
+}
+
+// Analisa todos os registros de [chunk->start, chunk->end) para chunk->columns
+static void csv_parse_range(CsvChunk* chunk) {
+    CsvRecord rec = {0};
+    CsvScanner* sc = (CsvScanner*)xrealloc(NULL, sizeof(CsvScanner));
+    csv_scanner_init(sc, chunk->data, chunk->start, chunk->end);
+    size_t pos = chunk->start;
+    while (pos < chunk->end) {
+        csv_scan_record(sc, &pos, &rec);
+        if (csv_record_is_blank(&rec)) continue; // Pula linhas vazias
+
+        if (rec.count != chunk->col_count) {
+            if (chunk->bad_total >= chunk->bad_capacity) {
+                chunk->bad_capacity = chunk->bad_capacity ? chunk->bad_capacity * 2 : 16;
+                chunk->bad_rows = (int64_t*)xrealloc(chunk->bad_rows, chunk->bad_capacity * sizeof(int64_t));
+                chunk->bad_counts = (int*)xrealloc(chunk->bad_counts, chunk->bad_capacity * sizeof(int));
+            }
+            chunk->bad_rows[chunk->bad_total] = chunk->rows;
+            chunk->bad_counts[chunk->bad_total++] = rec.count;
+        }
+        column_append_record(chunk->columns, chunk->col_count, chunk->data, &rec, chunk->strings);
+        chunk->rows++;
+    }
+    free(rec.fields);
+    free(sc);
+}
+
+static void* csv_count_quotes_worker(void* arg) {
+    CsvChunk* chunk = (CsvChunk*)arg;
+    const char* p = chunk->data + chunk->start;
+    const char* end = chunk->data + chunk->end;
+    size_t quotes = 0;
+    while (p < end && (p = memchr(p, '"', (size_t)(end - p))) != NULL) {
+        quotes++;
+        p++;
+    }
+    chunk->quotes = quotes;
+    return NULL;
+}
+
+static void* csv_parse_chunk_worker(void* arg) {
+    csv_parse_range((CsvChunk*)arg);
+    return NULL;
+}
+
+// Primeiro início de registro a partir de `pos`, sabendo se `pos` está entre aspas
+static size_t csv_next_record_start(const char* data, size_t pos, size_t end, bool in_quotes) {
+    for (size_t i = pos; i < end; i++) {
+        if (data[i] == '"') in_quotes = !in_quotes;
+        else if (data[i] == '\n' && !in_quotes) return i + 1;
+    }
+    return end;
+}
+
+static void csv_run_workers(CsvChunk* chunks, int count, void* (*worker)(void*)) {
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    bool started[PARALLEL_MAX_THREADS] = {false};
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, worker, &chunks[i]) == 0;
+    }
+    worker(&chunks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else worker(&chunks[i]);  // sem thread disponível: processa aqui mesmo
+    }
+}
+
+// Carrega os registros de [pos, size) em paralelo. O intervalo é dividido em
+// pedaços de mesmo tamanho; a paridade de aspas de cada pedaço (fase 1) diz se
+// a fronteira nominal cai dentro de um campo entre aspas, e cada fronteira é
+// avançada até o próximo fim de registro real. Cada thread converte seu pedaço
+// em colunas próprias (fase 2), que são costuradas em ordem ao final.
+// Retorna false se o arquivo for pequeno demais para compensar as threads.
+static bool csv_load_parallel(DataFrame* df, StringStore* source, size_t pos, int line_num) {
+    size_t size = source->map_size;
+    int threads = csv_thread_count();
+    size_t remaining = size - pos;
+    if ((size_t)threads > remaining / PARALLEL_MIN_CHUNK_BYTES) {
+        threads = (int)(remaining / PARALLEL_MIN_CHUNK_BYTES);
+    }
+    if (threads < 2) return false;
+
+    CsvChunk* chunks = (CsvChunk*)calloc(threads, sizeof(CsvChunk));
+    for (int i = 0; i < threads; i++) {
+        chunks[i].data = source->map;
+        chunks[i].start = pos + remaining * (size_t)i / (size_t)threads;
+        chunks[i].end = pos + remaining * (size_t)(i + 1) / (size_t)threads;
+    }
+
+    // Fase 1: paridade de aspas por pedaço -> estado na fronteira -> início real
+    csv_run_workers(chunks, threads, csv_count_quotes_worker);
+    size_t quotes_before = 0;
+    size_t starts[PARALLEL_MAX_THREADS + 1];
+    starts[0] = pos;
+    for (int i = 1; i < threads; i++) {
+        quotes_before += chunks[i - 1].quotes;
+        size_t start = csv_next_record_start(source->map, chunks[i].start, size, quotes_before % 2 == 1);
+        starts[i] = start > starts[i - 1] ? start : starts[i - 1];
+    }
+    starts[threads] = size;
+
+    // Fase 2: cada pedaço em colunas próprias, com o esquema já inferido
+    for (int i = 0; i < threads; i++) {
+        CsvChunk* chunk = &chunks[i];
+        chunk->start = starts[i];
+        chunk->end = starts[i + 1];
+        chunk->col_count = df->col_count;
+        chunk->strings = store_create();
+        chunk->columns = (Column*)calloc(df->col_count > 0 ? df->col_count : 1, sizeof(Column));
+        for (int64_t c = 0; c < df->col_count; c++) {
+            column_init(&chunk->columns[c], df->columns[c].name, df->columns[c].type, 1024);
+            if (df->columns[c].type == COL_STRING) chunk->columns[c].store = store_retain(chunk->strings);
+        }
+    }
+    csv_run_workers(chunks, threads, csv_parse_chunk_worker);
+
+    // Costura: tipo final = junção dos tipos de todos os pedaços
+    for (int64_t c = 0; c < df->col_count; c++) {
+        ColumnType type = df->columns[c].type;
+        for (int i = 0; i < threads; i++) type = column_type_join(type, chunks[i].columns[c].type);
+        column_convert(&df->columns[c], type, source);
+        for (int i = 0; i < threads; i++) {
+            column_convert(&chunks[i].columns[c], type, chunks[i].strings);
+            column_append_column(&df->columns[c], &chunks[i].columns[c]);
+        }
+    }
+
+    for (int i = 0; i < threads; i++) {
+        CsvChunk* chunk = &chunks[i];
+        for (int64_t b = 0; b < chunk->bad_total; b++) {
+            fprintf(stderr, "Aviso: Linha %ld tem %d campos, esperado %ld\n",
+                    (long)(line_num + chunk->bad_rows[b]), chunk->bad_counts[b], df->col_count);
+        }
+        line_num += (int)chunk->rows;
+        df->row_count += chunk->rows;
+
+        for (int64_t c = 0; c < df->col_count; c++) column_free(&chunk->columns[c]);
+        free(chunk->columns);
+        free(chunk->bad_rows);
+        free(chunk->bad_counts);
+        store_absorb(source, chunk->strings);  // views costuradas apontam para estes blocos
+    }
+    free(chunks);
+    return true;
+}
+
+// ==================== DATAFRAME HELPERS ====================
+
+static DataFrame* df_alloc(int64_t col_count, const char* source) {
+    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
+    df->id = ++df_counter;
+    df->col_count = col_count;
+    df->row_count = 0;
+    df->columns = (Column*)calloc(col_count > 0 ? col_count : 1, sizeof(Column));
+    df->source_file = strdup(source);
+    return df;
+}
+
+// Linha física (índice nas colunas) da linha lógica `r`
+static inline int64_t df_row(const DataFrame* df, int64_t r) {
+    return df->selection ? df->selection[r] : r;
+}
+
+// Visão sobre `src` com as linhas físicas `rows[0..n)` (assume a posse de
+// `rows`). Visões de visões apontam direto para o DataFrame materializado, então
+// filtros encadeados só compõem listas de índices.
+static DataFrame* df_view(DataFrame* src, int64_t* rows, int64_t n, const char* source) {
+    DataFrame* parent = src->parent ? src->parent : src;
+    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
+    df->id = ++df_counter;
+    df->source_file = strdup(source);
+    df->row_count = n;
+    df->col_count = parent->col_count;
+    df->columns = parent->columns;
+    df->parent = parent;
+    df->selection = (int64_t*)xrealloc(rows, (n > 0 ? n : 1) * sizeof(int64_t));
+    return df;
 }
 
 // ==================== LOAD CSV ====================
 
 void* datalang_load(char* path) {
     printf("[Runtime] Carregando DataFrame de: %s\n", path);
-    
+
     // Verifica se arquivo existe
     if (!file_exists(path)) {
         fprintf(stderr, "Erro: Arquivo '%s' não encontrado\n", path);
         exit(1);
     }
-    
-    FILE* file = fopen(path, "r");
-    if (!file) {
+
+    // O arquivo é mapeado uma vez; colunas String guardam views para ele
+    StringStore* source = csv_map_file(path);
+    if (!source) {
         fprintf(stderr, "Erro: Não foi possível abrir o arquivo '%s'\n", path);
         exit(1);
     }
-    
-    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
-    df->id = 1;
-    df->source_file = strdup(path);
-    
-    char line[4096];
-    int line_num = 0;
-    int row_capacity = 100;
-    
+    const char* data = source->map;
+    size_t size = source->map_size;
+    size_t pos = 0;
+    if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) pos = 3;  // BOM UTF-8
+
     // Lê primeira linha (header)
-    if (fgets(line, sizeof(line), file)) {
-        int col_count;
-        df->column_names = parse_csv_line(line, &col_count);
-        df->col_count = col_count;
-        printf("[Runtime] Colunas detectadas: %ld\n", df->col_count);
-        for (int i = 0; i < df->col_count; i++) {
-            printf("  - %s\n", df->column_names[i]);
-        }
-        line_num++;
-    } else {
+    if (pos >= size) {
         fprintf(stderr, "Erro: Arquivo CSV vazio\n");
-        fclose(file);
-        free(df);
+        store_release(source);
         return NULL;
     }
-    
-    // Aloca array de dados
-    df->data = malloc(row_capacity * sizeof(char**));
-    df->row_count = 0;
-    
-    // Lê linhas de dados
-    while (fgets(line, sizeof(line), file)) {
-        if (strlen(trim_whitespace(line)) == 0) continue; // Pula linhas vazias
-        
-        int field_count;
-        char** fields = parse_csv_line(line, &field_count);
-        
-        if (field_count != df->col_count) {
-            fprintf(stderr, "Aviso: Linha %d tem %d campos, esperado %ld\n", 
-                    line_num, field_count, df->col_count);
-        }
-        
-        if (df->row_count >= row_capacity) {
-            row_capacity *= 2;
-            df->data = realloc(df->data, row_capacity * sizeof(char**));
-        }
-        
-        df->data[df->row_count++] = fields;
+    csv_select_kernel();
+    CsvScanner* sc = (CsvScanner*)xrealloc(NULL, sizeof(CsvScanner));
+    csv_scanner_init(sc, data, pos, size);
+    CsvRecord rec = {0};
+    csv_scan_record(sc, &pos, &rec);
+    DataFrame* df = df_alloc(rec.count, path);
+    for (int i = 0; i < rec.count; i++) {
+        FieldSpan f = rec.fields[i];
+        StrView name = f.escaped ? csv_unescape(source, data, f) : (StrView){data + f.start, (int64_t)f.len};
+        df->columns[i].name = strndup(name.ptr, (size_t)name.len);
+    }
+    int line_num = 1;
+
+    // Amostra as primeiras linhas para inferir o esquema, depois converte
+    // cada campo uma única vez direto para a coluna tipada
+    int64_t sample_limit = infer_sample_rows();
+    int64_t sample_capacity = 64;
+    int64_t sample_rows = 0;
+    CsvRecord* sample = (CsvRecord*)malloc(sample_capacity * sizeof(CsvRecord));
+    bool schema_ready = false;
+
+    while (!schema_ready) {
+        bool has_record = pos < size;
+
+        if (!has_record || sample_rows >= sample_limit) {
+            for (int64_t c = 0; c < df->col_count; c++) {
+                char* name = df->columns[c].name;
+                ColumnType type = infer_column_type(data, sample, sample_rows, c);
+                column_init(&df->columns[c], name, type, sample_rows > 0 ? sample_rows : 16);
+                if (type == COL_STRING) df->columns[c].store = store_retain(source);
+                free(name);
+            }
+            for (int64_t r = 0; r < sample_rows; r++) {
+                column_append_record(df->columns, df->col_count, data, &sample[r], source);
+                free(sample[r].fields);
+            }
+            free(sample);
+            schema_ready = true;
+            break;
+        }
+
+        csv_scan_record(sc, &pos, &rec);
+        if (csv_record_is_blank(&rec)) continue; // Pula linhas vazias
+
+        if (rec.count != df->col_count) {
+            fprintf(stderr, "Aviso: Linha %d tem %d campos, esperado %ld\n",
+                    line_num, rec.count, df->col_count);
+        }
+        df->row_count++;
         line_num++;
+
+        if (sample_rows >= sample_capacity) {
+            sample_capacity *= 2;
+            sample = (CsvRecord*)xrealloc(sample, sample_capacity * sizeof(CsvRecord));
+        }
+        sample[sample_rows++] = rec;
+        rec = (CsvRecord){0};
     }
-    
-    fclose(file);
-    
-    printf("[Runtime] DataFrame carregado: %ld linhas x %ld colunas\n", 
+
+    free(sc);
+
+    // Restante do arquivo: em paralelo quando grande o bastante
+    if (pos < size && !csv_load_parallel(df, source, pos, line_num)) {
+        CsvChunk rest = {0};
+        rest.data = data;
+        rest.start = pos;
+        rest.end = size;
+        rest.columns = df->columns;
+        rest.col_count = df->col_count;
+        rest.strings = source;
+        csv_parse_range(&rest);
+        for (int64_t b = 0; b < rest.bad_total; b++) {
+            fprintf(stderr, "Aviso: Linha %ld tem %d campos, esperado %ld\n",
+                    (long)(line_num + rest.bad_rows[b]), rest.bad_counts[b], df->col_count);
+        }
+        df->row_count += rest.rows;
+        free(rest.bad_rows);
+        free(rest.bad_counts);
+    }
+
+    free(rec.fields);
+    store_release(source);  // continua vivo enquanto alguma coluna String o referenciar
+
+    printf("[Runtime] Colunas detectadas: %ld\n", df->col_count);
+    for (int64_t c = 0; c < df->col_count; c++) {
+        printf("  - %s: %s\n", df->columns[c].name, column_type_name(df->columns[c].type));
+    }
+
+    printf("[Runtime] DataFrame carregado: %ld linhas x %ld colunas\n",
            df->row_count, df->col_count);
-    
+
     return (void*)df;
 }
 
@@ -225,47 +1192,55 @@ void datalang_save(void* df_ptr, char* path) {
         // Sem DataFrame real (ex.: select/groupby em arrays) – operação vira no-op
         return;
     }
-    
+
     DataFrame* df = (DataFrame*)df_ptr;
     printf("[Runtime] Salvando DataFrame (id=%ld) em: %s\n", df->id, path);
-    
+
     FILE* file = fopen(path, "w");
     if (!file) {
         fprintf(stderr, "Erro: Não foi possível criar o arquivo '%s'\n", path);
         return;
     }
-    
+
     // Escreve header
     for (int64_t i = 0; i < df->col_count; i++) {
-        fprintf(file, "%s", df->column_names[i]);
+        fprintf(file, "%s", df->columns[i].name);
         if (i < df->col_count - 1) fprintf(file, ",");
     }
     fprintf(file, "\n");
-    
+
     // Escreve dados
+    char buf[64];
     for (int64_t row = 0; row < df->row_count; row++) {
         for (int64_t col = 0; col < df->col_count; col++) {
-            // Escapa campos com vírgulas ou aspas
-            char* value = df->data[row][col];
-            bool needs_quotes = (strchr(value, ',') != NULL || strchr(value, '"') != NULL);
-            
-            if (needs_quotes) {
-                fprintf(file, "\"");
+            const Column* column = &df->columns[col];
+            StrView value = column_format(column, df_row(df, row), buf, sizeof(buf));
+
+            // null em coluna String (ex.: coluna inexistente no select) é
+            // gravado como `null`, como sempre foi; nas demais colunas o null
+            // veio de um campo vazio no CSV e volta vazio
+            if (!value.ptr && column->type == COL_STRING) value = (StrView){"null", 4};
+
+            // Apenas Strings podem precisar de escape
+            if (value.ptr && column->type == COL_STRING &&
+                (memchr(value.ptr, ',', (size_t)value.len) || memchr(value.ptr, '"', (size_t)value.len) ||
+                 memchr(value.ptr, '\n', (size_t)value.len))) {
+                fputc('"', file);
                 // Escapa aspas internas
-                for (char* p = value; *p; p++) {
-                    if (*p == '"') fprintf(file, "\"\"");
-                    else fputc(*p, file);
+                for (int64_t i = 0; i < value.len; i++) {
+                    if (value.ptr[i] == '"') fputs("\"\"", file);
+                    else fputc(value.ptr[i], file);
                 }
-                fprintf(file, "\"");
-            } else {
-                fprintf(file, "%s", value);
+                fputc('"', file);
+            } else if (value.ptr) {
+                fwrite(value.ptr, 1, (size_t)value.len, file);
             }
-            
+
             if (col < df->col_count - 1) fprintf(file, ",");
         }
         fprintf(file, "\n");
     }
-    
+
     fclose(file);
     printf("[Runtime] DataFrame salvo com sucesso: %ld linhas\n", df->row_count);
 }
@@ -276,51 +1251,147 @@ void* datalang_select(void* df_ptr, int32_t column_count, ...) {
     if (!df_ptr) return NULL;
     DataFrame* src = (DataFrame*)df_ptr;
 
-    int* col_indices = (int*)calloc(column_count, sizeof(int));
-    char** col_names = (char**)calloc(column_count, sizeof(char*));
+    DataFrame* df = df_alloc(column_count, "select(runtime)");
+    df->row_count = src->row_count;
 
     va_list args;
     va_start(args, column_count);
     for (int32_t i = 0; i < column_count; i++) {
         char* col = va_arg(args, char*);
-        col_names[i] = strdup_or_null(col);
-        col_indices[i] = find_column_index(src, col);
+        int idx = find_column_index(src, col);
+        if (idx >= 0) {
+            column_gather(&df->columns[i], &src->columns[idx], src->selection, src->row_count);
+            free(df->columns[i].name);
+            df->columns[i].name = strdup(col);
+        } else {
+            // Coluna inexistente: coluna String toda null
+            column_init(&df->columns[i], col, COL_STRING, src->row_count);
+            for (int64_t r = 0; r < src->row_count; r++) column_append_null(&df->columns[i]);
+        }
     }
     va_end(args);
 
-    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
-    df->id = ++df_counter;
-    df->row_count = src->row_count;
-    df->col_count = column_count;
-    df->column_names = (char**)calloc(column_count, sizeof(char*));
-    df->data = (char***)calloc(df->row_count, sizeof(char**));
+    return (void*)df;
+}
 
-    for (int32_t i = 0; i < column_count; i++) {
-        df->column_names[i] = strdup_or_null(col_names[i]);
+// ==================== GROUPBY (HASH) ====================
+
+static inline uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t hash_bytes(const char* p, int64_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL;  // FNV-1a
+    for (int64_t i = 0; i < len; i++) {
+        h ^= (unsigned char)p[i];
+        h *= 0x100000001b3ULL;
     }
+    return h;
+}
 
-    for (int64_t r = 0; r < df->row_count; r++) {
-        df->data[r] = (char**)calloc(column_count, sizeof(char*));
-        for (int32_t c = 0; c < column_count; c++) {
-            int idx = col_indices[c];
-            if (idx >= 0 && idx < src->col_count) {
-                df->data[r][c] = strdup_or_null(src->data[r][idx]);
-            } else {
-                df->data[r][c] = strdup("null");
-            }
+static uint64_t column_cell_hash(const Column* col, int64_t row) {
+    if (!column_is_valid(col, row)) return 0x9e3779b97f4a7c15ULL;
+    switch (col->type) {
+        case COL_INT: return hash_mix((uint64_t)col->as.ints[row]);
+        case COL_FLOAT: {
+            double v = col->as.floats[row];
+            if (v == 0.0) v = 0.0;  // -0.0 e 0.0 caem no mesmo grupo
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            return hash_mix(bits);
+        }
+        case COL_BOOL: return hash_mix(col->as.bools[row] + 1);
+        case COL_STRING: return hash_mix(hash_bytes(col->as.strings[row].ptr, col->as.strings[row].len));
+    }
+    return 0;
+}
+
+// Agrupa as linhas de `src` pelas colunas `key_idx` (índices < 0 são colunas
+// inexistentes, tratadas como constantes). Os hashes de linha são calculados
+// coluna a coluna antes da busca; a tabela usa endereçamento aberto com
+// sondagem linear, cresce conforme o número de grupos (não de linhas) e só
+// compara chaves quando os hashes coincidem. Devolve a primeira linha física de
+// cada grupo, na ordem de aparição; se `row_groups` não for NULL, preenche o
+// grupo de cada linha lógica.
+static int64_t group_rows(DataFrame* src, const int* key_idx, int key_count,
+                          int64_t** first_rows_out, int64_t* row_groups) {
+    int64_t rows = src->row_count;
+    uint64_t* hashes = (uint64_t*)calloc(rows > 0 ? rows : 1, sizeof(uint64_t));
+    for (int k = 0; k < key_count; k++) {
+        if (key_idx[k] < 0) continue;
+        const Column* col = &src->columns[key_idx[k]];
+        for (int64_t r = 0; r < rows; r++) {
+            uint64_t cell = column_cell_hash(col, df_row(src, r));
+            hashes[r] = hash_mix(hashes[r] ^ (cell + 0x9e3779b97f4a7c15ULL + (hashes[r] << 6)));
         }
     }
 
-    for (int i = 0; i < column_count; i++) free(col_names[i]);
-    free(col_names);
-    free(col_indices);
+    int64_t capacity = 1024;
+    int64_t* slots = (int64_t*)malloc(capacity * sizeof(int64_t));  // grupo ou -1
+    for (int64_t i = 0; i < capacity; i++) slots[i] = -1;
+
+    int64_t group_capacity = 64;
+    int64_t group_total = 0;
+    int64_t* first_rows = (int64_t*)malloc(group_capacity * sizeof(int64_t));
+    uint64_t mask = (uint64_t)capacity - 1;
+
+    for (int64_t r = 0; r < rows; r++) {
+        uint64_t h = hashes[r];
+        uint64_t slot = h & mask;
+        for (;;) {
+            int64_t g = slots[slot];
+            if (g < 0) {
+                if (group_total >= group_capacity) {
+                    group_capacity *= 2;
+                    first_rows = (int64_t*)xrealloc(first_rows, group_capacity * sizeof(int64_t));
+                }
+                first_rows[group_total] = r;
+                slots[slot] = group_total++;
+                if (group_total * 2 > capacity) {
+                    // Fator de carga > 0.5: dobra a tabela reaproveitando os hashes
+                    capacity *= 2;
+                    mask = (uint64_t)capacity - 1;
+                    slots = (int64_t*)xrealloc(slots, capacity * sizeof(int64_t));
+                    for (int64_t i = 0; i < capacity; i++) slots[i] = -1;
+                    for (int64_t i = 0; i < group_total; i++) {
+                        uint64_t s2 = hashes[first_rows[i]] & mask;
+                        while (slots[s2] >= 0) s2 = (s2 + 1) & mask;
+                        slots[s2] = i;
+                    }
+                }
+                g = group_total - 1;
+                if (row_groups) row_groups[r] = g;
+                break;
+            }
+            int64_t rep = first_rows[g];
+            if (hashes[rep] == h) {
+                bool all_eq = true;
+                for (int k = 0; k < key_count && all_eq; k++) {
+                    if (key_idx[k] < 0) continue;
+                    const Column* col = &src->columns[key_idx[k]];
+                    all_eq = column_cells_equal(col, df_row(src, r), col, df_row(src, rep));
+                }
+                if (all_eq) {
+                    if (row_groups) row_groups[r] = g;
+                    break;
+                }
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
 
-    df->source_file = strdup("select(runtime)");
-    return (void*)df;
+    free(slots);
+    free(hashes);
+    for (int64_t g = 0; g < group_total; g++) first_rows[g] = df_row(src, first_rows[g]);
+    *first_rows_out = first_rows;
+    return group_total;
 }
 
-// ==================== GROUPBY (DISTINCT) ====================
-
 void* datalang_groupby(void* df_ptr, int32_t group_count, ...) {
     if (!df_ptr) return NULL;
     DataFrame* src = (DataFrame*)df_ptr;
@@ -337,52 +1408,432 @@ void* datalang_groupby(void* df_ptr, int32_t group_count, ...) {
     }
     va_end(args);
 
-    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
-    df->id = ++df_counter;
-    df->col_count = group_count;
-    df->column_names = (char**)calloc(group_count, sizeof(char*));
-    for (int32_t i = 0; i < group_count; i++) {
-        df->column_names[i] = strdup_or_null(group_cols[i]);
+    int64_t* first_rows = NULL;
+    int64_t group_total = group_rows(src, group_idx, group_count, &first_rows, NULL);
+
+    DataFrame* df = df_alloc(group_count, "groupby(runtime)");
+    df->row_count = group_total;
+    for (int32_t k = 0; k < group_count; k++) {
+        int idx = group_idx[k];
+        if (idx >= 0) {
+            column_gather(&df->columns[k], &src->columns[idx], first_rows, group_total);
+        } else {
+            column_init(&df->columns[k], group_cols[k], COL_STRING, group_total);
+            for (int64_t g = 0; g < group_total; g++) column_append_null(&df->columns[k]);
+        }
     }
 
-    df->data = NULL;
-    df->row_count = 0;
+    for (int i = 0; i < group_count; i++) free(group_cols[i]);
+    free(group_cols);
+    free(group_idx);
+    free(first_rows);
+    return (void*)df;
+}
 
-    // Naive distinct
-    for (int64_t r = 0; r < src->row_count; r++) {
-        bool exists = false;
-        for (int64_t dr = 0; dr < df->row_count; dr++) {
-            bool all_eq = true;
-            for (int32_t g = 0; g < group_count; g++) {
-                int idx = group_idx[g];
-                const char* v_src = (idx >= 0) ? src->data[r][idx] : "null";
-                const char* v_dst = df->data[dr][g];
-                if (strcmp(v_src ? v_src : "null", v_dst ? v_dst : "null") != 0) {
-                    all_eq = false;
-                    break;
-                }
+// ==================== GROUPBY + AGREGAÇÃO ====================
+
+// agg: 0 sum, 1 mean, 2 count, 3 min, 4 max
+static const char* agg_name(int32_t agg) {
+    switch (agg) {
+        case 0: return "sum";
+        case 1: return "mean";
+        case 2: return "count";
+        case 3: return "min";
+        case 4: return "max";
+    }
+    return "agg";
+}
+
+// Agrega `src` por grupo em uma única passada (count com `src` NULL conta as
+// linhas). Int continua Int em sum/min/max; mean e demais tipos
+// viram Float. Grupos sem valores válidos ficam null (count fica 0).
+static void aggregate_column(Column* dst, const char* name, const Column* src, int32_t agg,
+                             const int64_t* selection, const int64_t* row_groups, int64_t rows,
+                             int64_t group_total) {
+    int64_t* counts = (int64_t*)calloc(group_total > 0 ? group_total : 1, sizeof(int64_t));
+
+    if (agg == 2) {
+        for (int64_t r = 0; r < rows; r++) {
+            if (!src || column_is_valid(src, selection ? selection[r] : r)) counts[row_groups[r]]++;
+        }
+        column_init(dst, name, COL_INT, group_total);
+        for (int64_t g = 0; g < group_total; g++) column_append_int(dst, counts[g]);
+        free(counts);
+        return;
+    }
+
+    if (src->type == COL_INT && agg != 1) {
+        int64_t* acc = (int64_t*)calloc(group_total > 0 ? group_total : 1, sizeof(int64_t));
+        const int64_t* values = src->as.ints;
+        for (int64_t r = 0; r < rows; r++) {
+            int64_t phys = selection ? selection[r] : r;
+            if (!column_is_valid(src, phys)) continue;
+            int64_t g = row_groups[r];
+            int64_t v = values[phys];
+            if (counts[g]++ == 0) { acc[g] = v; continue; }
+            switch (agg) {
+                case 0: acc[g] += v; break;
+                case 3: if (v < acc[g]) acc[g] = v; break;
+                case 4: if (v > acc[g]) acc[g] = v; break;
             }
-            if (all_eq) { exists = true; break; }
         }
-        if (exists) continue;
+        column_init(dst, name, COL_INT, group_total);
+        for (int64_t g = 0; g < group_total; g++) {
+            if (counts[g] > 0) column_append_int(dst, acc[g]);
+            else column_append_null(dst);
+        }
+        free(acc);
+        free(counts);
+        return;
+    }
 
-        df->data = (char***)realloc(df->data, (df->row_count + 1) * sizeof(char**));
-        df->data[df->row_count] = (char**)calloc(group_count, sizeof(char*));
-        for (int32_t g = 0; g < group_count; g++) {
-            int idx = group_idx[g];
-            const char* v = (idx >= 0) ? src->data[r][idx] : "null";
-            df->data[df->row_count][g] = strdup_or_null(v);
+    double* acc = (double*)calloc(group_total > 0 ? group_total : 1, sizeof(double));
+    for (int64_t r = 0; r < rows; r++) {
+        double v;
+        if (!column_get_double(src, selection ? selection[r] : r, &v)) continue;
+        int64_t g = row_groups[r];
+        if (counts[g]++ == 0) { acc[g] = v; continue; }
+        switch (agg) {
+            case 0:
+            case 1: acc[g] += v; break;
+            case 3: if (v < acc[g]) acc[g] = v; break;
+            case 4: if (v > acc[g]) acc[g] = v; break;
         }
-        df->row_count++;
     }
+    column_init(dst, name, COL_FLOAT, group_total);
+    for (int64_t g = 0; g < group_total; g++) {
+        if (counts[g] == 0) column_append_null(dst);
+        else column_append_float(dst, agg == 1 ? acc[g] / (double)counts[g] : acc[g]);
+    }
+    free(acc);
+    free(counts);
+}
 
-    for (int i = 0; i < group_count; i++) free(group_cols[i]);
-    free(group_cols);
-    free(group_idx);
-    df->source_file = strdup("groupby(runtime)");
+// groupby(chaves) |> agg(valores): chaves seguidas das colunas de valor nos
+// argumentos variádicos. Sem colunas de valor, count conta as linhas e as
+// demais agregações usam todas as colunas numéricas que não são chave.
+void* datalang_groupby_agg(void* df_ptr, int32_t agg, int32_t key_count, int32_t value_count, ...) {
+    if (!df_ptr) return NULL;
+    DataFrame* src = (DataFrame*)df_ptr;
+
+    int* key_idx = (int*)calloc(key_count > 0 ? key_count : 1, sizeof(int));
+    char** key_cols = (char**)calloc(key_count > 0 ? key_count : 1, sizeof(char*));
+    int* value_idx = (int*)calloc(value_count > 0 ? value_count : 1, sizeof(int));
+    char** value_cols = (char**)calloc(value_count > 0 ? value_count : 1, sizeof(char*));
+
+    va_list args;
+    va_start(args, value_count);
+    for (int32_t i = 0; i < key_count; i++) {
+        char* col = va_arg(args, char*);
+        key_cols[i] = strdup_or_null(col);
+        key_idx[i] = find_column_index(src, col);
+    }
+    for (int32_t i = 0; i < value_count; i++) {
+        char* col = va_arg(args, char*);
+        value_cols[i] = strdup_or_null(col);
+        value_idx[i] = find_column_index(src, col);
+    }
+    va_end(args);
+
+    if (value_count == 0 && agg != 2) {
+        // Sem colunas explícitas: todas as colunas numéricas fora das chaves
+        value_idx = (int*)xrealloc(value_idx, (src->col_count > 0 ? src->col_count : 1) * sizeof(int));
+        value_cols = (char**)xrealloc(value_cols, (src->col_count > 0 ? src->col_count : 1) * sizeof(char*));
+        for (int c = 0; c < src->col_count; c++) {
+            ColumnType t = src->columns[c].type;
+            if (t != COL_INT && t != COL_FLOAT) continue;
+            bool is_key = false;
+            for (int32_t k = 0; k < key_count; k++) is_key |= key_idx[k] == c;
+            if (is_key) continue;
+            value_idx[value_count] = c;
+            value_cols[value_count] = strdup_or_null(src->columns[c].name);
+            value_count++;
+        }
+    }
+
+    int64_t rows = src->row_count;
+    int64_t* row_groups = (int64_t*)malloc((rows > 0 ? rows : 1) * sizeof(int64_t));
+    int64_t* first_rows = NULL;
+    int64_t group_total = group_rows(src, key_idx, key_count, &first_rows, row_groups);
+
+    int out_count = key_count + (value_count > 0 ? value_count : 1);
+    DataFrame* df = df_alloc(out_count, "groupby_agg(runtime)");
+    df->row_count = group_total;
+    for (int32_t k = 0; k < key_count; k++) {
+        if (key_idx[k] >= 0) {
+            column_gather(&df->columns[k], &src->columns[key_idx[k]], first_rows, group_total);
+        } else {
+            column_init(&df->columns[k], key_cols[k], COL_STRING, group_total);
+            for (int64_t g = 0; g < group_total; g++) column_append_null(&df->columns[k]);
+        }
+    }
+    if (value_count == 0) {
+        aggregate_column(&df->columns[key_count], agg_name(agg), NULL, agg,
+                         src->selection, row_groups, rows, group_total);
+    }
+    for (int32_t i = 0; i < value_count; i++) {
+        Column* dst = &df->columns[key_count + i];
+        if (value_idx[i] < 0) {
+            // Coluna inexistente: toda null (count 0)
+            column_init(dst, value_cols[i], agg == 2 ? COL_INT : COL_FLOAT, group_total);
+            for (int64_t g = 0; g < group_total; g++) {
+                if (agg == 2) column_append_int(dst, 0);
+                else column_append_null(dst);
+            }
+            continue;
+        }
+        aggregate_column(dst, value_cols[i], &src->columns[value_idx[i]], agg,
+                         src->selection, row_groups, rows, group_total);
+    }
+
+    for (int32_t i = 0; i < key_count; i++) free(key_cols[i]);
+    for (int32_t i = 0; i < value_count; i++) free(value_cols[i]);
+    free(key_cols);
+    free(key_idx);
+    free(value_cols);
+    free(value_idx);
+    free(row_groups);
+    free(first_rows);
     return (void*)df;
 }
 
+// ==================== FILTER KERNELS (SIMD) ====================
+
+// Kernels de comparação: escrevem 1 bit por linha em `out` (palavras de 64
+// linhas, bit j da palavra w = linha 64*w + j). op: 0 ==, 1 !=, 2 >, 3 >=, 4 <,
+// 5 <= (validado pelo chamador)
+typedef void (*FilterF64Kernel)(const double* values, int64_t n, int op, double thr, uint64_t* out);
+typedef void (*FilterI64Kernel)(const int64_t* values, int64_t n, int op, int64_t thr, uint64_t* out);
+
+// Laço escalar sem desvios por linha: o switch de op fica fora do laço
+#define FILTER_SCALAR_LOOP(EXPR)                                          \
+    for (int64_t base = 0; base < n; base += 64) {                        \
+        int64_t len = n - base < 64 ? n - base : 64;                      \
+        uint64_t word = 0;                                                \
+        for (int64_t j = 0; j < len; j++) {                               \
+            const __typeof__(values[0]) v = values[base + j];             \
+            word |= (uint64_t)(EXPR) << j;                                \
+        }                                                                 \
+        out[base >> 6] = word;                                            \
+    }
+
+static void filter_f64_scalar(const double* values, int64_t n, int op, double thr, uint64_t* out) {
+    switch (op) {
+        case 0: FILTER_SCALAR_LOOP(v == thr) break;
+        case 1: FILTER_SCALAR_LOOP(v != thr) break;
+        case 2: FILTER_SCALAR_LOOP(v >  thr) break;
+        case 3: FILTER_SCALAR_LOOP(v >= thr) break;
+        case 4: FILTER_SCALAR_LOOP(v <  thr) break;
+        case 5: FILTER_SCALAR_LOOP(v <= thr) break;
+    }
+}
+
+static void filter_i64_scalar(const int64_t* values, int64_t n, int op, int64_t thr, uint64_t* out) {
+    switch (op) {
+        case 0: FILTER_SCALAR_LOOP(v == thr) break;
+        case 1: FILTER_SCALAR_LOOP(v != thr) break;
+        case 2: FILTER_SCALAR_LOOP(v >  thr) break;
+        case 3: FILTER_SCALAR_LOOP(v >= thr) break;
+        case 4: FILTER_SCALAR_LOOP(v <  thr) break;
+        case 5: FILTER_SCALAR_LOOP(v <= thr) break;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Blocos completos de 64 linhas no vetor; a cauda vai para o kernel escalar
+#define FILTER_SIMD_LOOP(STEP, CMP_BITS)                                  \
+    for (int64_t base = 0; base < full; base += 64) {                     \
+        uint64_t word = 0;                                                \
+        for (int j = 0; j < 64; j += STEP) {                              \
+            word |= (uint64_t)(CMP_BITS) << j;                            \
+        }                                                                 \
+        out[base >> 6] = word;                                            \
+    }
+
+__attribute__((target("avx2")))
+static void filter_f64_avx2(const double* values, int64_t n, int op, double thr, uint64_t* out) {
+    const __m256d t = _mm256_set1_pd(thr);
+    int64_t full = n & ~(int64_t)63;
+#define F64_AVX2(PRED) \
+    FILTER_SIMD_LOOP(4, (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(values + base + j), t, PRED)))
+    switch (op) {
+        case 0: F64_AVX2(_CMP_EQ_OQ) break;
+        case 1: F64_AVX2(_CMP_NEQ_UQ) break;  // NaN != x é verdadeiro, como em C
+        case 2: F64_AVX2(_CMP_GT_OQ) break;
+        case 3: F64_AVX2(_CMP_GE_OQ) break;
+        case 4: F64_AVX2(_CMP_LT_OQ) break;
+        case 5: F64_AVX2(_CMP_LE_OQ) break;
+    }
+#undef F64_AVX2
+    filter_f64_scalar(values + full, n - full, op, thr, out + (full >> 6));
+}
+
+// AVX2 só tem == e > para int64: os demais saem por troca de operandos/negação
+__attribute__((target("avx2")))
+static void filter_i64_avx2(const int64_t* values, int64_t n, int op, int64_t thr, uint64_t* out) {
+    const __m256i t = _mm256_set1_epi64x(thr);
+    int64_t full = n & ~(int64_t)63;
+#define I64_AVX2(CMP, FLIP) \
+    FILTER_SIMD_LOOP(4, ((unsigned)_mm256_movemask_pd(_mm256_castsi256_pd( \
+        CMP(_mm256_loadu_si256((const __m256i*)(values + base + j))))) ^ (FLIP)))
+#define EQ(v) _mm256_cmpeq_epi64(v, t)
+#define GT(v) _mm256_cmpgt_epi64(v, t)
+#define LT(v) _mm256_cmpgt_epi64(t, v)
+    switch (op) {
+        case 0: I64_AVX2(EQ, 0u) break;
+        case 1: I64_AVX2(EQ, 0xFu) break;
+        case 2: I64_AVX2(GT, 0u) break;
+        case 3: I64_AVX2(LT, 0xFu) break;
+        case 4: I64_AVX2(LT, 0u) break;
+        case 5: I64_AVX2(GT, 0xFu) break;
+    }
+#undef EQ
+#undef GT
+#undef LT
+#undef I64_AVX2
+    filter_i64_scalar(values + full, n - full, op, thr, out + (full >> 6));
+}
+
+__attribute__((target("avx512f")))
+static void filter_f64_avx512(const double* values, int64_t n, int op, double thr, uint64_t* out) {
+    const __m512d t = _mm512_set1_pd(thr);
+    int64_t full = n & ~(int64_t)63;
+#define F64_AVX512(PRED) \
+    FILTER_SIMD_LOOP(8, _mm512_cmp_pd_mask(_mm512_loadu_pd(values + base + j), t, PRED))
+    switch (op) {
+        case 0: F64_AVX512(_CMP_EQ_OQ) break;
+        case 1: F64_AVX512(_CMP_NEQ_UQ) break;
+        case 2: F64_AVX512(_CMP_GT_OQ) break;
+        case 3: F64_AVX512(_CMP_GE_OQ) break;
+        case 4: F64_AVX512(_CMP_LT_OQ) break;
+        case 5: F64_AVX512(_CMP_LE_OQ) break;
+    }
+#undef F64_AVX512
+    filter_f64_scalar(values + full, n - full, op, thr, out + (full >> 6));
+}
+
+__attribute__((target("avx512f")))
+static void filter_i64_avx512(const int64_t* values, int64_t n, int op, int64_t thr, uint64_t* out) {
+    const __m512i t = _mm512_set1_epi64(thr);
+    int64_t full = n & ~(int64_t)63;
+#define I64_AVX512(PRED) \
+    FILTER_SIMD_LOOP(8, _mm512_cmp_epi64_mask(_mm512_loadu_si512((const void*)(values + base + j)), t, PRED))
+    switch (op) {
+        case 0: I64_AVX512(_MM_CMPINT_EQ) break;
+        case 1: I64_AVX512(_MM_CMPINT_NE) break;
+        case 2: I64_AVX512(_MM_CMPINT_NLE) break;
+        case 3: I64_AVX512(_MM_CMPINT_NLT) break;
+        case 4: I64_AVX512(_MM_CMPINT_LT) break;
+        case 5: I64_AVX512(_MM_CMPINT_LE) break;
+    }
+#undef I64_AVX512
+    filter_i64_scalar(values + full, n - full, op, thr, out + (full >> 6));
+}
+#undef FILTER_SIMD_LOOP
+#endif
+#undef FILTER_SCALAR_LOOP
+
+static FilterF64Kernel filter_f64_kernel = filter_f64_scalar;
+static FilterI64Kernel filter_i64_kernel = filter_i64_scalar;
+
+// Escolhe os kernels de filtro pela CPU. DATALANG_SIMD=scalar|avx2|avx512
+// limita o conjunto de instruções (sse2 usa o escalar).
+static void filter_select_kernels(void) {
+    const char* env = getenv("DATALANG_SIMD");
+    filter_f64_kernel = filter_f64_scalar;
+    filter_i64_kernel = filter_i64_scalar;
+    if (env && (strcmp(env, "scalar") == 0 || strcmp(env, "sse2") == 0)) return;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        filter_f64_kernel = filter_f64_avx2;
+        filter_i64_kernel = filter_i64_avx2;
+    }
+    if (env && strcmp(env, "avx2") == 0) return;
+    if (__builtin_cpu_supports("avx512f")) {
+        filter_f64_kernel = filter_f64_avx512;
+        filter_i64_kernel = filter_i64_avx512;
+    }
+#endif
+}
+
+// Traduz `x op thr` (thr double) para uma comparação exata entre inteiros.
+// Retorna 0 se a comparação for necessária, -1 se nenhuma linha passa e 1 se
+// todas passam.
+static int filter_int_threshold(int op, double thr, int* iop, int64_t* k) {
+    *iop = op;
+    if (isnan(thr)) return op == 1 ? 1 : -1;
+    if (thr >= 9223372036854775808.0) {   // acima de INT64_MAX
+        return (op == 1 || op == 4 || op == 5) ? 1 : -1;
+    }
+    if (thr < -9223372036854775808.0) {   // abaixo de INT64_MIN
+        return (op == 1 || op == 2 || op == 3) ? 1 : -1;
+    }
+    double lo = floor(thr), hi = ceil(thr);
+    switch (op) {
+        case 0: if (lo != thr) return -1; *k = (int64_t)lo; break;
+        case 1: if (lo != thr) return 1; *k = (int64_t)lo; break;
+        case 2: *k = (int64_t)lo; break;   // x >  2.5  <=> x >  2
+        case 3: *k = (int64_t)hi; break;   // x >= 2.5  <=> x >= 3
+        case 4: *k = (int64_t)hi; break;   // x <  2.5  <=> x <  3
+        case 5: *k = (int64_t)lo; break;   // x <= 2.5  <=> x <= 2
+    }
+    return 0;
+}
+
+// Palavra `w` do bitmap de validade (linhas 64*w .. 64*w+63)
+static inline uint64_t column_validity_word(const Column* col, int64_t w, int64_t rows) {
+    int64_t first_byte = w * 8;
+    int64_t bytes = (rows + 7) / 8 - first_byte;
+    uint64_t word = 0;
+    if (bytes >= 8) {
+        memcpy(&word, col->validity + first_byte, sizeof(word));
+        return word;
+    }
+    for (int64_t b = 0; b < bytes; b++) word |= (uint64_t)col->validity[first_byte + b] << (8 * b);
+    return word;
+}
+
+// Filtro vetorizado sobre coluna Int/Float contígua: bitmask da comparação
+// AND validade, depois extrai os índices das linhas que passam
+static int64_t filter_column_mask(const Column* col, int64_t rows, int op, double threshold, int64_t** out_rows) {
+    int64_t words = (rows + 63) / 64;
+    uint64_t* mask = (uint64_t*)calloc(words > 0 ? words : 1, sizeof(uint64_t));
+
+    if (col->type == COL_FLOAT) {
+        filter_f64_kernel(col->as.floats, rows, op, threshold, mask);
+    } else {
+        int iop;
+        int64_t k = 0;
+        int constant = filter_int_threshold(op, threshold, &iop, &k);
+        if (constant == 0) {
+            filter_i64_kernel(col->as.ints, rows, iop, k, mask);
+        } else if (constant > 0) {
+            for (int64_t w = 0; w < words; w++) mask[w] = ~(uint64_t)0;
+            if (rows & 63) mask[words - 1] = ((uint64_t)1 << (rows & 63)) - 1;
+        }
+    }
+
+    int64_t kept = 0;
+    for (int64_t w = 0; w < words; w++) {
+        mask[w] &= column_validity_word(col, w, rows);  // null nunca satisfaz o filtro
+        kept += __builtin_popcountll(mask[w]);
+    }
+
+    int64_t* result = (int64_t*)malloc((kept > 0 ? kept : 1) * sizeof(int64_t));
+    int64_t n = 0;
+    for (int64_t w = 0; w < words; w++) {
+        uint64_t bits = mask[w];
+        while (bits) {
+            result[n++] = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+        }
+    }
+    free(mask);
+    *out_rows = result;
+    return kept;
+}
+
 // ==================== FILTER (numeric) ====================
 
 // op: 0 ==, 1 !=, 2 >, 3 >=, 4 <, 5 <=
@@ -392,18 +1843,45 @@ void* datalang_df_filter_numeric(void* df_ptr, char* column, int32_t op, double
     int idx = find_column_index(src, column);
     if (idx < 0) return df_ptr;
 
-    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
-    df->id = ++df_counter;
-    df->col_count = src->col_count;
-    df->column_names = (char**)calloc(df->col_count, sizeof(char*));
-    for (int64_t i = 0; i < df->col_count; i++) df->column_names[i] = strdup_or_null(src->column_names[i]);
+    const Column* col = &src->columns[idx];
+    if (op < 0 || op > 5) {
+        return (void*)df_view(src, (int64_t*)malloc(sizeof(int64_t)), 0, "filter(runtime)");
+    }
+    if (col->type == COL_INT || col->type == COL_FLOAT) {
+        filter_select_kernels();
+        int64_t* rows = NULL;
+        if (!src->selection) {
+            int64_t kept = filter_column_mask(col, src->row_count, op, threshold, &rows);
+            return (void*)df_view(src, rows, kept, "filter(runtime)");
+        }
 
-    df->data = NULL;
-    df->row_count = 0;
+        // Visão (filtros encadeados): junta as linhas selecionadas numa coluna
+        // contígua, roda o mesmo kernel e traduz os índices de volta
+        int64_t n = src->row_count;
+        Column gathered = { .type = col->type };
+        gathered.as.raw = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+        gathered.validity = (uint8_t*)calloc((n + 7) / 8 + 1, 1);
+        for (int64_t r = 0; r < n; r++) {
+            int64_t phys = src->selection[r];
+            if (col->type == COL_FLOAT) gathered.as.floats[r] = col->as.floats[phys];
+            else gathered.as.ints[r] = col->as.ints[phys];
+            if (column_is_valid(col, phys)) column_set_valid(&gathered, r, true);
+        }
+        int64_t kept = filter_column_mask(&gathered, n, op, threshold, &rows);
+        for (int64_t k = 0; k < kept; k++) rows[k] = src->selection[rows[k]];
+        free(gathered.as.raw);
+        free(gathered.validity);
+        return (void*)df_view(src, rows, kept, "filter(runtime)");
+    }
+
+    // Colunas Bool/String: caminho escalar linha a linha
+    int64_t* rows = (int64_t*)malloc(sizeof(int64_t) * (src->row_count > 0 ? src->row_count : 1));
+    int64_t kept = 0;
 
     for (int64_t r = 0; r < src->row_count; r++) {
-        const char* val = src->data[r][idx];
-        double num = val ? strtod(val, NULL) : 0.0;
+        int64_t phys = df_row(src, r);
+        double num;
+        if (!column_get_double(col, phys, &num)) continue;  // null nunca satisfaz o filtro
         bool keep = false;
         switch (op) {
             case 0: keep = num == threshold; break;
@@ -414,18 +1892,10 @@ void* datalang_df_filter_numeric(void* df_ptr, char* column, int32_t op, double
             case 5: keep = num <= threshold; break;
             default: keep = false; break;
         }
-        if (!keep) continue;
-
-        df->data = (char***)realloc(df->data, (df->row_count + 1) * sizeof(char**));
-        df->data[df->row_count] = (char**)calloc(df->col_count, sizeof(char*));
-        for (int64_t c = 0; c < df->col_count; c++) {
-            df->data[df->row_count][c] = strdup_or_null(src->data[r][c]);
-        }
-        df->row_count++;
+        if (keep) rows[kept++] = phys;
     }
 
-    df->source_file = strdup("filter(runtime)");
-    return (void*)df;
+    return (void*)df_view(src, rows, kept, "filter(runtime)");
 }
 
 // ==================== FILTER (string igualdade) ====================
@@ -436,33 +1906,24 @@ void* datalang_df_filter_string(void* df_ptr, char* column, char* literal, int32
     int idx = find_column_index(src, column);
     if (idx < 0) return df_ptr;
 
-    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
-    df->id = ++df_counter;
-    df->col_count = src->col_count;
-    df->column_names = (char**)calloc(df->col_count, sizeof(char*));
-    for (int64_t i = 0; i < df->col_count; i++) df->column_names[i] = strdup_or_null(src->column_names[i]);
-
-    df->data = NULL;
-    df->row_count = 0;
+    const Column* col = &src->columns[idx];
+    int64_t* rows = (int64_t*)malloc(sizeof(int64_t) * (src->row_count > 0 ? src->row_count : 1));
+    int64_t kept = 0;
+    char buf[64];
+    int64_t literal_len = (int64_t)strlen(literal);
 
     for (int64_t r = 0; r < src->row_count; r++) {
-        const char* val = src->data[r][idx];
+        int64_t phys = df_row(src, r);
+        StrView val = column_format(col, phys, buf, sizeof(buf));
+        if (!val.ptr) val = (StrView){"null", 4};
+        bool equal = val.len == literal_len && memcmp(val.ptr, literal, (size_t)literal_len) == 0;
         bool keep = false;
-        int cmp = strcmp(val ? val : "null", literal);
-        if (op == 0) keep = (cmp == 0);
-        else if (op == 1) keep = (cmp != 0);
-        if (!keep) continue;
-
-        df->data = (char***)realloc(df->data, (df->row_count + 1) * sizeof(char**));
-        df->data[df->row_count] = (char**)calloc(df->col_count, sizeof(char*));
-        for (int64_t c = 0; c < df->col_count; c++) {
-            df->data[df->row_count][c] = strdup_or_null(src->data[r][c]);
-        }
-        df->row_count++;
+        if (op == 0) keep = equal;
+        else if (op == 1) keep = !equal;
+        if (keep) rows[kept++] = phys;
     }
 
-    df->source_file = strdup("filter(runtime)");
-    return (void*)df;
+    return (void*)df_view(src, rows, kept, "filter(runtime)");
 }
 
 // ==================== EXTRACT COLUMN AS DOUBLE ARRAY ====================
@@ -474,11 +1935,23 @@ DFArrayDouble datalang_df_column_double(void* df_ptr, char* column, double scale
     int idx = find_column_index(df, column);
     if (idx < 0) return arr;
 
+    const Column* col = &df->columns[idx];
     arr.size = df->row_count;
-    arr.data = (double*)calloc(arr.size, sizeof(double));
-    for (int64_t r = 0; r < arr.size; r++) {
-        double v = strtod(df->data[r][idx], NULL);
-        arr.data[r] = v * scale + add;
+    arr.data = (double*)calloc(arr.size > 0 ? arr.size : 1, sizeof(double));
+    switch (col->type) {
+        case COL_FLOAT:
+            for (int64_t r = 0; r < arr.size; r++) arr.data[r] = col->as.floats[df_row(df, r)] * scale + add;
+            break;
+        case COL_INT:
+            for (int64_t r = 0; r < arr.size; r++) arr.data[r] = (double)col->as.ints[df_row(df, r)] * scale + add;
+            break;
+        default:
+            for (int64_t r = 0; r < arr.size; r++) {
+                double v = 0.0;
+                column_get_double(col, df_row(df, r), &v);
+                arr.data[r] = v * scale + add;
+            }
+            break;
     }
     return arr;
 }
@@ -495,17 +1968,19 @@ void datalang_print_dataframe(void* df_ptr) {
     // Cabeçalho
     printf("[");
     for (int64_t c = 0; c < df->col_count; c++) {
-        printf("%s", df->column_names[c] ? df->column_names[c] : "col");
+        printf("%s", df->columns[c].name ? df->columns[c].name : "col");
         if (c < df->col_count - 1) printf(", ");
     }
     printf("]\n");
 
     // Linhas
+    char buf[64];
     for (int64_t r = 0; r < df->row_count; r++) {
         printf("[");
         for (int64_t c = 0; c < df->col_count; c++) {
-            char* val = df->data ? df->data[r][c] : NULL;
-            printf("%s", val ? val : "null");
+            StrView val = column_format(&df->columns[c], df_row(df, r), buf, sizeof(buf));
+            if (!val.ptr) val = (StrView){"null", 4};
+            printf("%.*s", (int)val.len, val.ptr);
             if (c < df->col_count - 1) printf(", ");
         }
         printf("]\n");
@@ -514,41 +1989,81 @@ void datalang_print_dataframe(void* df_ptr) {
 
 // ==================== DATAFRAME BUILD HELPERS ====================
 
+// DataFrames montados a partir de arrays recebem valores já formatados como
+// texto (datalang_format_*), por isso as colunas são String.
 void* datalang_df_create(int32_t col_count, ...) {
-    DataFrame* df = (DataFrame*)calloc(1, sizeof(DataFrame));
-    df->id = ++df_counter;
-    df->col_count = col_count;
-    df->row_count = 0;
-    df->column_names = (char**)calloc(col_count, sizeof(char*));
-    df->data = NULL;
-    df->source_file = strdup("df_from_array");
-    
+    DataFrame* df = df_alloc(col_count, "df_from_array");
+
     va_list args;
     va_start(args, col_count);
     for (int32_t i = 0; i < col_count; i++) {
         char* name = va_arg(args, char*);
-        df->column_names[i] = strdup(name ? name : "col");
+        column_init(&df->columns[i], name ? name : "col", COL_STRING, 16);
     }
     va_end(args);
-    
+
     return (void*)df;
 }
 
 void datalang_df_add_row(void* df_ptr, int32_t col_count, ...) {
     if (!df_ptr) return;
     DataFrame* df = (DataFrame*)df_ptr;
-    
-    df->data = (char***)realloc(df->data, (df->row_count + 1) * sizeof(char**));
-    df->data[df->row_count] = (char**)calloc(col_count, sizeof(char*));
-    
+
     va_list args;
     va_start(args, col_count);
     for (int32_t i = 0; i < col_count; i++) {
         char* val = va_arg(args, char*);
-        df->data[df->row_count][i] = strdup(val ? val : "null");
+        if (!val) val = "null";
+        if (i < df->col_count) column_append_string(&df->columns[i], val, (int64_t)strlen(val));
     }
     va_end(args);
-    
+
+    df->row_count++;
+}
+
+// Variante tipada para groupby |> agregação sobre arrays de registros: os
+// campos entram com o tipo do registro (sem passar por texto). Argumentos de
+// datalang_df_create_typed: pares (nome, ColumnType); em
+// datalang_df_add_typed_row cada valor vem no tipo da sua coluna (Int i64,
+// Float double, Bool int, String char* com NULL para null).
+void* datalang_df_create_typed(int32_t col_count, ...) {
+    DataFrame* df = df_alloc(col_count, "df_from_array");
+
+    va_list args;
+    va_start(args, col_count);
+    for (int32_t i = 0; i < col_count; i++) {
+        char* name = va_arg(args, char*);
+        int32_t type = va_arg(args, int32_t);
+        if (type < COL_INT || type > COL_STRING) type = COL_STRING;
+        column_init(&df->columns[i], name ? name : "col", (ColumnType)type, 16);
+    }
+    va_end(args);
+
+    return (void*)df;
+}
+
+void datalang_df_add_typed_row(void* df_ptr, int32_t col_count, ...) {
+    if (!df_ptr) return;
+    DataFrame* df = (DataFrame*)df_ptr;
+
+    va_list args;
+    va_start(args, col_count);
+    for (int32_t i = 0; i < col_count && i < df->col_count; i++) {
+        Column* col = &df->columns[i];
+        switch (col->type) {
+            case COL_INT: column_append_int(col, va_arg(args, int64_t)); break;
+            case COL_FLOAT: column_append_float(col, va_arg(args, double)); break;
+            case COL_BOOL: column_append_bool(col, va_arg(args, int) != 0); break;
+            case COL_STRING: {
+                char* val = va_arg(args, char*);
+                if (val) column_append_string(col, val, (int64_t)strlen(val));
+                else column_append_null(col);
+                break;
+            }
+        }
+    }
+    va_end(args);
+
     df->row_count++;
 }
 
@@ -572,28 +2087,25 @@ char* datalang_format_bool(bool v) {
 
 void datalang_free_dataframe(void* df_ptr) {
     if (!df_ptr) return;
-    
+
     DataFrame* df = (DataFrame*)df_ptr;
-    
-    // Libera column names
-    if (df->column_names) {
-        for (int64_t i = 0; i < df->col_count; i++) {
-            free(df->column_names[i]);
-        }
-        free(df->column_names);
+
+    // Visão: as colunas pertencem ao pai
+    if (df->parent) {
+        free(df->selection);
+        free(df->source_file);
+        free(df);
+        return;
     }
-    
-    // Libera data
-    if (df->data) {
-        for (int64_t row = 0; row < df->row_count; row++) {
-            for (int64_t col = 0; col < df->col_count; col++) {
-                free(df->data[row][col]);
-            }
-            free(df->data[row]);
+
+    // Libera colunas (nomes, buffers e bitmaps)
+    if (df->columns) {
+        for (int64_t i = 0; i < df->col_count; i++) {
+            column_free(&df->columns[i]);
         }
-        free(df->data);
+        free(df->columns);
     }
-    
+
     free(df->source_file);
     free(df);
 }
@@ -0,0 +1,117 @@
+/*
+ * DataLang - Implementação do alocador por região
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "log.h"
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024)
+#define ARENA_ALIGN 16
+
+// ==================== FUNÇÕES AUXILIARES ====================
+
+static size_t align_up(size_t n) {
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static ArenaBlock* new_block(Arena* arena, size_t min_size) {
+    size_t capacity = arena->block_size;
+    if (min_size > capacity) capacity = min_size;
+
+    ArenaBlock* block = malloc(sizeof(ArenaBlock) + capacity);
+    if (!block) {
+        log_error("Erro: Falha ao alocar bloco da arena (%zu bytes)\n", capacity);
+        exit(1);
+    }
+    block->next = arena->current;
+    block->used = 0;
+    block->capacity = capacity;
+    arena->current = block;
+    arena->block_count++;
+    return block;
+}
+
+// ==================== CRIAÇÃO E DESTRUIÇÃO ====================
+
+Arena* arena_create(size_t block_size) {
+    Arena* arena = calloc(1, sizeof(Arena));
+    if (!arena) {
+        log_error("Erro: Falha ao alocar arena\n");
+        exit(1);
+    }
+    arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+    return arena;
+}
+
+void arena_destroy(Arena* arena) {
+    if (!arena) return;
+    ArenaBlock* block = arena->current;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+// ==================== ALOCAÇÃO ====================
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size_t needed = align_up(size ? size : 1);
+    ArenaBlock* block = arena->current;
+    if (!block || block->capacity - block->used < needed) {
+        block = new_block(arena, needed);
+    }
+
+    void* ptr = block->data + block->used;
+    block->used += needed;
+    arena->bytes_allocated += size;
+    arena->allocation_count++;
+    return ptr;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    size_t total = count * size;
+    void* ptr = arena_alloc(arena, total);
+    memset(ptr, 0, total);
+    return ptr;
+}
+
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return arena_alloc(arena, new_size);
+    if (new_size <= old_size) return ptr;
+
+    // Última alocação do bloco atual: cresce no lugar
+    ArenaBlock* block = arena->current;
+    size_t old_aligned = align_up(old_size ? old_size : 1);
+    size_t new_aligned = align_up(new_size);
+    if (block && (char*)ptr + old_aligned == block->data + block->used &&
+        block->used - old_aligned + new_aligned <= block->capacity) {
+        block->used = block->used - old_aligned + new_aligned;
+        arena->bytes_allocated += new_size - old_size;
+        return ptr;
+    }
+
+    void* copy = arena_alloc(arena, new_size);
+    memcpy(copy, ptr, old_size);
+    return copy;
+}
+
+// ==================== STRINGS ====================
+
+char* arena_strndup(Arena* arena, const char* s, size_t n) {
+    size_t len = strnlen(s, n);
+    char* copy = arena_alloc(arena, len + 1);
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char* arena_strdup(Arena* arena, const char* s) {
+    return arena_strndup(arena, s, strlen(s));
+}
@@ -0,0 +1,47 @@
+/*
+ * DataLang - Alocador por região (arena)
+ * Tokens, AST, tipos, símbolos e temporários do codegen vivem até o fim
+ * da compilação: são alocados sequencialmente em blocos grandes e
+ * liberados todos de uma vez com arena_destroy.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// ==================== ESTRUTURAS ====================
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t used;
+    size_t capacity;
+    _Alignas(16) char data[];        // Alinhado como as alocações
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock* current;             // Bloco onde as alocações são feitas
+    size_t block_size;               // Tamanho padrão de cada bloco novo
+    size_t bytes_allocated;          // Total pedido pelos usuários da arena
+    size_t allocation_count;         // Número de alocações
+    size_t block_count;              // Blocos obtidos do malloc
+} Arena;
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+// Criação e destruição (block_size 0 usa o padrão de 64 KB)
+Arena* arena_create(size_t block_size);
+void arena_destroy(Arena* arena);
+
+// Alocação (alinhada a 16 bytes); nunca retorna NULL
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+
+// Redimensiona um bloco da arena; estende no lugar se for a última alocação
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+
+// Cópias de strings
+char* arena_strdup(Arena* arena, const char* s);
+char* arena_strndup(Arena* arena, const char* s, size_t n);
+
+#endif // ARENA_H
@@ -0,0 +1,40 @@
+/*
+ * DataLang - Hash de strings
+ * FNV-1a de 32 bits, usado pelas tabelas hash do compilador (escopos da
+ * tabela de símbolos, mapa de variáveis do codegen, strings internadas)
+ */
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint32_t hash_string(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint32_t hash_bytes(const char* s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Para tabelas indexadas por strings internadas (ponteiro = identidade)
+static inline uint32_t hash_pointer(const void* p) {
+    uint64_t x = (uint64_t)(uintptr_t)p;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (uint32_t)x;
+}
+
+#endif // HASH_H
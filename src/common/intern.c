@@ -0,0 +1,130 @@
+/*
+ * DataLang - Implementação da tabela de strings internadas
+ * Endereçamento aberto sobre ponteiros para as strings; cada string é
+ * precedida na arena por um cabeçalho com hash, tamanho e tag.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+#include "hash.h"
+
+#define INTERN_INITIAL_CAPACITY 1024
+
+typedef struct {
+    uint32_t hash;
+    uint32_t length;
+    int32_t tag;                     // Ex.: TokenType de palavras-chave e operadores
+    uint32_t reserved;
+    char str[];
+} InternHeader;
+
+typedef struct {
+    InternHeader** slots;            // Potência de 2, ocupação abaixo de 50%
+    int capacity;
+    int count;
+    Arena* arena;
+    bool owns_arena;
+} Interner;
+
+static Interner interner = {0};
+
+// ==================== FUNÇÕES AUXILIARES ====================
+
+static InternHeader* header_of(const char* s) {
+    return (InternHeader*)(s - offsetof(InternHeader, str));
+}
+
+static void interner_grow(void) {
+    InternHeader** old = interner.slots;
+    int old_capacity = interner.capacity;
+
+    interner.capacity = old_capacity ? old_capacity * 2 : INTERN_INITIAL_CAPACITY;
+    interner.slots = calloc(interner.capacity, sizeof(InternHeader*));
+    unsigned mask = (unsigned)interner.capacity - 1;
+    for (int i = 0; i < old_capacity; i++) {
+        if (!old[i]) continue;
+        unsigned j = old[i]->hash & mask;
+        while (interner.slots[j]) j = (j + 1) & mask;
+        interner.slots[j] = old[i];
+    }
+    free(old);
+}
+
+// Slot da string (ocupado se ela existe, vazio onde deve ser inserida)
+static InternHeader** interner_slot(const char* s, size_t len, uint32_t hash) {
+    unsigned mask = (unsigned)interner.capacity - 1;
+    unsigned i = hash & mask;
+    for (; interner.slots[i]; i = (i + 1) & mask) {
+        InternHeader* h = interner.slots[i];
+        if (h->hash == hash && h->length == len && memcmp(h->str, s, len) == 0) break;
+    }
+    return &interner.slots[i];
+}
+
+// ==================== INICIALIZAÇÃO ====================
+
+void interner_init(Arena* arena) {
+    interner_reset();
+    interner.owns_arena = (arena == NULL);
+    interner.arena = arena ? arena : arena_create(0);
+    interner_grow();
+}
+
+void interner_reset(void) {
+    if (interner.owns_arena) arena_destroy(interner.arena);
+    free(interner.slots);
+    memset(&interner, 0, sizeof(interner));
+}
+
+// ==================== INTERNAÇÃO ====================
+
+const char* intern(const char* s, size_t len) {
+    if (!interner.slots) interner_init(NULL);
+
+    uint32_t hash = hash_bytes(s, len);
+    InternHeader** slot = interner_slot(s, len, hash);
+    if (*slot) return (*slot)->str;
+
+    InternHeader* h = arena_alloc(interner.arena, sizeof(InternHeader) + len + 1);
+    h->hash = hash;
+    h->length = (uint32_t)len;
+    h->tag = INTERN_NO_TAG;
+    h->reserved = 0;
+    memcpy(h->str, s, len);
+    h->str[len] = '\0';
+    *slot = h;
+
+    if (++interner.count * 2 > interner.capacity) interner_grow();
+    return h->str;
+}
+
+const char* intern_cstr(const char* s) {
+    return intern(s, strlen(s));
+}
+
+const char* intern_find(const char* s) {
+    return intern_find_n(s, strlen(s));
+}
+
+const char* intern_find_n(const char* s, size_t len) {
+    if (!interner.slots) return NULL;
+    InternHeader* h = *interner_slot(s, len, hash_bytes(s, len));
+    return h ? h->str : NULL;
+}
+
+// ==================== DADOS ASSOCIADOS ====================
+
+uint32_t intern_hash(const char* s) {
+    return header_of(s)->hash;
+}
+
+int intern_tag(const char* s) {
+    return header_of(s)->tag;
+}
+
+void intern_set_tag(const char* s, int tag) {
+    header_of(s)->tag = tag;
+}
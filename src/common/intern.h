@@ -0,0 +1,36 @@
+/*
+ * DataLang - Tabela global de strings internadas
+ * Cada nome, palavra-chave, operador e literal existe uma única vez: duas
+ * strings internadas são iguais se e somente se os ponteiros são iguais.
+ * As strings vivem na arena da compilação.
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+#define INTERN_NO_TAG (-1)
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+// Inicialização e descarte (arena NULL: a tabela cria e libera a sua)
+void interner_init(Arena* arena);
+void interner_reset(void);
+
+// Devolve a cópia canônica de s (len bytes), criando-a se necessário
+const char* intern(const char* s, size_t len);
+const char* intern_cstr(const char* s);
+
+// Cópia canônica de s se ela já foi internada, senão NULL (não insere)
+const char* intern_find(const char* s);
+const char* intern_find_n(const char* s, size_t len);
+
+// Dados guardados junto da string canônica (s precisa ser internada)
+uint32_t intern_hash(const char* s);
+int intern_tag(const char* s);                 // INTERN_NO_TAG se nunca marcada
+void intern_set_tag(const char* s, int tag);
+
+#endif // INTERN_H
@@ -0,0 +1,32 @@
+/*
+ * DataLang - Log com níveis do compilador
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "log.h"
+
+static LogLevel current_level = LOG_WARN;
+
+void log_set_level(LogLevel level) {
+    current_level = level;
+}
+
+LogLevel log_get_level(void) {
+    return current_level;
+}
+
+bool log_enabled(LogLevel level) {
+    return level <= current_level;
+}
+
+void log_message(LogLevel level, const char* format, ...) {
+    if (level > current_level) return;
+
+    // Erros e avisos em stderr; o progresso não se mistura com eles
+    FILE* out = level <= LOG_WARN ? stderr : stdout;
+    va_list args;
+    va_start(args, format);
+    vfprintf(out, format, args);
+    va_end(args);
+}
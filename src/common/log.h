@@ -0,0 +1,35 @@
+/*
+ * DataLang - Log com níveis do compilador
+ * Silencioso por padrão: só erros e avisos (em stderr). -v liga o
+ * progresso das fases e -vv os diagnósticos detalhados (em stdout).
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdbool.h>
+
+typedef enum {
+    LOG_ERROR,      // Sempre exibido; -q mostra só estes
+    LOG_WARN,       // Padrão
+    LOG_INFO,       // -v: banners e progresso das fases
+    LOG_DEBUG       // -vv: iterações do AFD, tabela de símbolos, etc.
+} LogLevel;
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+void log_set_level(LogLevel level);
+LogLevel log_get_level(void);
+
+// Permite pular laços que só existem para imprimir
+bool log_enabled(LogLevel level);
+
+void log_message(LogLevel level, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#define log_error(...) log_message(LOG_ERROR, __VA_ARGS__)
+#define log_warn(...)  log_message(LOG_WARN, __VA_ARGS__)
+#define log_info(...)  log_message(LOG_INFO, __VA_ARGS__)
+#define log_debug(...) log_message(LOG_DEBUG, __VA_ARGS__)
+
+#endif // LOG_H
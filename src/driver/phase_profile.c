@@ -0,0 +1,243 @@
+/*
+ * DataLang - Perfil das fases da compilação
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "phase_profile.h"
+#include "log.h"
+
+#define MAX_PHASES 16
+
+// ==================== ESTRUTURAS ====================
+
+typedef struct {
+    const char* name;
+    double wall_ms;
+    double cpu_ms;                   // Compilador + processos filhos (opt, llc, cc)
+    size_t arena_allocations;        // Alocações na arena da compilação
+    size_t arena_bytes;
+    long long heap_bytes;            // Variação dos bytes em uso no malloc
+    long rss_delta_kb;               // RSS ao fim - RSS ao início
+    long peak_rss_kb;                // Pico de RSS dentro da fase (ver peak_per_phase)
+} PhaseSample;
+
+typedef struct {
+    bool enabled;
+    const char* json_path;
+    PhaseSample phases[MAX_PHASES];
+    int count;
+
+    // O pico por fase depende de zerar o VmHWM do kernel (clear_refs);
+    // sem isso o pico reportado é o do processo até o fim da fase
+    bool peak_per_phase;
+
+    // Fase em andamento
+    bool running;
+    Arena* arena;
+    double start_wall;
+    double start_cpu;
+    size_t start_allocations;
+    size_t start_bytes;
+    long long start_heap;
+    long start_rss;
+} PhaseProfile;
+
+static PhaseProfile profile = {0};
+
+// ==================== FUNÇÕES AUXILIARES ====================
+
+static double wall_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static double timeval_ms(struct timeval tv) {
+    return tv.tv_sec * 1e3 + tv.tv_usec / 1e3;
+}
+
+static double cpu_ms(void) {
+    struct rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+    return timeval_ms(self.ru_utime) + timeval_ms(self.ru_stime) +
+           timeval_ms(children.ru_utime) + timeval_ms(children.ru_stime);
+}
+
+// Bytes em uso no malloc (blocos do heap + blocos mapeados)
+static long long heap_in_use(void) {
+    struct mallinfo2 info = mallinfo2();
+    return (long long)(info.uordblks + info.hblkhd);
+}
+
+// RSS atual em KB (/proc/self/statm: segunda coluna, em páginas)
+static long current_rss_kb(void) {
+    long size = 0, pages = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &size, &pages) != 2) pages = 0;
+    fclose(f);
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Zera o pico de RSS do processo (Linux: "5" em /proc/self/clear_refs)
+static bool reset_peak_rss(void) {
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (!f) return false;
+    bool ok = fputs("5", f) >= 0;
+    return fclose(f) == 0 && ok;
+}
+
+// Pico de RSS em KB desde o último reset (VmHWM); ru_maxrss se indisponível
+static long peak_rss_kb(void) {
+    long peak = -1;
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f) {
+        char line[256];
+        while (fgets(line, sizeof(line), f)) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                peak = atol(line + 6);
+                break;
+            }
+        }
+        fclose(f);
+    }
+    if (peak < 0) {
+        struct rusage self;
+        getrusage(RUSAGE_SELF, &self);
+        peak = self.ru_maxrss;
+    }
+    return peak;
+}
+
+// ==================== RELATÓRIOS ====================
+
+// Soma das fases; o pico de RSS é o maior visto
+static PhaseSample profile_total(void) {
+    PhaseSample total = { .name = "total" };
+    for (int i = 0; i < profile.count; i++) {
+        PhaseSample* s = &profile.phases[i];
+        total.wall_ms += s->wall_ms;
+        total.cpu_ms += s->cpu_ms;
+        total.arena_allocations += s->arena_allocations;
+        total.arena_bytes += s->arena_bytes;
+        total.heap_bytes += s->heap_bytes;
+        total.rss_delta_kb += s->rss_delta_kb;
+        if (s->peak_rss_kb > total.peak_rss_kb) total.peak_rss_kb = s->peak_rss_kb;
+    }
+    return total;
+}
+
+static void print_row(FILE* out, const PhaseSample* s) {
+    fprintf(out, "%-12s %12.3f %12.3f %13zu %13zu %13lld %13ld %14ld\n",
+            s->name, s->wall_ms, s->cpu_ms, s->arena_allocations, s->arena_bytes,
+            s->heap_bytes, s->rss_delta_kb, s->peak_rss_kb);
+}
+
+static void print_json_object(FILE* out, const PhaseSample* s) {
+    fprintf(out, "{\"name\": \"%s\", \"wall_ms\": %.3f, \"cpu_ms\": %.3f, "
+            "\"arena_allocations\": %zu, \"arena_bytes\": %zu, \"heap_bytes\": %lld, "
+            "\"rss_delta_kb\": %ld, \"peak_rss_kb\": %ld}",
+            s->name, s->wall_ms, s->cpu_ms, s->arena_allocations, s->arena_bytes,
+            s->heap_bytes, s->rss_delta_kb, s->peak_rss_kb);
+}
+
+static void report_table(FILE* out) {
+    PhaseSample total = profile_total();
+    fprintf(out, "\n%-12s %12s %12s %13s %13s %13s %13s %14s\n",
+            "Fase", "Parede (ms)", "CPU (ms)", "Aloc. arena", "Bytes arena",
+            "Heap (bytes)", "Var. RSS (KB)", "Pico RSS (KB)");
+    for (int i = 0; i < profile.count; i++) {
+        print_row(out, &profile.phases[i]);
+    }
+    print_row(out, &total);
+    if (!profile.peak_per_phase) {
+        fprintf(out, "(Pico RSS: máximo do processo até o fim de cada fase)\n");
+    }
+}
+
+static void report_json(FILE* out) {
+    PhaseSample total = profile_total();
+    fprintf(out, "{\n  \"peak_rss_scope\": \"%s\",\n  \"phases\": [",
+            profile.peak_per_phase ? "phase" : "process");
+    for (int i = 0; i < profile.count; i++) {
+        fprintf(out, "%s\n    ", i ? "," : "");
+        print_json_object(out, &profile.phases[i]);
+    }
+    fprintf(out, "\n  ],\n  \"total\": ");
+    print_json_object(out, &total);
+    fprintf(out, "\n}\n");
+}
+
+static void phase_profile_report(void) {
+    if (profile.running) {
+        // Fase interrompida por erro: a arena já pode ter sido destruída
+        profile.arena = NULL;
+        phase_end();
+    }
+    fflush(stdout);   // Não intercala a tabela com o progresso em stdout
+    report_table(stderr);
+
+    if (!profile.json_path) return;
+    bool to_stdout = strcmp(profile.json_path, "-") == 0;
+    FILE* out = to_stdout ? stdout : fopen(profile.json_path, "w");
+    if (!out) {
+        log_error("Erro: Não foi possível criar o arquivo '%s'\n", profile.json_path);
+        return;
+    }
+    report_json(out);
+    if (!to_stdout) fclose(out);
+}
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+void phase_profile_enable(const char* json_path) {
+    if (!profile.enabled) {
+        atexit(phase_profile_report);
+        profile.peak_per_phase = reset_peak_rss();
+    }
+    profile.enabled = true;
+    if (json_path) profile.json_path = json_path;
+}
+
+void phase_begin(const char* name, Arena* arena) {
+    if (!profile.enabled || profile.count >= MAX_PHASES) return;
+    if (profile.running) phase_end();
+
+    PhaseSample* s = &profile.phases[profile.count];
+    memset(s, 0, sizeof(*s));
+    s->name = name;
+    profile.running = true;
+    profile.arena = arena;
+    profile.start_allocations = arena ? arena->allocation_count : 0;
+    profile.start_bytes = arena ? arena->bytes_allocated : 0;
+    profile.start_heap = heap_in_use();
+    profile.start_rss = current_rss_kb();
+    if (profile.peak_per_phase) reset_peak_rss();
+    profile.start_cpu = cpu_ms();
+    profile.start_wall = wall_ms();
+}
+
+void phase_end(void) {
+    if (!profile.enabled || !profile.running) return;
+
+    PhaseSample* s = &profile.phases[profile.count++];
+    s->wall_ms = wall_ms() - profile.start_wall;
+    s->cpu_ms = cpu_ms() - profile.start_cpu;
+    if (profile.arena) {
+        s->arena_allocations = profile.arena->allocation_count - profile.start_allocations;
+        s->arena_bytes = profile.arena->bytes_allocated - profile.start_bytes;
+    }
+    s->heap_bytes = heap_in_use() - profile.start_heap;
+    s->rss_delta_kb = current_rss_kb() - profile.start_rss;
+    s->peak_rss_kb = peak_rss_kb();
+    profile.running = false;
+    profile.arena = NULL;
+}
@@ -0,0 +1,25 @@
+/*
+ * DataLang - Perfil das fases da compilação (--time-phases)
+ * Mede, por fase: tempo de parede, tempo de CPU (do compilador e das
+ * ferramentas chamadas), alocações na arena, variação do heap (malloc),
+ * variação do RSS e o pico de RSS dentro da fase.
+ */
+
+#ifndef PHASE_PROFILE_H
+#define PHASE_PROFILE_H
+
+#include <stdbool.h>
+#include "arena.h"
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+// Liga o perfil; json_path (opcional, "-" para stdout) recebe o relatório
+// em JSON. O relatório é emitido na saída do processo, inclusive em erro.
+void phase_profile_enable(const char* json_path);
+
+// Delimita uma fase; arena é a arena cujas alocações são contadas (NULL
+// quando a fase não usa a arena da compilação; o heap é medido sempre)
+void phase_begin(const char* name, Arena* arena);
+void phase_end(void);
+
+#endif // PHASE_PROFILE_H
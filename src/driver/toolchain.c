@@ -0,0 +1,203 @@
+/*
+ * DataLang - Driver do toolchain LLVM
+ *
+ * Pipeline do executável:
+ *   programa.ll --opt -O<n>--> programa.bc --llc -O<n>--> programa.o
+ *   programa.o + libdatalang_rt.a --cc--> executável
+ *
+ * Com LTO o runtime em bitcode (libdatalang_rt.bc) é ligado ao IR do
+ * programa (llvm-link) antes do opt, para que os kernels do runtime possam
+ * ser inlineados nos pipelines gerados.
+ *
+ * Se a biblioteca/bitcode pré-compilados (make runtime) não existirem, o
+ * runtime.c é compilado na hora com o mesmo nível de otimização.
+ *
+ * As ferramentas podem ser trocadas por variáveis de ambiente:
+ * DATALANG_OPT, DATALANG_LLC, DATALANG_CC, DATALANG_LLVM_LINK,
+ * DATALANG_RUNTIME (runtime.c), DATALANG_RUNTIME_LIB e DATALANG_RUNTIME_BC.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "toolchain.h"
+#include "log.h"
+
+extern char** environ;
+
+#ifndef DATALANG_RUNTIME_SOURCE
+#define DATALANG_RUNTIME_SOURCE "src/codegen/runtime.c"
+#endif
+#ifndef DATALANG_RUNTIME_LIB
+#define DATALANG_RUNTIME_LIB "bin/libdatalang_rt.a"
+#endif
+#ifndef DATALANG_RUNTIME_BC
+#define DATALANG_RUNTIME_BC "bin/libdatalang_rt.bc"
+#endif
+
+#define TOOL_MAX_ARGS 16
+
+// ==================== FUNÇÕES AUXILIARES ====================
+
+static const char* tool_path(const char* env_name, const char* fallback) {
+    const char* value = getenv(env_name);
+    return (value && *value) ? value : fallback;
+}
+
+static bool is_readable(const char* path) {
+    return access(path, R_OK) == 0;
+}
+
+// Executa uma ferramenta como subprocesso (sem shell) e espera o término
+static bool run_tool(const char* const* args) {
+    if (log_enabled(LOG_INFO)) {
+        log_info("[Toolchain]");
+        for (int i = 0; args[i]; i++) log_info(" %s", args[i]);
+        log_info("\n");
+    }
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid;
+    int rc = posix_spawnp(&pid, args[0], NULL, NULL, (char* const*)args, environ);
+    if (rc != 0) {
+        log_error("Erro: não foi possível executar '%s': %s\n", args[0], strerror(rc));
+        return false;
+    }
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            log_error("Erro: falha ao aguardar '%s': %s\n", args[0], strerror(errno));
+            return false;
+        }
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        log_error("Erro: '%s' falhou (código %d)\n", args[0],
+                  WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+        return false;
+    }
+    return true;
+}
+
+// Diretório temporário para os artefatos intermediários
+typedef struct {
+    char dir[256];
+    char paths[6][300];
+    int count;
+} TempFiles;
+
+static bool temp_files_init(TempFiles* tmp) {
+    const char* base = tool_path("TMPDIR", "/tmp");
+    snprintf(tmp->dir, sizeof(tmp->dir), "%s/datalang-XXXXXX", base);
+    tmp->count = 0;
+    if (!mkdtemp(tmp->dir)) {
+        log_error("Erro: não foi possível criar diretório temporário em %s: %s\n",
+                  base, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static const char* temp_file(TempFiles* tmp, const char* name) {
+    char* path = tmp->paths[tmp->count++];
+    snprintf(path, sizeof(tmp->paths[0]), "%s/%s", tmp->dir, name);
+    return path;
+}
+
+static void temp_files_cleanup(TempFiles* tmp) {
+    for (int i = 0; i < tmp->count; i++) unlink(tmp->paths[i]);
+    rmdir(tmp->dir);
+}
+
+// ==================== OTIMIZAÇÃO DO IR ====================
+
+bool optimize_ir_file(const char* ll_path, const ToolchainOptions* opts) {
+    if (opts->opt_level <= 0) return true;
+
+    char level[8];
+    snprintf(level, sizeof(level), "-O%d", opts->opt_level);
+    const char* args[] = {
+        tool_path("DATALANG_OPT", "opt"), level, "-S", ll_path, "-o", ll_path, NULL
+    };
+    return run_tool(args);
+}
+
+// ==================== EXECUTÁVEL ====================
+
+bool build_executable(const char* ll_path, const char* exe_path, const ToolchainOptions* opts) {
+    const char* opt = tool_path("DATALANG_OPT", "opt");
+    const char* llc = tool_path("DATALANG_LLC", "llc");
+    const char* cc = tool_path("DATALANG_CC", "clang");
+    const char* llvm_link = tool_path("DATALANG_LLVM_LINK", "llvm-link");
+    const char* runtime = tool_path("DATALANG_RUNTIME", DATALANG_RUNTIME_SOURCE);
+    const char* runtime_lib = tool_path("DATALANG_RUNTIME_LIB", DATALANG_RUNTIME_LIB);
+    const char* runtime_bc = tool_path("DATALANG_RUNTIME_BC", DATALANG_RUNTIME_BC);
+
+    char level[8];
+    snprintf(level, sizeof(level), "-O%d", opts->opt_level);
+
+    TempFiles tmp;
+    if (!temp_files_init(&tmp)) return false;
+
+    bool ok = true;
+    const char* module = ll_path;
+    const char* runtime_obj = NULL;
+
+    if (opts->lto) {
+        if (!is_readable(runtime_bc)) {
+            runtime_bc = temp_file(&tmp, "runtime.bc");
+            const char* rt_args[] = { cc, level, "-emit-llvm", "-c", runtime, "-o", runtime_bc, NULL };
+            ok = run_tool(rt_args);
+        }
+        const char* linked_bc = temp_file(&tmp, "linked.bc");
+        const char* link_args[] = { llvm_link, ll_path, runtime_bc, "-o", linked_bc, NULL };
+        ok = ok && run_tool(link_args);
+        module = linked_bc;
+    } else if (is_readable(runtime_lib)) {
+        runtime_obj = runtime_lib;
+    } else {
+        runtime_obj = temp_file(&tmp, "runtime.o");
+        const char* rt_args[] = { cc, level, "-c", runtime, "-o", runtime_obj, NULL };
+        ok = run_tool(rt_args);
+    }
+
+    // -O0 sem LTO dispensa o opt: o llc lê o .ll direto
+    if (ok && (opts->opt_level > 0 || opts->lto)) {
+        const char* optimized_bc = temp_file(&tmp, "program.bc");
+        const char* opt_args[] = { opt, level, module, "-o", optimized_bc, NULL };
+        ok = run_tool(opt_args);
+        module = optimized_bc;
+    }
+
+    const char* program_obj = temp_file(&tmp, "program.o");
+    if (ok) {
+        const char* llc_args[] = {
+            llc, level, "-filetype=obj", "-relocation-model=pic", module, "-o", program_obj, NULL
+        };
+        ok = run_tool(llc_args);
+    }
+
+    if (ok) {
+        const char* link_args[TOOL_MAX_ARGS];
+        int n = 0;
+        link_args[n++] = cc;
+        link_args[n++] = level;
+        link_args[n++] = program_obj;
+        if (runtime_obj) link_args[n++] = runtime_obj;
+        link_args[n++] = "-o";
+        link_args[n++] = exe_path;
+        link_args[n++] = "-lm";
+        link_args[n++] = "-lpthread";
+        link_args[n] = NULL;
+        ok = run_tool(link_args);
+    }
+
+    temp_files_cleanup(&tmp);
+    return ok;
+}
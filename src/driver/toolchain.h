@@ -0,0 +1,26 @@
+/*
+ * DataLang - Driver do toolchain LLVM
+ * Otimiza o IR gerado e produz executáveis nativos chamando opt/llc/clang
+ */
+
+#ifndef TOOLCHAIN_H
+#define TOOLCHAIN_H
+
+#include <stdbool.h>
+
+// ==================== ESTRUTURAS ====================
+
+typedef struct {
+    int opt_level;                   // 0..3, repassado a opt, llc e ao compilador C
+    bool lto;                        // Runtime em bitcode ligado ao IR antes do opt
+} ToolchainOptions;
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+// Otimiza um arquivo .ll no lugar (opt -O<n> -S)
+bool optimize_ir_file(const char* ll_path, const ToolchainOptions* opts);
+
+// IR + runtime -> executável nativo
+bool build_executable(const char* ll_path, const char* exe_path, const ToolchainOptions* opts);
+
+#endif // TOOLCHAIN_H
@@ -0,0 +1,108 @@
+/*
+ * DataLang - Gerador da tabela do AFD
+ * Executado pelo make: constrói o AFN unificado, converte para AFD, minimiza
+ * (Hopcroft) e grava a tabela comprimida por classes de bytes como um fonte
+ * C com arrays static const (ver afd_table.h).
+ *
+ * Uso: afd_gen <saida.c>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "datalang_afn.h"
+#include "afn_to_afd.h"
+#include "log.h"
+
+static bool write_table(const char* path, AFD* afd) {
+    int num_classes = afd->num_classes;
+
+    if (TOKEN_PRINT > 255) {
+        fprintf(stderr, "Erro: tipos de token não cabem em unsigned char\n");
+        return false;
+    }
+
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Erro: Não foi possível criar o arquivo '%s'\n", path);
+        return false;
+    }
+
+    fprintf(out, "/*\n");
+    fprintf(out, " * Gerado por afd_gen a partir de src/lexer/datalang_afn.c -- NÃO EDITAR\n");
+    fprintf(out, " * AFD mínimo: %d estados, %d classes de bytes\n", afd->num_states, num_classes);
+    fprintf(out, " */\n\n");
+    fprintf(out, "#include \"afd_table.h\"\n\n");
+
+    fprintf(out, "const int datalang_afd_num_states = %d;\n", afd->num_states);
+    fprintf(out, "const int datalang_afd_num_classes = %d;\n", num_classes);
+    fprintf(out, "const int datalang_afd_start_state = %d;\n\n", afd->start_state);
+
+    fprintf(out, "const unsigned char datalang_afd_byte_class[256] = {");
+    for (int c = 0; c < 256; c++) {
+        fprintf(out, "%s%3d,", c % 16 == 0 ? "\n    " : " ", afd->byte_class[c]);
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "const short datalang_afd_transitions[%d] = {", afd->num_states * num_classes);
+    for (int s = 0; s < afd->num_states; s++) {
+        fprintf(out, "\n    /* %3d */", s);
+        for (int k = 0; k < num_classes; k++) {
+            fprintf(out, " %d,", afd->class_table[s * num_classes + k]);
+        }
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "const unsigned char datalang_afd_token_types[%d] = {", afd->num_states);
+    for (int s = 0; s < afd->num_states; s++) {
+        int type = afd->final_states[s] ? (int)afd->token_types[s] : (int)TOKEN_ERROR;
+        fprintf(out, "%s%3d,", s % 16 == 0 ? "\n    " : " ", type);
+    }
+    fprintf(out, "\n};\n");
+
+    fclose(out);
+    printf("Tabela gravada em %s: %d estados, %d classes de bytes\n",
+           path, afd->num_states, num_classes);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s <saida.c>\n", argv[0]);
+        return 1;
+    }
+
+    // A saída vai para build/afd_gen.log: mantém o passo a passo da construção
+    log_set_level(LOG_DEBUG);
+
+    AFN* afn = create_unified_datalang_afn();
+    if (!afn) {
+        fprintf(stderr, "Erro: falha ao criar o AFN unificado\n");
+        return 1;
+    }
+
+    AFD* afd = afn_to_afd(afn);
+    free_afn(afn);
+    if (!afd) {
+        fprintf(stderr, "Erro: falha na conversão AFN -> AFD\n");
+        return 1;
+    }
+
+    AFD* min = minimize_afd(afd);
+    printf("Minimização: %d -> %d estados\n", afd->num_states, min ? min->num_states : 0);
+    free_afd(afd);
+    if (!min) {
+        fprintf(stderr, "Erro: falha na minimização do AFD\n");
+        return 1;
+    }
+
+    if (compress_afd_alphabet(min) < 0) {
+        fprintf(stderr, "Erro: AFD grande demais para a tabela compacta\n");
+        free_afd(min);
+        return 1;
+    }
+
+    bool ok = write_table(argv[1], min);
+    free_afd(min);
+    return ok ? 0 : 1;
+}
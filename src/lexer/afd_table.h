@@ -0,0 +1,26 @@
+/*
+ * DataLang - Tabela do AFD pré-compilada
+ * Gerada no build por afd_gen (AFN -> AFD -> Hopcroft) em
+ * build/datalang_afd_table.c; o compilador não constrói mais o AFD a cada
+ * execução.
+ *
+ * Bytes com o mesmo comportamento em todos os estados compartilham uma
+ * classe: a transição do estado s com o byte c é
+ *   datalang_afd_transitions[s * datalang_afd_num_classes + datalang_afd_byte_class[c]]
+ * (-1 quando não há transição).
+ */
+
+#ifndef AFD_TABLE_H
+#define AFD_TABLE_H
+
+extern const int datalang_afd_num_states;
+extern const int datalang_afd_num_classes;
+extern const int datalang_afd_start_state;
+
+extern const unsigned char datalang_afd_byte_class[256];
+extern const short datalang_afd_transitions[];
+
+// Tipo de token de cada estado; TOKEN_ERROR marca estados não finais
+extern const unsigned char datalang_afd_token_types[];
+
+#endif // AFD_TABLE_H
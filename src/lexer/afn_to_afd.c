@@ -1,5 +1,7 @@
 #include "datalang_afn.h"
+#include "afn_to_afd.h"
 #include <stdio.h>
+#include "log.h"
 
 int find_state_set_index(StateSet** sets, int count, StateSet* target) {
     if (!sets || !target) return -1;
@@ -18,25 +20,25 @@ int find_state_set_index(StateSet** sets, int count, StateSet* target) {
 
 AFD* afn_to_afd(AFN* afn) {
     if (!afn) {
-        fprintf(stderr, "ERRO: AFN nulo\n");
+        log_error("ERRO: AFN nulo\n");
         return NULL;
     }
     
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║  CONVERSÃO AFN → AFD (Construção de Subconjuntos)        ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    log_debug("\n╔════════════════════════════════════════════════════════════╗\n");
+    log_debug("║  CONVERSÃO AFN → AFD (Construção de Subconjuntos)        ║\n");
+    log_debug("╚════════════════════════════════════════════════════════════╝\n\n");
     
-    printf("AFN de entrada:\n");
-    printf("  - Estados: %d\n", afn->num_states);
-    printf("  - Alfabeto: %d\n", afn->alphabet_size);
-    printf("  - Estado inicial: %d\n", afn->start_state);
+    log_debug("AFN de entrada:\n");
+    log_debug("  - Estados: %d\n", afn->num_states);
+    log_debug("  - Alfabeto: %d\n", afn->alphabet_size);
+    log_debug("  - Estado inicial: %d\n", afn->start_state);
     
     /* ────────────────────────────────────────────────────────────
        FASE 1: INICIALIZAÇÃO
        ──────────────────────────────────────────────────────────── */
     
-    printf("\n[FASE 1] Inicializando...\n");
-    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    log_debug("\n[FASE 1] Inicializando...\n");
+    log_debug("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     
     // Cria estado inicial do AFD
     StateSet* initial_afn = create_state_set();
@@ -45,16 +47,19 @@ AFD* afn_to_afd(AFN* afn) {
     StateSet* q0_afd = epsilon_closure(afn, initial_afn);
     free_state_set(initial_afn);
     
-    printf("Estado inicial do AFD (ε-closure): { ");
-    for (int i = 0; i < q0_afd->size; i++) {
-        printf("%d ", q0_afd->states[i]);
+    if (log_enabled(LOG_DEBUG)) {
+        log_debug("Estado inicial do AFD (ε-closure): { ");
+        for (int i = 0; i < q0_afd->size; i++) {
+            log_debug("%d ", q0_afd->states[i]);
+        }
+        log_debug("}\n");
     }
-    printf("}\n");
     
-    // Estruturas para construção
-    StateSet** afd_states = (StateSet**)malloc(2000 * sizeof(StateSet*));
+    // Estruturas para construção (crescem sob demanda, dobrando a capacidade)
+    int capacity = 64;
+    StateSet** afd_states = (StateSet**)malloc(capacity * sizeof(StateSet*));
     int afd_state_count = 0;
-    int worklist[2000];
+    int* worklist = (int*)malloc(capacity * sizeof(int));
     int worklist_count = 0;
     
     // Adiciona estado inicial
@@ -65,35 +70,32 @@ AFD* afn_to_afd(AFN* afn) {
     // Cria AFD
     AFD* afd = (AFD*)malloc(sizeof(AFD));
     if (!afd) {
-        fprintf(stderr, "ERRO: Falha ao alocar AFD\n");
+        log_error("ERRO: Falha ao alocar AFD\n");
         return NULL;
     }
     
-    afd->num_states = 2000;
+    afd->num_states = 0;
     afd->alphabet_size = afn->alphabet_size;
     afd->start_state = 0;
+    afd->num_classes = 0;
+    afd->class_table = NULL;
     
-    // Aloca tabela de transições
-    afd->transition_table = (int**)malloc(2000 * sizeof(int*));
-    for (int i = 0; i < 2000; i++) {
-        afd->transition_table[i] = (int*)malloc(256 * sizeof(int));
-        for (int j = 0; j < 256; j++) {
-            afd->transition_table[i][j] = -1;
-        }
-    }
-    
-    afd->final_states = (bool*)calloc(2000, sizeof(bool));
-    afd->token_types = (TokenType*)malloc(2000 * sizeof(TokenType));
-    for (int i = 0; i < 2000; i++) {
-        afd->token_types[i] = TOKEN_ERROR;
+    // Linhas da tabela de transições são alocadas à medida que os estados
+    // são descobertos
+    afd->transition_table = (int**)malloc(capacity * sizeof(int*));
+    afd->transition_table[0] = (int*)malloc(256 * sizeof(int));
+    for (int j = 0; j < 256; j++) {
+        afd->transition_table[0][j] = -1;
     }
+    afd->final_states = NULL;
+    afd->token_types = NULL;
     
     /* ────────────────────────────────────────────────────────────
        FASE 2: CONSTRUÇÃO ITERATIVA
        ──────────────────────────────────────────────────────────── */
     
-    printf("\n[FASE 2] Construção iterativa...\n");
-    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    log_debug("\n[FASE 2] Construção iterativa...\n");
+    log_debug("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     
     int iteration = 0;
     while (worklist_count > 0) {
@@ -101,13 +103,15 @@ AFD* afn_to_afd(AFN* afn) {
         StateSet* current_set = afd_states[current_idx];
         
         iteration++;
-        if (iteration <= 20 || iteration % 50 == 0) {  // Log reduzido
-            printf("[Iter %d] Processando estado AFD %d: { ", iteration, current_idx);
+        bool log_iteration = (iteration <= 20 || iteration % 50 == 0) &&  // Log reduzido
+                             log_enabled(LOG_DEBUG);
+        if (log_iteration) {
+            log_debug("[Iter %d] Processando estado AFD %d: { ", iteration, current_idx);
             for (int i = 0; i < current_set->size && i < 5; i++) {
-                printf("%d ", current_set->states[i]);
+                log_debug("%d ", current_set->states[i]);
             }
-            if (current_set->size > 5) printf("...");
-            printf("}\n");
+            if (current_set->size > 5) log_debug("...");
+            log_debug("}\n");
         }
         
         // Para cada símbolo do alfabeto
@@ -127,12 +131,22 @@ AFD* afn_to_afd(AFN* afn) {
                 
                 if (existing_idx == -1) {
                     // Novo estado descoberto
+                    if (afd_state_count == capacity) {
+                        capacity *= 2;
+                        afd_states = (StateSet**)realloc(afd_states, capacity * sizeof(StateSet*));
+                        worklist = (int*)realloc(worklist, capacity * sizeof(int));
+                        afd->transition_table = (int**)realloc(afd->transition_table, capacity * sizeof(int*));
+                    }
+                    afd->transition_table[afd_state_count] = (int*)malloc(256 * sizeof(int));
+                    for (int j = 0; j < 256; j++) {
+                        afd->transition_table[afd_state_count][j] = -1;
+                    }
                     afd_states[afd_state_count] = new_set;
                     afd->transition_table[current_idx][symbol] = afd_state_count;
                     worklist[worklist_count++] = afd_state_count;
                     
-                    if (iteration <= 20 || iteration % 50 == 0) {
-                        printf("  '%c' (0x%02x) → novo estado %d\n", 
+                    if (log_iteration) {
+                        log_debug("  '%c' (0x%02x) → novo estado %d\n", 
                                (symbol >= 32 && symbol < 127) ? (char)symbol : '?',
                                symbol, afd_state_count);
                     }
@@ -150,14 +164,22 @@ AFD* afn_to_afd(AFN* afn) {
         }
     }
     
-    printf("\n  Iterações totais: %d\n", iteration);
+    log_debug("\n  Iterações totais: %d\n", iteration);
+    free(worklist);
+    afd->num_states = afd_state_count;
+    
+    afd->final_states = (bool*)calloc(afd_state_count, sizeof(bool));
+    afd->token_types = (TokenType*)malloc(afd_state_count * sizeof(TokenType));
+    for (int i = 0; i < afd_state_count; i++) {
+        afd->token_types[i] = TOKEN_ERROR;
+    }
     
     /* ────────────────────────────────────────────────────────────
        FASE 3: IDENTIFICAÇÃO DE ESTADOS FINAIS
        ──────────────────────────────────────────────────────────── */
     
-    printf("\n[FASE 3] Identificando estados finais...\n");
-    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    log_debug("\n[FASE 3] Identificando estados finais...\n");
+    log_debug("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     
     int final_count = 0;
     for (int i = 0; i < afd_state_count; i++) {
@@ -201,8 +223,8 @@ AFD* afn_to_afd(AFN* afn) {
             afd->token_types[i] = best_type;
             final_count++;
             
-            if (final_count <= 30) {
-                printf("  Estado AFD %d é final → %d (%s)\n", i, best_type,
+            if (final_count <= 30 && log_enabled(LOG_DEBUG)) {
+                log_debug("  Estado AFD %d é final → %d (%s)\n", i, best_type,
                        (best_type == TOKEN_INTEGER ? "INTEGER" :
                         best_type == TOKEN_FLOAT ? "FLOAT" :
                         best_type == TOKEN_STRING ? "STRING" :
@@ -215,17 +237,14 @@ AFD* afn_to_afd(AFN* afn) {
         }
     }
     
-    printf("  Total de estados finais: %d\n", final_count);
+    log_debug("  Total de estados finais: %d\n", final_count);
     
     /* ────────────────────────────────────────────────────────────
        FASE 4: FINALIZAÇÃO
        ──────────────────────────────────────────────────────────── */
     
-    printf("\n[FASE 4] Finalizando...\n");
-    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
-    
-    // Redimensiona para o número real de estados
-    afd->num_states = afd_state_count;
+    log_debug("\n[FASE 4] Finalizando...\n");
+    log_debug("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     
     // Libera conjuntos de estados
     for (int i = 0; i < afd_state_count; i++) {
@@ -233,13 +252,265 @@ AFD* afn_to_afd(AFN* afn) {
     }
     free(afd_states);
     
-    printf("\n Conversão concluída com sucesso!\n");
-    printf(" AFD resultante:\n");
-    printf("  - Estados: %d\n", afd->num_states);
-    printf("  - Estados finais: %d\n", final_count);
-    printf("  - Alfabeto: %d\n", afd->alphabet_size);
+    log_debug("\n Conversão concluída com sucesso!\n");
+    log_debug(" AFD resultante:\n");
+    log_debug("  - Estados: %d\n", afd->num_states);
+    log_debug("  - Estados finais: %d\n", final_count);
+    log_debug("  - Alfabeto: %d\n", afd->alphabet_size);
     
-    printf("\n╚════════════════════════════════════════════════════════════╝\n\n");
+    log_debug("\n╚════════════════════════════════════════════════════════════╝\n\n");
     
     return afd;
-}
\ No newline at end of file
+}
+
+/* ============================================================================
+   MINIMIZAÇÃO DO AFD (Algoritmo de Hopcroft)
+   ============================================================================ */
+
+/*
+ * Partição dos estados em blocos. Os estados de cada bloco ficam contíguos em
+ * elems[first..end); os marcados durante um refinamento ficam no início
+ * (elems[first..marked)).
+ */
+typedef struct {
+    int* elems;
+    int* loc;                        // Posição de cada estado em elems
+    int* block;                      // Bloco de cada estado
+    int* first;
+    int* end;
+    int* marked;
+    int count;
+} Partition;
+
+static int partition_add_block(Partition* p, int first, int end) {
+    int b = p->count++;
+    p->first[b] = first;
+    p->end[b] = end;
+    p->marked[b] = first;
+    for (int i = first; i < end; i++) p->block[p->elems[i]] = b;
+    return b;
+}
+
+static void partition_mark(Partition* p, int state) {
+    int b = p->block[state];
+    int pos = p->loc[state];
+    if (pos < p->marked[b]) return;   // Já marcado
+
+    int swap_pos = p->marked[b]++;
+    int other = p->elems[swap_pos];
+    p->elems[swap_pos] = state;
+    p->elems[pos] = other;
+    p->loc[state] = swap_pos;
+    p->loc[other] = pos;
+}
+
+AFD* minimize_afd(AFD* afd) {
+    if (!afd || afd->num_states <= 0) return NULL;
+
+    // Estado extra n: sumidouro que recebe todas as transições ausentes (-1)
+    int n = afd->num_states;
+    int total = n + 1;
+    int sink = n;
+    #define HOPCROFT_NEXT(s, c) ((s) == sink || afd->transition_table[s][c] < 0 ? \
+                                 sink : afd->transition_table[s][c])
+
+    // Transições inversas por símbolo, em formato CSR
+    int* inv_start = calloc((size_t)256 * (total + 1), sizeof(int));
+    int* inv = malloc((size_t)256 * total * sizeof(int));
+    for (int c = 0; c < 256; c++) {
+        int* start = inv_start + (size_t)c * (total + 1);
+        for (int s = 0; s < total; s++) start[HOPCROFT_NEXT(s, c) + 1]++;
+        for (int t = 0; t < total; t++) start[t + 1] += start[t];
+        int* fill = malloc(total * sizeof(int));
+        memcpy(fill, start, total * sizeof(int));
+        for (int s = 0; s < total; s++) {
+            inv[(size_t)c * total + fill[HOPCROFT_NEXT(s, c)]++] = s;
+        }
+        free(fill);
+    }
+
+    Partition p;
+    p.elems = malloc(total * sizeof(int));
+    p.loc = malloc(total * sizeof(int));
+    p.block = malloc(total * sizeof(int));
+    p.first = malloc(total * sizeof(int));
+    p.end = malloc(total * sizeof(int));
+    p.marked = malloc(total * sizeof(int));
+    p.count = 0;
+
+    // Partição inicial: não finais (com o sumidouro) e um bloco por tipo de
+    // token, para que estados que reconhecem tokens diferentes nunca se fundam
+    int filled = 0;
+    for (int type = -1; type <= TOKEN_PRINT; type++) {
+        int first = filled;
+        for (int s = 0; s < total; s++) {
+            bool final = s != sink && afd->final_states[s];
+            int s_type = final ? (int)afd->token_types[s] : -1;
+            if (s_type != type) continue;
+            p.loc[s] = filled;
+            p.elems[filled++] = s;
+        }
+        if (filled > first) partition_add_block(&p, first, filled);
+    }
+
+    // Lista de trabalho de blocos divisores (cada um vale para todos os símbolos)
+    int* worklist = malloc(total * sizeof(int));
+    bool* in_worklist = calloc(total, sizeof(bool));
+    int worklist_count = 0;
+    for (int b = 0; b < p.count; b++) {
+        worklist[worklist_count++] = b;
+        in_worklist[b] = true;
+    }
+
+    int* splitter = malloc(total * sizeof(int));
+    int* touched = malloc(total * sizeof(int));
+
+    while (worklist_count > 0) {
+        int a = worklist[--worklist_count];
+        in_worklist[a] = false;
+
+        // Cópia dos membros: o bloco pode ser dividido durante o refinamento
+        int splitter_size = p.end[a] - p.first[a];
+        memcpy(splitter, p.elems + p.first[a], splitter_size * sizeof(int));
+
+        for (int c = 0; c < 256; c++) {
+            int* start = inv_start + (size_t)c * (total + 1);
+            int touched_count = 0;
+
+            for (int i = 0; i < splitter_size; i++) {
+                int t = splitter[i];
+                for (int k = start[t]; k < start[t + 1]; k++) {
+                    int s = inv[(size_t)c * total + k];
+                    int b = p.block[s];
+                    if (p.marked[b] == p.first[b]) touched[touched_count++] = b;
+                    partition_mark(&p, s);
+                }
+            }
+
+            for (int i = 0; i < touched_count; i++) {
+                int b = touched[i];
+                int mid = p.marked[b];
+                p.marked[b] = p.first[b];
+                if (mid == p.end[b]) continue;   // Bloco inteiro marcado: não divide
+
+                // Parte marcada vira um bloco novo
+                int nb = partition_add_block(&p, p.first[b], mid);
+                p.first[b] = mid;
+                p.marked[b] = mid;
+
+                int size_b = p.end[b] - p.first[b];
+                int size_nb = p.end[nb] - p.first[nb];
+                if (in_worklist[b] || size_nb <= size_b) {
+                    worklist[worklist_count++] = nb;
+                    in_worklist[nb] = true;
+                } else {
+                    worklist[worklist_count++] = b;
+                    in_worklist[b] = true;
+                }
+            }
+        }
+    }
+    #undef HOPCROFT_NEXT
+
+    // Renumera os blocos em ordem de busca em largura a partir do inicial,
+    // descartando o bloco do sumidouro (estados mortos)
+    int* new_id = malloc(p.count * sizeof(int));
+    for (int b = 0; b < p.count; b++) new_id[b] = -1;
+    int* order = malloc(p.count * sizeof(int));
+    int sink_block = p.block[sink];
+    int state_count = 0;
+
+    if (p.block[afd->start_state] != sink_block) {
+        order[state_count] = p.block[afd->start_state];
+        new_id[order[state_count]] = state_count;
+        state_count++;
+    }
+    for (int i = 0; i < state_count; i++) {
+        int rep = p.elems[p.first[order[i]]];
+        for (int c = 0; c < 256; c++) {
+            int t = afd->transition_table[rep][c];
+            if (t < 0) continue;
+            int b = p.block[t];
+            if (b == sink_block || new_id[b] >= 0) continue;
+            new_id[b] = state_count;
+            order[state_count++] = b;
+        }
+    }
+
+    AFD* min = malloc(sizeof(AFD));
+    min->num_states = state_count;
+    min->alphabet_size = afd->alphabet_size;
+    min->start_state = 0;
+    min->num_classes = 0;
+    min->class_table = NULL;
+    min->transition_table = malloc(state_count * sizeof(int*));
+    min->final_states = calloc(state_count, sizeof(bool));
+    min->token_types = malloc(state_count * sizeof(TokenType));
+
+    for (int i = 0; i < state_count; i++) {
+        int rep = p.elems[p.first[order[i]]];
+        min->transition_table[i] = malloc(256 * sizeof(int));
+        for (int c = 0; c < 256; c++) {
+            int t = afd->transition_table[rep][c];
+            min->transition_table[i][c] = t < 0 ? -1 : new_id[p.block[t]];
+        }
+        min->final_states[i] = afd->final_states[rep];
+        min->token_types[i] = afd->token_types[rep];
+    }
+
+    free(new_id);
+    free(order);
+    free(splitter);
+    free(touched);
+    free(worklist);
+    free(in_worklist);
+    free(p.elems);
+    free(p.loc);
+    free(p.block);
+    free(p.first);
+    free(p.end);
+    free(p.marked);
+    free(inv_start);
+    free(inv);
+    return min;
+}
+
+/* ============================================================================
+   COMPRESSÃO DO ALFABETO (Classes de equivalência de bytes)
+   ============================================================================ */
+
+int compress_afd_alphabet(AFD* afd) {
+    if (!afd || !afd->transition_table || afd->num_states > 32767) return -1;
+
+    // Representante (primeiro byte) de cada classe
+    int class_rep[256];
+    int num_classes = 0;
+    for (int c = 0; c < 256; c++) {
+        int found = -1;
+        for (int k = 0; k < num_classes && found < 0; k++) {
+            int r = class_rep[k];
+            bool same = true;
+            for (int s = 0; s < afd->num_states && same; s++) {
+                same = afd->transition_table[s][c] == afd->transition_table[s][r];
+            }
+            if (same) found = k;
+        }
+        if (found < 0) {
+            class_rep[num_classes] = c;
+            found = num_classes++;
+        }
+        afd->byte_class[c] = (unsigned char)found;
+    }
+
+    afd->class_table = malloc((size_t)afd->num_states * num_classes * sizeof(short));
+    for (int s = 0; s < afd->num_states; s++) {
+        for (int k = 0; k < num_classes; k++) {
+            afd->class_table[s * num_classes + k] = (short)afd->transition_table[s][class_rep[k]];
+        }
+        free(afd->transition_table[s]);
+    }
+    free(afd->transition_table);
+    afd->transition_table = NULL;
+    afd->num_classes = num_classes;
+    return num_classes;
+}
@@ -11,6 +11,26 @@
  */
 AFD* afn_to_afd(AFN* afn);
 
+/*
+ * Minimiza um AFD com o algoritmo de Hopcroft. Estados que reconhecem tipos
+ * de token diferentes nunca são fundidos; estados mortos são removidos e o
+ * estado inicial do resultado é 0.
+ *
+ * @param afd O AFD a ser minimizado (não é alterado)
+ * @return AFD* Novo AFD mínimo equivalente
+ */
+AFD* minimize_afd(AFD* afd);
+
+/*
+ * Comprime o alfabeto do AFD em classes de equivalência de bytes: bytes cujas
+ * colunas são idênticas em todos os estados viram uma única coluna de
+ * class_table. A tabela de 256 colunas é liberada.
+ *
+ * @param afd O AFD a ser comprimido (alterado no lugar)
+ * @return int Número de classes de bytes, ou -1 em caso de erro
+ */
+int compress_afd_alphabet(AFD* afd);
+
 /*
  * Exibe a tabela de transições do AFD para debug
  * 
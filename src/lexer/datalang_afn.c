@@ -1,5 +1,6 @@
 #include "datalang_afn.h"
 #include <stdio.h>
+#include "log.h"
 
 /* ============================================================================
    FUNÇÕES DE GERENCIAMENTO DE CONJUNTOS DE ESTADOS
@@ -239,7 +240,7 @@ int integrate_afd_to_afn(
 ) {
     if (!afn_unificado || !afd_transitions || !afd_final_states) return 0;
     
-    printf("  Integrando AFD com %d estados (offset: %d)\n", afd_num_states, state_offset);
+    log_debug("  Integrando AFD com %d estados (offset: %d)\n", afd_num_states, state_offset);
     
     // Adiciona epsilon-transição do estado inicial (0) para o estado inicial do AFD
     add_afn_transition(afn_unificado, 0, EPSILON, state_offset);
@@ -278,9 +279,9 @@ int integrate_afd_to_afn(
    ============================================================================ */
 
 AFN* create_unified_datalang_afn() {
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║  CRIANDO AFN UNIFICADO PARA DATALANG                     ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n");
+    log_debug("\n╔════════════════════════════════════════════════════════════╗\n");
+    log_debug("║  CRIANDO AFN UNIFICADO PARA DATALANG                     ║\n");
+    log_debug("╚════════════════════════════════════════════════════════════╝\n");
     
     // Cria AFN com espaço suficiente para todos os AFDs
     // Estado 0: estado inicial unificado
@@ -298,7 +299,7 @@ AFN* create_unified_datalang_afn() {
     
     AFN* afn = create_afn(total_states, 256);
     if (!afn) {
-        fprintf(stderr, "ERRO: Não foi possível alocar AFN\n");
+        log_error("ERRO: Não foi possível alocar AFN\n");
         return NULL;
     }
     
@@ -306,14 +307,14 @@ AFN* create_unified_datalang_afn() {
     int next_state = 1;
     int final_state;
     
-    printf("\nIntegrando AFDs individuais:\n");
-    printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    log_debug("\nIntegrando AFDs individuais:\n");
+    log_debug("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     
     /* ────────────────────────────────────────────────────────────
        WHITESPACE
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n1. WHITESPACE\n");
+        log_debug("\n1. WHITESPACE\n");
         
         // Cria AFD de whitespace
         int num_states = 2;
@@ -345,7 +346,7 @@ AFN* create_unified_datalang_afn() {
        IDENTIFICADORES E PALAVRAS-CHAVE
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n2. IDENTIFICADORES\n");
+        log_debug("\n2. IDENTIFICADORES\n");
         
         int num_states = 2;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -382,7 +383,7 @@ AFN* create_unified_datalang_afn() {
        NÚMEROS (inteiros, decimais, científicos)
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n3. NÚMEROS\n");
+        log_debug("\n3. NÚMEROS\n");
         
         int num_states = 9;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -463,7 +464,7 @@ AFN* create_unified_datalang_afn() {
        STRINGS
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n4. STRINGS\n");
+        log_debug("\n4. STRINGS\n");
         
         int num_states = 4;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -508,7 +509,7 @@ AFN* create_unified_datalang_afn() {
        OPERADORES
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n5. OPERADORES\n");
+        log_debug("\n5. OPERADORES\n");
         
         int num_states = 25;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -570,7 +571,7 @@ AFN* create_unified_datalang_afn() {
        DELIMITADORES
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n6. DELIMITADORES\n");
+        log_debug("\n6. DELIMITADORES\n");
         
         int num_states = 13;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -607,7 +608,7 @@ AFN* create_unified_datalang_afn() {
        COMENTÁRIOS DE LINHA
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n7. COMENTÁRIOS DE LINHA\n");
+        log_debug("\n7. COMENTÁRIOS DE LINHA\n");
         
         int num_states = 4;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -640,7 +641,7 @@ AFN* create_unified_datalang_afn() {
        COMENTÁRIOS DE BLOCO
        ──────────────────────────────────────────────────────────── */
     {
-        printf("\n8. COMENTÁRIOS DE BLOCO\n");
+        log_debug("\n8. COMENTÁRIOS DE BLOCO\n");
         
         int num_states = 5;
         int** trans = (int**)malloc(num_states * sizeof(int*));
@@ -672,13 +673,13 @@ AFN* create_unified_datalang_afn() {
         free(finals);
     }
     
-    printf("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
-    printf("\nAFN unificado criado com %d estados\n", next_state);
-    printf("Total de transições epsilon: %d\n", afn->transition_counts[0]);
+    log_debug("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+    log_debug("\nAFN unificado criado com %d estados\n", next_state);
+    log_debug("Total de transições epsilon: %d\n", afn->transition_counts[0]);
     
     afn->num_states = next_state;
     
-    printf("\n╚════════════════════════════════════════════════════════════╝\n\n");
+    log_debug("\n╚════════════════════════════════════════════════════════════╝\n\n");
     
     return afn;
 }
@@ -695,6 +696,7 @@ void free_afd(AFD* afd) {
             }
             free(afd->transition_table);
         }
+        free(afd->class_table);
         free(afd->final_states);
         free(afd->token_types);
         free(afd);
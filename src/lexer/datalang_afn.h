@@ -40,9 +40,12 @@ typedef enum {
 } TokenType;
 
 // Estrutura do Token
+// O texto fica no código-fonte (offset, length); lexema só é preenchido
+// para identificadores, palavras-chave e símbolos (string internada)
 typedef struct {
     TokenType type;
     char* lexema;
+    int offset;
     int length;
     int line;
     int column;
@@ -77,9 +80,16 @@ typedef struct {
     int num_states;
     int alphabet_size;
     int start_state;
-    int** transition_table;
+    int** transition_table;          // 256 colunas por estado (NULL após compressão)
     bool* final_states;
     TokenType* token_types;
+
+    // Alfabeto comprimido: bytes com o mesmo comportamento em todos os
+    // estados compartilham uma classe; a transição do estado s com o byte c
+    // é class_table[s * num_classes + byte_class[c]] (-1 sem transição)
+    int num_classes;
+    unsigned char byte_class[256];
+    short* class_table;
 } AFD;
 
 // Funções para conjuntos de estados
@@ -9,67 +9,92 @@
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
-#include "datalang_afn.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lexer.h"
+#include "afn_to_afd.h"
+#include "afd_table.h"
+#include "log.h"
 
 // ==================== BUFFER DE ARQUIVO ====================
 
-typedef struct {
-    char* data;
-    size_t size;
-    size_t capacity;
-} FileBuffer;
+// Entrada padrão ("-"): mapeada se for um arquivo redirecionado, senão lida
+// em blocos (pipes e terminais não podem ser mapeados)
+static bool read_stream_to_buffer(int fd, FileBuffer* buffer) {
+    buffer->capacity = 64 * 1024;
+    buffer->data = malloc(buffer->capacity);
+    buffer->size = 0;
+    if (!buffer->data) return false;
+
+    ssize_t n;
+    while ((n = read(fd, buffer->data + buffer->size, buffer->capacity - buffer->size)) > 0) {
+        buffer->size += (size_t)n;
+        if (buffer->size == buffer->capacity) {
+            buffer->capacity *= 2;
+            char* grown = realloc(buffer->data, buffer->capacity);
+            if (!grown) return false;
+            buffer->data = grown;
+        }
+    }
+    return n == 0;
+}
 
 FileBuffer* read_file_to_buffer(const char* filename) {
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        perror("Erro ao abrir arquivo");
+    bool is_stdin = strcmp(filename, "-") == 0;
+    int fd = is_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_error("Erro ao abrir arquivo: %s\n", strerror(errno));
         return NULL;
     }
 
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    FileBuffer* buffer = (FileBuffer*)malloc(sizeof(FileBuffer));
+    FileBuffer* buffer = (FileBuffer*)calloc(1, sizeof(FileBuffer));
     if (!buffer) {
-        fclose(file);
+        if (!is_stdin) close(fd);
         return NULL;
     }
 
-    buffer->capacity = file_size + 1;
-    buffer->data = (char*)malloc(buffer->capacity);
-    if (!buffer->data) {
-        free(buffer);
-        fclose(file);
-        return NULL;
+    // Arquivos regulares são mapeados somente leitura: o lexer trabalha
+    // direto sobre as páginas do arquivo, sem cópia
+    struct stat st;
+    bool ok;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = map != MAP_FAILED;
+        if (ok) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            buffer->data = map;
+            buffer->size = (size_t)st.st_size;
+            buffer->capacity = buffer->size;
+            buffer->mapped = true;
+        }
+    } else {
+        ok = read_stream_to_buffer(fd, buffer);
     }
 
-    size_t bytes_read = fread(buffer->data, 1, file_size, file);
-    buffer->data[bytes_read] = '\0';
-    buffer->size = bytes_read;
-
-    fclose(file);
+    int read_errno = errno;
+    if (!is_stdin) close(fd);
+    if (!ok) {
+        log_error("Erro ao ler arquivo: %s\n", strerror(read_errno));
+        free_file_buffer(buffer);
+        return NULL;
+    }
     return buffer;
 }
 
 void free_file_buffer(FileBuffer* buffer) {
     if (buffer) {
-        free(buffer->data);
+        if (buffer->mapped) {
+            munmap(buffer->data, buffer->size);
+        } else {
+            free(buffer->data);
+        }
         free(buffer);
     }
 }
 
-static char* c99_strndup(const char* s, size_t n) {
-    size_t len = strnlen(s, n);
-    char* new_str = (char*)malloc(len + 1);
-    if (!new_str) {
-        return NULL;
-    }
-    memcpy(new_str, s, len);
-    new_str[len] = '\0';
-    return new_str;
-}
-
 // ==================== TABELA DE PALAVRAS-CHAVE ====================
 
 typedef struct {
@@ -114,14 +139,74 @@ static const KeywordEntry keywords[] = {
     {NULL, TOKEN_ERROR}
 };
 
-// Busca palavra-chave na tabela
-TokenType lookup_keyword(const char* str) {
+// Operadores e delimitadores: o AFD só informa a classe, a tag da string
+// internada diz qual é o token
+static const KeywordEntry symbols[] = {
+    {"+", TOKEN_PLUS},
+    {"-", TOKEN_MINUS},
+    {"*", TOKEN_MULT},
+    {"/", TOKEN_DIV},
+    {"%", TOKEN_MOD},
+    {"=", TOKEN_ASSIGN},
+    {"==", TOKEN_EQUAL},
+    {"!=", TOKEN_NOT_EQUAL},
+    {"<", TOKEN_LESS},
+    {"<=", TOKEN_LESS_EQUAL},
+    {">", TOKEN_GREATER},
+    {">=", TOKEN_GREATER_EQUAL},
+    {"&&", TOKEN_AND},
+    {"||", TOKEN_OR},
+    {"!", TOKEN_NOT},
+    {"->", TOKEN_ARROW},
+    {"|>", TOKEN_PIPE},
+    {"|", TOKEN_DELIMITER},
+    // Classificados como OPERATOR devido à prioridade sobre DELIMITER na
+    // construção do AFN
+    {".", TOKEN_DOT},
+    {":", TOKEN_COLON},
+    {",", TOKEN_COMMA},
+    {"(", TOKEN_LPAREN},
+    {")", TOKEN_RPAREN},
+    {"[", TOKEN_LBRACKET},
+    {"]", TOKEN_RBRACKET},
+    {"{", TOKEN_LBRACE},
+    {"}", TOKEN_RBRACE},
+    {";", TOKEN_SEMICOLON},
+    {"..", TOKEN_RANGE},
+    {NULL, TOKEN_ERROR}
+};
+
+// Marca palavras-chave e símbolos na tabela de strings internadas com o
+// TokenType correspondente; a classificação vira uma leitura de tag
+static void register_token_names(void) {
+    const char* probe = intern_find("let");
+    if (probe && intern_tag(probe) == TOKEN_LET) return;
     for (int i = 0; keywords[i].keyword != NULL; i++) {
-        if (strcmp(str, keywords[i].keyword) == 0) {
-            return keywords[i].token_type;
-        }
+        intern_set_tag(intern_cstr(keywords[i].keyword), keywords[i].token_type);
+    }
+    for (int i = 0; symbols[i].keyword != NULL; i++) {
+        intern_set_tag(intern_cstr(symbols[i].keyword), symbols[i].token_type);
     }
-    return TOKEN_IDENTIFIER;
+}
+
+// Palavras-chave ficam antes de TOKEN_IDENTIFIER no enum (print é a exceção)
+static bool is_keyword_type(TokenType type) {
+    return type < TOKEN_IDENTIFIER || type == TOKEN_PRINT;
+}
+
+// Tipo de um lexema internado a partir da sua tag (fallback se não houver
+// tag da categoria pedida)
+static TokenType interned_token_type(const char* lexema, bool keyword, TokenType fallback) {
+    int tag = intern_tag(lexema);
+    if (tag == INTERN_NO_TAG || is_keyword_type((TokenType)tag) != keyword) return fallback;
+    return (TokenType)tag;
+}
+
+// Busca palavra-chave na tabela
+TokenType lookup_keyword(const char* str) {
+    register_token_names();
+    const char* interned = intern_find(str);
+    return interned ? interned_token_type(interned, true, TOKEN_IDENTIFIER) : TOKEN_IDENTIFIER;
 }
 
 // ==================== NOMES DOS TOKENS ====================
@@ -202,16 +287,7 @@ const char* token_type_name(TokenType type) {
 
 // ==================== ANALISADOR LÉXICO ====================
 
-typedef struct {
-    const char* input;
-    int position;
-    int line;
-    int column;
-    int length;
-    AFD* afd;
-} Lexer;
-
-Lexer* create_lexer(const char* input, AFD* afd) {
+Lexer* create_lexer(const char* input, size_t length, AFD* afd) {
     Lexer* lexer = (Lexer*)malloc(sizeof(Lexer));
     if (!lexer) return NULL;
     
@@ -219,8 +295,9 @@ Lexer* create_lexer(const char* input, AFD* afd) {
     lexer->position = 0;
     lexer->line = 1;
     lexer->column = 1;
-    lexer->length = strlen(input);
+    lexer->length = (int)length;
     lexer->afd = afd;
+    register_token_names();
     
     return lexer;
 }
@@ -242,9 +319,9 @@ void update_position(Lexer* lexer, int start, int end) {
     }
 }
 
-TokenType fallback_token_type(const char* lexema) {
-    if (strlen(lexema) == 1) {
-        switch (lexema[0]) {
+TokenType fallback_token_type(const char* text, int length) {
+    if (length == 1) {
+        switch (text[0]) {
             case '=': return TOKEN_OPERATOR;
             case '(': return TOKEN_DELIMITER;
             case ')': return TOKEN_DELIMITER;
@@ -279,10 +356,11 @@ Token recognize_token(Lexer* lexer) {
     Token token = {0};
     token.line = lexer->line;
     token.column = lexer->column;
+    token.offset = lexer->position;
     
     if (lexer->position >= lexer->length) {
         token.type = TOKEN_EOF;
-        token.lexema = strdup("");
+        token.lexema = (char*)intern_cstr("");
         return token;
     }
     
@@ -291,15 +369,16 @@ Token recognize_token(Lexer* lexer) {
     int last_final_position = lexer->position;
     int start_position = lexer->position;
     
+    // Tabela comprimida: poucas classes por estado, cabe inteira no cache L1
+    const short* table = lexer->afd->class_table;
+    const unsigned char* byte_class = lexer->afd->byte_class;
+    int num_classes = lexer->afd->num_classes;
+    
     // Estratégia do match mais longo
     while (lexer->position < lexer->length) {
         unsigned char c = lexer->input[lexer->position];
         
-        if (c >= lexer->afd->alphabet_size) {
-            break;
-        }
-        
-        int next_state = lexer->afd->transition_table[current_state][c];
+        int next_state = table[current_state * num_classes + byte_class[c]];
         
         if (next_state < 0) {
             break; // Não há transição
@@ -320,67 +399,24 @@ Token recognize_token(Lexer* lexer) {
         // Match bem-sucedido
         lexer->position = last_final_position;
         token.length = last_final_position - start_position;
-        // token.lexema = strndup(&lexer->input[start_position], token.length);
         token.type = lexer->afd->token_types[last_final_state];
-        
-        // Processamento especial para strings
-        token.lexema = c99_strndup(&lexer->input[start_position], token.length);
-        
-        if (!token.lexema) {
-            fprintf(stderr, "Falha ao alocar lexema!\n");
-            // Lidar com falha de alocação, definindo token.type = TOKEN_ERROR
-            token.type = TOKEN_ERROR;
-            token.lexema = strdup(""); // Um lexema vazio seguro
-        }
+        const char* text = &lexer->input[start_position];
 
         // Se ainda for UNKNOWN, tenta fallback
         if (token.type == TOKEN_ERROR) {
-            token.type = fallback_token_type(token.lexema);
+            token.type = fallback_token_type(text, token.length);
         }
 
-        // Classificação adicional para OPERADORES
-        // O AFD nos diz que "é um operador", aqui descobrimos "qual"
-        if (token.type == TOKEN_OPERATOR) {
-            if (strcmp(token.lexema, "+") == 0) token.type = TOKEN_PLUS;
-            else if (strcmp(token.lexema, "-") == 0) token.type = TOKEN_MINUS;
-            else if (strcmp(token.lexema, "*") == 0) token.type = TOKEN_MULT;
-            else if (strcmp(token.lexema, "/") == 0) token.type = TOKEN_DIV;
-            else if (strcmp(token.lexema, "%") == 0) token.type = TOKEN_MOD;
-            else if (strcmp(token.lexema, "=") == 0) token.type = TOKEN_ASSIGN;
-            else if (strcmp(token.lexema, "==") == 0) token.type = TOKEN_EQUAL;
-            else if (strcmp(token.lexema, "!=") == 0) token.type = TOKEN_NOT_EQUAL;
-            else if (strcmp(token.lexema, "<") == 0) token.type = TOKEN_LESS;
-            else if (strcmp(token.lexema, "<=") == 0) token.type = TOKEN_LESS_EQUAL;
-            else if (strcmp(token.lexema, ">") == 0) token.type = TOKEN_GREATER;
-            else if (strcmp(token.lexema, ">=") == 0) token.type = TOKEN_GREATER_EQUAL;
-            else if (strcmp(token.lexema, "&&") == 0) token.type = TOKEN_AND;
-            else if (strcmp(token.lexema, "||") == 0) token.type = TOKEN_OR;
-            else if (strcmp(token.lexema, "!") == 0) token.type = TOKEN_NOT;
-            else if (strcmp(token.lexema, "->") == 0) token.type = TOKEN_ARROW;
-            else if (strcmp(token.lexema, "|>") == 0) token.type = TOKEN_PIPE;
-            else if (strcmp(token.lexema, "|") == 0) token.type = TOKEN_DELIMITER;
-            // Estes são classificados como OPERATOR devido à prioridade
-            // sobre DELIMITER na construção do AFN
-            else if (strcmp(token.lexema, ".") == 0) token.type = TOKEN_DOT;
-            else if (strcmp(token.lexema, ":") == 0) token.type = TOKEN_COLON;
-            else if (strcmp(token.lexema, ",") == 0) token.type = TOKEN_COMMA;
-        }
-        
-        // Classificação adicional para DELIMITADORES
-        if (token.type == TOKEN_DELIMITER) {
-            if (strcmp(token.lexema, "(") == 0) token.type = TOKEN_LPAREN;
-            else if (strcmp(token.lexema, ")") == 0) token.type = TOKEN_RPAREN;
-            else if (strcmp(token.lexema, "[") == 0) token.type = TOKEN_LBRACKET;
-            else if (strcmp(token.lexema, "]") == 0) token.type = TOKEN_RBRACKET;
-            else if (strcmp(token.lexema, "{") == 0) token.type = TOKEN_LBRACE;
-            else if (strcmp(token.lexema, "}") == 0) token.type = TOKEN_RBRACE;
-            else if (strcmp(token.lexema, ";") == 0) token.type = TOKEN_SEMICOLON;
-            else if (strcmp(token.lexema, "..") == 0) token.type = TOKEN_RANGE;
-        }
-        
-        // Classificação adicional para IDENTIFICADORES
-        if (token.type == TOKEN_IDENTIFIER) {
-            token.type = lookup_keyword(token.lexema);
+        // O AFD nos diz que "é um operador/delimitador/identificador", a tag
+        // da string internada diz "qual". Só nomes são copiados para a tabela
+        // de strings; símbolos já estão registrados e literais, espaços e
+        // comentários ficam apenas como span no código-fonte
+        if (token.type == TOKEN_OPERATOR || token.type == TOKEN_DELIMITER) {
+            token.lexema = (char*)intern_find_n(text, token.length);
+            if (token.lexema) token.type = interned_token_type(token.lexema, false, token.type);
+        } else if (token.type == TOKEN_IDENTIFIER) {
+            token.lexema = (char*)intern(text, token.length);
+            token.type = interned_token_type(token.lexema, true, TOKEN_IDENTIFIER);
         }
         
         // Atualiza linha/coluna
@@ -389,7 +425,6 @@ Token recognize_token(Lexer* lexer) {
     } else {
         // Erro léxico
         token.type = TOKEN_ERROR;
-        token.lexema = c99_strndup(&lexer->input[start_position], 1);
         token.length = 1;
         lexer->position = start_position + 1;
         lexer->column++;
@@ -398,19 +433,28 @@ Token recognize_token(Lexer* lexer) {
     return token;
 }
 
-// ==================== TOKENIZAÇÃO COMPLETA ====================
+/*
+ * Próximo token significativo: espaços e comentários são consumidos aqui e
+ * nunca chegam ao stream.
+ */
+Token next_token(Lexer* lexer) {
+    Token token;
+    do {
+        token = recognize_token(lexer);
+    } while (token.type == TOKEN_WHITESPACE || token.type == TOKEN_COMMENT);
+    return token;
+}
 
-typedef struct {
-    Token* tokens;
-    int count;
-    int capacity;
-} TokenStream;
+// ==================== TOKENIZAÇÃO COMPLETA ====================
 
 TokenStream* create_token_stream() {
     TokenStream* stream = (TokenStream*)malloc(sizeof(TokenStream));
     stream->capacity = 100;
     stream->count = 0;
     stream->tokens = (Token*)malloc(stream->capacity * sizeof(Token));
+    stream->arena = NULL;
+    stream->owns_arena = false;
+    stream->source = NULL;
     return stream;
 }
 
@@ -422,38 +466,34 @@ void add_token(TokenStream* stream, Token token) {
     stream->tokens[stream->count++] = token;
 }
 
+// Os lexemas pertencem à arena: só o vetor de tokens é liberado aqui
 void free_token_stream(TokenStream* stream) {
     if (stream) {
-        for (int i = 0; i < stream->count; i++) {
-            free(stream->tokens[i].lexema);
-        }
+        if (stream->owns_arena) arena_destroy(stream->arena);
         free(stream->tokens);
         free(stream);
     }
 }
 
-TokenStream* tokenize(const char* input, AFD* afd) {
+TokenStream* tokenize(const char* input, size_t length, AFD* afd, Arena* arena) {
     if (!input || !afd) return NULL;
     
-    Lexer* lexer = create_lexer(input, afd);
+    Lexer* lexer = create_lexer(input, length, afd);
     TokenStream* stream = create_token_stream();
+    stream->owns_arena = (arena == NULL);
+    stream->arena = arena ? arena : arena_create(0);
+    stream->source = input;
     
-    while (lexer->position < lexer->length) {
-        Token token = recognize_token(lexer);
-        
-        // Filtra whitespace e comentários
-        if (token.type != TOKEN_WHITESPACE && token.type != TOKEN_COMMENT) {
-            add_token(stream, token);
-        } else {
-            free(token.lexema);
-        }
-        
-        if (token.type == TOKEN_EOF || token.type == TOKEN_ERROR) break;
-    }
+    // next_token já descarta whitespace e comentários e termina em EOF
+    Token token;
+    do {
+        token = next_token(lexer);
+        add_token(stream, token);
+    } while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR);
     
     // Adiciona EOF se necessário
-    if (stream->count == 0 || stream->tokens[stream->count-1].type != TOKEN_EOF) {
-        Token eof_token = {TOKEN_EOF, strdup(""), 0, lexer->line, lexer->column};
+    if (token.type != TOKEN_EOF) {
+        Token eof_token = {TOKEN_EOF, (char*)intern_cstr(""), lexer->position, 0, lexer->line, lexer->column};
         add_token(stream, eof_token);
     }
     
@@ -463,13 +503,37 @@ TokenStream* tokenize(const char* input, AFD* afd) {
 
 // ==================== INTEGRAÇÃO COM AFN->AFD ====================
 
+AFD* create_datalang_afd() {
+    // Copia a tabela pré-compilada (já comprimida por classes de bytes)
+    int num_states = datalang_afd_num_states;
+    int num_classes = datalang_afd_num_classes;
+
+    AFD* afd = malloc(sizeof(AFD));
+    afd->num_states = num_states;
+    afd->alphabet_size = 256;
+    afd->start_state = datalang_afd_start_state;
+    afd->transition_table = NULL;
+    afd->final_states = malloc(num_states * sizeof(bool));
+    afd->token_types = malloc(num_states * sizeof(TokenType));
+    afd->num_classes = num_classes;
+    memcpy(afd->byte_class, datalang_afd_byte_class, sizeof(afd->byte_class));
+    afd->class_table = malloc((size_t)num_states * num_classes * sizeof(short));
+    memcpy(afd->class_table, datalang_afd_transitions, (size_t)num_states * num_classes * sizeof(short));
+
+    for (int s = 0; s < num_states; s++) {
+        afd->final_states[s] = datalang_afd_token_types[s] != TOKEN_ERROR;
+        afd->token_types[s] = (TokenType)datalang_afd_token_types[s];
+    }
+    return afd;
+}
+
 AFD* create_datalang_afd_from_afn() {
-    printf("Criando AFD a partir do AFN unificado...\n");
+    log_debug("Criando AFD a partir do AFN unificado...\n");
     
     // Cria o AFN unificado
     AFN* afn = create_unified_datalang_afn();
     if (!afn) {
-        printf("Erro ao criar AFN unificado\n");
+        log_error("Erro ao criar AFN unificado\n");
         return NULL;
     }
     
@@ -480,11 +544,21 @@ AFD* create_datalang_afd_from_afn() {
     free_afn(afn);
     
     if (!afd) {
-        printf("Erro na conversão AFN -> AFD\n");
+        log_error("Erro na conversão AFN -> AFD\n");
+        return NULL;
+    }
+    
+    // Mesmo formato da tabela pré-compilada: AFD mínimo com alfabeto comprimido
+    AFD* min = minimize_afd(afd);
+    free_afd(afd);
+    if (!min || compress_afd_alphabet(min) < 0) {
+        log_error("Erro na minimização do AFD\n");
+        free_afd(min);
         return NULL;
     }
+    afd = min;
     
-    printf("AFD criado com sucesso: %d estados\n", afd->num_states);
+    log_debug("AFD criado com sucesso: %d estados\n", afd->num_states);
     return afd;
 }
 
@@ -501,11 +575,12 @@ void print_tokens(TokenStream* stream) {
         printf("[%3d] L%03d:C%03d  %-15s", 
                i, t->line, t->column, token_type_name(t->type));
         
-        if (t->lexema && t->lexema[0] != '\0') {
+        if (t->length > 0) {
+            const char* text = stream->source + t->offset;
             if (t->type == TOKEN_STRING) {
-                printf(" %s", t->lexema);
+                printf(" %.*s", t->length, text);
             } else {
-                printf(" '%s'", t->lexema);
+                printf(" '%.*s'", t->length, text);
             }
         }
         printf("\n");
@@ -519,7 +594,7 @@ void print_tokens(TokenStream* stream) {
 void print_afd_info(AFD* afd) {
     printf("\n   Informações do AFD:\n");
     printf("   - Estados: %d\n", afd->num_states);
-    printf("   - Alfabeto: %d símbolos\n", afd->alphabet_size);
+    printf("   - Alfabeto: %d símbolos em %d classes\n", afd->alphabet_size, afd->num_classes);
     printf("   - Estado inicial: %d\n", afd->start_state);
     
     int final_count = 0;
@@ -541,9 +616,9 @@ void test_with_file(const char* filename) {
         return;
     }
     
-    printf("Conteúdo do arquivo (%zu bytes):\n%s\n", buffer->size, buffer->data);
+    printf("Conteúdo do arquivo (%zu bytes):\n%.*s\n", buffer->size, (int)buffer->size, buffer->data);
     
-    AFD* afd = create_datalang_afd_from_afn();
+    AFD* afd = create_datalang_afd();
     if (!afd) {
         free_file_buffer(buffer);
         return;
@@ -551,7 +626,7 @@ void test_with_file(const char* filename) {
     
     print_afd_info(afd);
     
-    TokenStream* stream = tokenize(buffer->data, afd);
+    TokenStream* stream = tokenize(buffer->data, buffer->size, afd, NULL);
     print_tokens(stream);
     
     free_token_stream(stream);
@@ -572,12 +647,12 @@ void test_simple_code() {
     
     printf("Código:\n%s\n", test_code);
     
-    AFD* afd = create_datalang_afd_from_afn();
+    AFD* afd = create_datalang_afd();
     if (!afd) return;
     
     print_afd_info(afd);
     
-    TokenStream* stream = tokenize(test_code, afd);
+    TokenStream* stream = tokenize(test_code, strlen(test_code), afd, NULL);
     print_tokens(stream);
     
     free_token_stream(stream);
@@ -605,10 +680,10 @@ void test_complex_code() {
     
     printf("Código:\n%s\n", test_code);
     
-    AFD* afd = create_datalang_afd_from_afn();
+    AFD* afd = create_datalang_afd();
     if (!afd) return;
     
-    TokenStream* stream = tokenize(test_code, afd);
+    TokenStream* stream = tokenize(test_code, strlen(test_code), afd, NULL);
     print_tokens(stream);
     
     free_token_stream(stream);
@@ -628,10 +703,10 @@ void test_edge_cases() {
     
     printf("Código:\n%s\n", test_code);
     
-    AFD* afd = create_datalang_afd_from_afn();
+    AFD* afd = create_datalang_afd();
     if (!afd) return;
     
-    TokenStream* stream = tokenize(test_code, afd);
+    TokenStream* stream = tokenize(test_code, strlen(test_code), afd, NULL);
     print_tokens(stream);
     
     free_token_stream(stream);
@@ -650,16 +725,16 @@ void test_error_handling() {
     
     printf("Código com erros:\n%s\n", test_code);
     
-    AFD* afd = create_datalang_afd_from_afn();
+    AFD* afd = create_datalang_afd();
     if (!afd) return;
     
-    TokenStream* stream = tokenize(test_code, afd);
+    TokenStream* stream = tokenize(test_code, strlen(test_code), afd, NULL);
     
     printf("Tokens (incluindo erros):\n");
     for (int i = 0; i < stream->count; i++) {
         Token* t = &stream->tokens[i];
         printf("  %-15s", token_type_name(t->type));
-        if (t->lexema) printf(" '%s'", t->lexema);
+        if (t->length > 0) printf(" '%.*s'", t->length, stream->source + t->offset);
         if (t->type == TOKEN_ERROR) printf(" ← ERRO LÉXICO");
         printf("\n");
     }
@@ -7,21 +7,28 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include "datalang_afn.h"
+#include "arena.h"
+#include "intern.h"
 
 // ==================== ESTRUTURAS DE DADOS ====================
 
-// Buffer para armazenar arquivo em memória
+// Código-fonte em memória: mapeado somente leitura (mmap) para arquivos
+// regulares, senão lido para um buffer próprio. Não termina em '\0'.
 typedef struct {
     char* data;
     size_t size;
     size_t capacity;
+    bool mapped;                     // data vem de mmap (liberar com munmap)
 } FileBuffer;
 
-// Stream de tokens
+// Stream de tokens (sem espaços e comentários; os textos são spans de source)
 typedef struct {
     Token* tokens;
     int count;
     int capacity;
+    Arena* arena;
+    bool owns_arena;                 // Arena criada pelo próprio tokenize
+    const char* source;              // Código-fonte tokenizado (não copiado)
 } TokenStream;
 
 // Analisador léxico
@@ -37,8 +44,8 @@ typedef struct {
 // ==================== FUNÇÕES DE BUFFER ====================
 
 /**
- * Lê um arquivo e carrega seu conteúdo em um buffer em memória
- * @param filename Nome do arquivo a ser lido
+ * Carrega um arquivo em memória (mmap somente leitura quando possível)
+ * @param filename Nome do arquivo a ser lido ("-" para a entrada padrão)
  * @return Ponteiro para FileBuffer ou NULL em caso de erro
  */
 FileBuffer* read_file_to_buffer(const char* filename);
@@ -69,11 +76,12 @@ const char* token_type_name(TokenType type);
 
 /**
  * Cria um novo analisador léxico
- * @param input String de entrada a ser tokenizada
+ * @param input String de entrada a ser tokenizada (não precisa terminar em '\0')
+ * @param length Tamanho da entrada em bytes
  * @param afd AFD para reconhecimento de tokens
  * @return Ponteiro para Lexer ou NULL em caso de erro
  */
-Lexer* create_lexer(const char* input, AFD* afd);
+Lexer* create_lexer(const char* input, size_t length, AFD* afd);
 
 /**
  * Libera a memória alocada para um Lexer
@@ -88,6 +96,13 @@ void free_lexer(Lexer* lexer);
  */
 Token recognize_token(Lexer* lexer);
 
+/**
+ * Reconhece o próximo token, descartando espaços e comentários
+ * @param lexer Analisador léxico
+ * @return Próximo token significativo (TOKEN_EOF no fim da entrada)
+ */
+Token next_token(Lexer* lexer);
+
 // ==================== FUNÇÕES DE STREAM DE TOKENS ====================
 
 /**
@@ -112,15 +127,24 @@ void free_token_stream(TokenStream* stream);
 /**
  * Tokeniza uma string de entrada completa
  * @param input String de entrada
+ * @param length Tamanho da entrada em bytes
  * @param afd AFD para reconhecimento
+ * @param arena Arena dos lexemas (NULL cria uma arena própria do stream)
  * @return Stream de tokens resultante
  */
-TokenStream* tokenize(const char* input, AFD* afd);
+TokenStream* tokenize(const char* input, size_t length, AFD* afd, Arena* arena);
 
 // ==================== INTEGRAÇÃO COM AFN/AFD ====================
 
+/**
+ * Carrega o AFD mínimo da DataLang pré-compilado no build (afd_table.h)
+ * @return Ponteiro para AFD (liberar com free_afd)
+ */
+AFD* create_datalang_afd();
+
 /**
  * Cria o AFD unificado para a linguagem DataLang a partir do AFN
+ * (construção completa em tempo de execução; usada para depuração)
  * @return Ponteiro para AFD ou NULL em caso de erro
  */
 AFD* create_datalang_afd_from_afn();
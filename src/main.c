@@ -11,47 +11,93 @@
 #include "lexer/lexer.h"
 #include "parser/parser.h"
 #include "semantic/semantic_analyzer.h"
+#include "semantic/ast_optimizer.h"
 #include "codegen/codegen.h"
+#include "driver/toolchain.h"
+#include "driver/phase_profile.h"
+#include "common/log.h"
 
 // Declarações externas
-extern AFD* create_datalang_afd_from_afn();
-extern TokenStream* tokenize(const char* input, AFD* afd);
+extern AFD* create_datalang_afd();
 extern void free_afd(AFD* afd);
-extern void free_token_stream(TokenStream* stream);
 
 void print_usage(const char* program_name) {
-    printf("Uso: %s <arquivo.datalang> [-o output.ll]\n\n", program_name);
+    printf("Uso: %s <arquivo.datalang>... [-o output.ll | -o programa] [-O0..-O3] [--lto]\n\n", program_name);
+    printf("Vários arquivos formam um único programa, na ordem dada; '-' lê da entrada padrão.\n\n");
     printf("Opções:\n");
-    printf("  -o <arquivo>    Especifica arquivo de saída LLVM IR\n");
+    printf("  -o <arquivo>    Arquivo de saída: LLVM IR se terminar em .ll, senão executável nativo\n");
+    printf("  -O0 .. -O3      Nível de otimização (executáveis usam -O2 por padrão)\n");
+    printf("  --lto           Liga o runtime em bitcode ao programa antes de otimizar\n");
+    printf("  -S, --emit-llvm Gera apenas LLVM IR, mesmo sem extensão .ll\n");
+    printf("  --fast-math     Permite reassociar somas Float (sum/mean vetorizados)\n");
+    printf("  --no-ast-opt    Desativa dobra de constantes e eliminação de código morto\n");
     printf("  -h, --help      Mostra esta ajuda\n");
-    printf("  -v, --verbose   Modo verboso\n");
+    printf("  -v, --verbose   Mostra o progresso das fases (-vv: diagnósticos detalhados)\n");
+    printf("  -q, --quiet     Mostra apenas erros (sem avisos)\n");
     printf("  -V, --verify    Exporta AST para JSON e chama verificador externo (Idris)\n");
     printf("  --verify-json <arquivo>  Caminho do JSON de AST (padrão: ast.json)\n");
-    printf("  --verify-cmd <cmd>       Comando para verificação (padrão: verify/run_verifier.sh)\n\n");
+    printf("  --verify-cmd <cmd>       Comando para verificação (padrão: verify/run_verifier.sh)\n");
+    printf("  --time-phases   Mede cada fase (parede, CPU, arena, heap, RSS) em stderr\n");
+    printf("  --time-phases-json <arquivo>  Também grava as medidas em JSON ('-' para stdout)\n\n");
 }
 
-char* read_file(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "Erro: Não foi possível abrir o arquivo '%s'\n", filename);
-        return NULL;
-    }
-    
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char* content = malloc(size + 1);
-    if (!content) {
-        fclose(file);
-        return NULL;
+// Junta as declarações de um programa ao programa final
+static void append_program(ASTNode* program, ASTNode* part, Arena* arena) {
+    int total = program->program.decl_count + part->program.decl_count;
+    ASTNode** decls = arena_alloc(arena, (total > 0 ? total : 1) * sizeof(ASTNode*));
+    memcpy(decls, program->program.declarations, program->program.decl_count * sizeof(ASTNode*));
+    memcpy(decls + program->program.decl_count, part->program.declarations,
+           part->program.decl_count * sizeof(ASTNode*));
+    program->program.declarations = decls;
+    program->program.decl_count = total;
+}
+
+/*
+ * Lê e analisa os arquivos de entrada em ordem; as declarações de todos
+ * formam um único programa. Cada fonte é mapeada (mmap) e liberada logo
+ * após o seu parse: a AST só guarda strings internadas na arena.
+ */
+static ASTNode* parse_inputs(const char** files, int count, AFD* afd, Arena* arena) {
+    ASTNode* program = NULL;
+    for (int i = 0; i < count; i++) {
+        FileBuffer* source = read_file_to_buffer(files[i]);
+        if (!source) {
+            log_error("Erro: Não foi possível ler '%s'\n", files[i]);
+            return NULL;
+        }
+
+        // O parser puxa os tokens do lexer sob demanda; só uma janela de
+        // PARSER_TOKEN_WINDOW tokens fica em memória
+        Parser* parser = create_parser(source->data, source->size, afd, arena);
+        ASTNode* ast = parser ? parse(parser) : NULL;
+        bool failed = !ast || parser->had_error;
+        if (failed && count > 1) {
+            log_error("Erro: falha na análise de '%s'\n", files[i]);
+        }
+        free_parser(parser);
+        free_file_buffer(source);
+        if (failed) return NULL;
+
+        if (!program) {
+            program = ast;
+        } else {
+            append_program(program, ast, arena);
+        }
     }
-    
-    size_t read_size = fread(content, 1, size, file);
-    content[read_size] = '\0';
-    fclose(file);
-    
-    return content;
+    return program;
+}
+
+/*
+ * Libera o estado da compilação (analyzer pode ser NULL). Usada por todos
+ * os caminhos de saída, inclusive os de erro: encerra a fase em andamento
+ * antes que a arena medida por ela seja destruída.
+ */
+static void free_compilation(SemanticAnalyzer* analyzer, Arena* arena, AFD* afd) {
+    phase_end();
+    if (analyzer) free_semantic_analyzer(analyzer);
+    interner_reset();
+    arena_destroy(arena);
+    free_afd(afd);
 }
 
 int main(int argc, char** argv) {
@@ -61,19 +107,28 @@ int main(int argc, char** argv) {
         return 1;
     }
     
-    char* input_file = NULL;
+    const char** input_files = malloc(argc * sizeof(char*));
+    int input_count = 0;
     char* output_file = NULL;
-    bool verbose = false;
+    LogLevel log_level = LOG_WARN;
     bool verify = false;
     char* verify_json = "ast.json";
     char* verify_cmd = NULL;
+    ToolchainOptions toolchain = { .opt_level = -1, .lto = false };
+    bool emit_llvm = false;
+    bool fast_math = false;
+    bool ast_opt = true;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
         } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
-            verbose = true;
+            if (log_level < LOG_DEBUG) log_level++;
+        } else if (strcmp(argv[i], "-vv") == 0) {
+            log_level = LOG_DEBUG;
+        } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            log_level = LOG_ERROR;
         } else if (strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verify") == 0) {
             verify = true;
         } else if (strcmp(argv[i], "--verify-json") == 0) {
@@ -81,7 +136,7 @@ int main(int argc, char** argv) {
                 verify_json = argv[++i];
                 verify = true;
             } else {
-                fprintf(stderr, "Erro: --verify-json requer um caminho\n");
+                log_error("Erro: --verify-json requer um caminho\n");
                 return 1;
             }
         } else if (strcmp(argv[i], "--verify-cmd") == 0) {
@@ -89,148 +144,199 @@ int main(int argc, char** argv) {
                 verify_cmd = argv[++i];
                 verify = true;
             } else {
-                fprintf(stderr, "Erro: --verify-cmd requer um comando\n");
+                log_error("Erro: --verify-cmd requer um comando\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time-phases") == 0) {
+            phase_profile_enable(NULL);
+        } else if (strcmp(argv[i], "--time-phases-json") == 0) {
+            if (i + 1 < argc) {
+                phase_profile_enable(argv[++i]);
+            } else {
+                log_error("Erro: --time-phases-json requer um caminho\n");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "-O", 2) == 0) {
+            const char* level = argv[i] + 2;
+            if (*level == '\0') {
+                toolchain.opt_level = 2;
+            } else if (level[0] >= '0' && level[0] <= '3' && level[1] == '\0') {
+                toolchain.opt_level = level[0] - '0';
+            } else {
+                log_error("Erro: nível de otimização inválido '%s' (use -O0 a -O3)\n", argv[i]);
                 return 1;
             }
+        } else if (strcmp(argv[i], "--lto") == 0) {
+            toolchain.lto = true;
+        } else if (strcmp(argv[i], "-S") == 0 || strcmp(argv[i], "--emit-llvm") == 0) {
+            emit_llvm = true;
+        } else if (strcmp(argv[i], "--fast-math") == 0 || strcmp(argv[i], "-ffast-math") == 0) {
+            fast_math = true;
+        } else if (strcmp(argv[i], "--no-ast-opt") == 0) {
+            ast_opt = false;
         } else if (strcmp(argv[i], "-o") == 0) {
             if (i + 1 < argc) {
                 output_file = argv[++i];
             } else {
-                fprintf(stderr, "Erro: Opção -o requer um argumento\n");
+                log_error("Erro: Opção -o requer um argumento\n");
                 return 1;
             }
         } else {
-            input_file = argv[i];
+            input_files[input_count++] = argv[i];
         }
     }
     
-    if (verbose) {
-        printf("Modo verboso ativado.\n");
-    }
+    // Silencioso por padrão: só erros e avisos
+    log_set_level(log_level);
     
-    if (!input_file) {
-        fprintf(stderr, "Erro: Nenhum arquivo de entrada especificado\n");
+    if (input_count == 0) {
+        log_error("Erro: Nenhum arquivo de entrada especificado\n");
         print_usage(argv[0]);
         return 1;
     }
     
-    // Define arquivo de saída padrão
+    // Executável nativo quando a saída não é .ll (ou quando só -O/--lto foi
+    // pedido sem -o); senão o comportamento clássico: apenas LLVM IR
+    bool build_exe = false;
+    if (output_file) {
+        size_t len = strlen(output_file);
+        build_exe = !emit_llvm && !(len >= 3 && strcmp(output_file + len - 3, ".ll") == 0);
+    } else {
+        build_exe = !emit_llvm && (toolchain.opt_level >= 0 || toolchain.lto);
+    }
+    if (build_exe && toolchain.opt_level < 0) toolchain.opt_level = 2;
+    
+    // Define arquivo de saída padrão (a partir do primeiro arquivo de entrada)
     if (!output_file) {
+        const char* input_file = strcmp(input_files[0], "-") == 0 ? "stdin" : input_files[0];
         output_file = malloc(strlen(input_file) + 4);
         strcpy(output_file, input_file);
         char* dot = strrchr(output_file, '.');
         if (dot) *dot = '\0';
-        strcat(output_file, ".ll");
+        if (!build_exe) strcat(output_file, ".ll");
     }
     
-    printf("Compilando: %s -> %s\n", input_file, output_file);
+    // Com executável, o IR vai para <saída>.ll e é removido após o link
+    char* ir_file = output_file;
+    if (build_exe) {
+        ir_file = malloc(strlen(output_file) + 4);
+        sprintf(ir_file, "%s.ll", output_file);
+    }
     
-    // FASE 1: LEITURA
-    char* source_code = read_file(input_file);
-    if (!source_code) return 1;
+    if (log_enabled(LOG_INFO)) {
+        log_info("Compilando:");
+        for (int i = 0; i < input_count; i++) log_info(" %s", input_files[i]);
+        log_info(" -> %s\n", output_file);
+    }
     
-    // FASE 2: LÉXICO
-    AFD* afd = create_datalang_afd_from_afn();
+    phase_begin("afd", NULL);
+    AFD* afd = create_datalang_afd();
+    phase_end();
     if (!afd) {
-        free(source_code);
+        free(input_files);
         return 1;
     }
     
-    TokenStream* tokens = tokenize(source_code, afd);
-    if (!tokens) {
-        free_afd(afd);
-        free(source_code);
-        return 1;
-    }
+    // AST, tipos, símbolos, strings internadas e temporários do codegen
+    // vivem nesta arena e são liberados de uma vez no fim da compilação
+    Arena* arena = arena_create(0);
+    interner_init(arena);
     
-    // FASE 3: SINTÁTICO
-    Parser* parser = create_parser(tokens);
-    ASTNode* ast = parse(parser);
-    if (!ast || parser->had_error) {
-        if (ast) free_ast(ast);
-        free_parser(parser);
-        free_token_stream(tokens);
-        free_afd(afd);
-        free(source_code);
+    // FASES 1-3: LEITURA (mmap), LÉXICO E SINTÁTICO, arquivo a arquivo.
+    // O lexer alimenta o parser sob demanda, então as três são medidas juntas
+    phase_begin("frontend", arena);
+    ASTNode* ast = parse_inputs(input_files, input_count, afd, arena);
+    phase_end();
+    free(input_files);
+    if (!ast) {
+        free_compilation(NULL, arena, afd);
         return 1;
     }
     
     // FASE 4: SEMÂNTICO
-    SemanticAnalyzer* analyzer = create_semantic_analyzer();
-    if (!analyze_semantics(analyzer, ast)) {
-        free_semantic_analyzer(analyzer);
-        free_ast(ast);
-        free_parser(parser);
-        free_token_stream(tokens);
-        free_afd(afd);
-        free(source_code);
+    phase_begin("semantic", arena);
+    SemanticAnalyzer* analyzer = create_semantic_analyzer(arena);
+    bool semantic_ok = analyze_semantics(analyzer, ast);
+    phase_end();
+    if (!semantic_ok) {
+        free_compilation(analyzer, arena, afd);
         return 1;
     }
 
     if (verify) {
         const char* cmd = verify_cmd ? verify_cmd : "verify/run_verifier.sh";
+        phase_begin("verify", arena);
         if (!write_ast_json(ast, verify_json)) {
-            fprintf(stderr, "Erro: não foi possível salvar AST em %s\n", verify_json);
-            free_semantic_analyzer(analyzer);
-            free_ast(ast);
-            free_parser(parser);
-            free_token_stream(tokens);
-            free_afd(afd);
-            free(source_code);
+            log_error("Erro: não foi possível salvar AST em %s\n", verify_json);
+            free_compilation(analyzer, arena, afd);
             return 1;
         }
         char command[1024];
         snprintf(command, sizeof(command), "%s %s", cmd, verify_json);
-        printf("[Verify] Executando: %s\n", command);
+        log_info("[Verify] Executando: %s\n", command);
         int rc = system(command);
         if (rc != 0) {
-            fprintf(stderr, "Verificador externo retornou código %d\n", rc);
-            free_semantic_analyzer(analyzer);
-            free_ast(ast);
-            free_parser(parser);
-            free_token_stream(tokens);
-            free_afd(afd);
-            free(source_code);
+            log_error("Verificador externo retornou código %d\n", rc);
+            free_compilation(analyzer, arena, afd);
             return 1;
         }
-        printf("[Verify] Verificação externa concluída com sucesso\n");
+        phase_end();
+        log_info("[Verify] Verificação externa concluída com sucesso\n");
     }
     
+    // OTIMIZAÇÃO DA AST (após a verificação externa, que vê a AST original)
+    if (ast_opt) {
+        ASTOptimizerStats opt_stats;
+        phase_begin("ast_opt", arena);
+        optimize_ast(ast, arena, &opt_stats);
+        phase_end();
+        log_info("[Otimizador] %d expressões dobradas, %d constantes propagadas, "
+                 "%d ramos e %d statements mortos removidos, %d funções não usadas removidas\n",
+                 opt_stats.folded, opt_stats.propagated, opt_stats.branches_removed,
+                 opt_stats.statements_removed, opt_stats.functions_removed);
+    }
+
     // FASE 5: GERAÇÃO DE CÓDIGO
-    FILE* output = fopen(output_file, "w");
+    phase_begin("codegen", arena);
+    FILE* output = fopen(ir_file, "w");
     if (!output) {
-        free_semantic_analyzer(analyzer);
-        free_ast(ast);
-        free_parser(parser);
-        free_token_stream(tokens);
-        free_afd(afd);
-        free(source_code);
+        log_error("Erro: Não foi possível criar o arquivo '%s'\n", ir_file);
+        free_compilation(analyzer, arena, afd);
         return 1;
     }
     
     CodeGenContext* codegen = create_codegen_context(analyzer, output);
+    codegen->fast_math = fast_math;
     if (!generate_llvm_ir(codegen, ast)) {
         fclose(output);
         free_codegen_context(codegen);
-        free_semantic_analyzer(analyzer);
-        free_ast(ast);
-        free_parser(parser);
-        free_token_stream(tokens);
-        free_afd(afd);
-        free(source_code);
+        free_compilation(analyzer, arena, afd);
         return 1;
     }
     
     fclose(output);
-    printf("Sucesso! Código gerado em %s\n", output_file);
-    
     free_codegen_context(codegen);
-    free_semantic_analyzer(analyzer);
-    free_ast(ast);
-    free_parser(parser);
-    free_token_stream(tokens);
-    free_afd(afd);
-    free(source_code);
+    free_compilation(analyzer, arena, afd);
+    
+    // FASE 6: OTIMIZAÇÃO / EXECUTÁVEL NATIVO
+    int status = 0;
+    phase_begin("toolchain", NULL);
+    if (build_exe) {
+        if (build_executable(ir_file, output_file, &toolchain)) {
+            remove(ir_file);
+            log_info("Sucesso! Executável gerado em %s (-O%d%s)\n",
+                     output_file, toolchain.opt_level, toolchain.lto ? ", LTO" : "");
+        } else {
+            log_error("Erro: falha ao gerar executável (IR mantido em %s)\n", ir_file);
+            status = 1;
+        }
+        free(ir_file);
+    } else if (optimize_ir_file(ir_file, &toolchain)) {
+        log_info("Sucesso! Código gerado em %s\n", output_file);
+    } else {
+        status = 1;
+    }
+    phase_end();
 
     if (output_file) {
         bool should_free = true;
@@ -244,5 +350,5 @@ int main(int argc, char** argv) {
             free(output_file);
         }
     }
-    return 0;
+    return status;
 }
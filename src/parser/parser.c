@@ -9,6 +9,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include "parser.h"
+#include "log.h"
 
 // ==================== DECLARAÇÕES FORWARD ====================
 
@@ -22,7 +23,7 @@ void error_at(Parser* p, Token* token, const char* message);
 void error(Parser* p, const char* message);
 Token* consume(Parser* p, TokenType type, const char* message);
 void synchronize(Parser* p);
-ASTNode* create_node(ASTNodeType type, int line, int column);
+ASTNode* create_node(Arena* arena, ASTNodeType type, int line, int column);
 
 ASTNode* parse_program(Parser* p);
 ASTNode* parse_let_decl(Parser* p);
@@ -43,15 +44,32 @@ extern ASTNode* parse_expression(Parser* p);
 
 // ==================== UTILITÁRIOS ====================
 
+#define TOKEN_SLOT(p, index) (&(p)->tokens[(index) & (PARSER_TOKEN_WINDOW - 1)])
+
+// Lê o próximo token do lexer para a janela. Depois de um erro léxico o
+// fluxo termina com EOF, como no tokenize.
+static void fill_token(Parser* p) {
+    Token token;
+    if (p->token_count > 0 && TOKEN_SLOT(p, p->token_count - 1)->type == TOKEN_ERROR) {
+        Lexer* lexer = p->lexer;
+        token = (Token){TOKEN_EOF, (char*)intern_cstr(""), lexer->position, 0, lexer->line, lexer->column};
+    } else {
+        token = next_token(p->lexer);
+    }
+    *TOKEN_SLOT(p, p->token_count) = token;
+    p->token_count++;
+}
+
 Token* peek(Parser* p) {
+    // advance nunca passa do EOF, então só falta ler quando current é novo
     if (p->current >= p->token_count) {
-        return &p->tokens[p->token_count - 1];
+        fill_token(p);
     }
-    return &p->tokens[p->current];
+    return TOKEN_SLOT(p, p->current);
 }
 
 Token* previous(Parser* p) {
-    return &p->tokens[p->current - 1];
+    return TOKEN_SLOT(p, p->current - 1);
 }
 
 Token* advance(Parser* p) {
@@ -103,11 +121,11 @@ void error_at(Parser* p, Token* token, const char* message) {
     
     char buffer[512];
     snprintf(buffer, sizeof(buffer), 
-        "Erro [linha %d, coluna %d]: %s próximo a '%s'",
-        token->line, token->column, message, token->lexema);
+        "Erro [linha %d, coluna %d]: %s próximo a '%.*s'",
+        token->line, token->column, message, token->length, p->source + token->offset);
     
     p->error_messages[p->error_count++] = strdup(buffer);
-    fprintf(stderr, "%s\n", buffer);
+    log_error("%s\n", buffer);
 }
 
 void error(Parser* p, const char* message) {
@@ -151,25 +169,29 @@ void synchronize(Parser* p) {
 
 // ==================== CRIAÇÃO DE NODOS ====================
 
-ASTNode* create_node(ASTNodeType type, int line, int column) {
-    ASTNode* node = calloc(1, sizeof(ASTNode));
-    if (!node) {
-        fprintf(stderr, "Erro: Falha ao alocar memória para nodo AST\n");
-        exit(1);
-    }
+// Nodos, nomes e vetores da AST vivem na arena da compilação
+ASTNode* create_node(Arena* arena, ASTNodeType type, int line, int column) {
+    ASTNode* node = arena_calloc(arena, 1, sizeof(ASTNode));
     node->type = type;
     node->line = line;
     node->column = column;
     return node;
 }
 
+// Dobra a capacidade de um vetor da AST (cresce no lugar quando possível)
+void* parser_grow_array(Parser* p, void* items, int* capacity, size_t elem_size) {
+    size_t old_size = (size_t)*capacity * elem_size;
+    *capacity *= 2;
+    return arena_realloc(p->arena, items, old_size, (size_t)*capacity * elem_size);
+}
+
 // ==================== PARSING PRINCIPAL ====================
 
 ASTNode* parse_program(Parser* p) {
-    ASTNode* program = create_node(AST_PROGRAM, 1, 1);
+    ASTNode* program = create_node(p->arena, AST_PROGRAM, 1, 1);
     
     int capacity = 10;
-    program->program.declarations = malloc(capacity * sizeof(ASTNode*));
+    program->program.declarations = arena_alloc(p->arena, capacity * sizeof(ASTNode*));
     program->program.decl_count = 0;
     
     while (!is_at_end(p)) {
@@ -189,11 +211,7 @@ ASTNode* parse_program(Parser* p) {
 
         if (decl != NULL) {
             if (program->program.decl_count >= capacity) {
-                capacity *= 2;
-                program->program.declarations = realloc(
-                    program->program.declarations,
-                    capacity * sizeof(ASTNode*)
-                );
+                program->program.declarations = parser_grow_array(p, program->program.declarations, &capacity, sizeof(ASTNode*));
             }
             program->program.declarations[program->program.decl_count++] = decl;
         } else {
@@ -210,14 +228,13 @@ ASTNode* parse_let_decl(Parser* p) {
     Token* let_token = consume(p, TOKEN_LET, "Esperado 'let'");
     if (!let_token) return NULL;
     
-    ASTNode* node = create_node(AST_LET_DECL, let_token->line, let_token->column);
+    ASTNode* node = create_node(p->arena, AST_LET_DECL, let_token->line, let_token->column);
     
     Token* name = consume(p, TOKEN_IDENTIFIER, "Esperado nome da variável");
     if (!name) {
-        free_ast(node);
         return NULL;
     }
-    node->let_decl.name = strdup(name->lexema);
+    node->let_decl.name = name->lexema;
     
     if (match(p, 1, TOKEN_COLON)) {
         node->let_decl.type_annotation = parse_type(p);
@@ -236,19 +253,18 @@ ASTNode* parse_fn_decl(Parser* p) {
     Token* fn_token = consume(p, TOKEN_FN, "Esperado 'fn'");
     if (!fn_token) return NULL;
     
-    ASTNode* node = create_node(AST_FN_DECL, fn_token->line, fn_token->column);
+    ASTNode* node = create_node(p->arena, AST_FN_DECL, fn_token->line, fn_token->column);
     
     Token* name = consume(p, TOKEN_IDENTIFIER, "Esperado nome da função");
     if (!name) {
-        free_ast(node);
         return NULL;
     }
-    node->fn_decl.name = strdup(name->lexema);
+    node->fn_decl.name = name->lexema;
     
     consume(p, TOKEN_LPAREN, "Esperado '(' após nome da função");
     
     int param_capacity = 5;
-    node->fn_decl.params = malloc(param_capacity * sizeof(ASTNode*));
+    node->fn_decl.params = arena_alloc(p->arena, param_capacity * sizeof(ASTNode*));
     node->fn_decl.param_count = 0;
     
     if (!check(p, TOKEN_RPAREN)) {
@@ -256,17 +272,14 @@ ASTNode* parse_fn_decl(Parser* p) {
             Token* param_name = consume(p, TOKEN_IDENTIFIER, "Esperado nome do parâmetro");
             if (!param_name) break;
             
-            consume(p, TOKEN_COLON, "Esperado ':' após nome do parâmetro");
-            ASTNode* param_type = parse_type(p);
+            ASTNode* param = create_node(p->arena, AST_PARAM, param_name->line, param_name->column);
+            param->param.param_name = param_name->lexema;
             
-            ASTNode* param = create_node(AST_PARAM, param_name->line, param_name->column);
-            param->param.param_name = strdup(param_name->lexema);
-            param->param.param_type = param_type;
+            consume(p, TOKEN_COLON, "Esperado ':' após nome do parâmetro");
+            param->param.param_type = parse_type(p);
             
             if (node->fn_decl.param_count >= param_capacity) {
-                param_capacity *= 2;
-                node->fn_decl.params = realloc(node->fn_decl.params, 
-                    param_capacity * sizeof(ASTNode*));
+                node->fn_decl.params = parser_grow_array(p, node->fn_decl.params, &param_capacity, sizeof(ASTNode*));
             }
             node->fn_decl.params[node->fn_decl.param_count++] = param;
             
@@ -290,37 +303,33 @@ ASTNode* parse_data_decl(Parser* p) {
     Token* data_token = consume(p, TOKEN_DATA, "Esperado 'data'");
     if (!data_token) return NULL;
     
-    ASTNode* node = create_node(AST_DATA_DECL, data_token->line, data_token->column);
+    ASTNode* node = create_node(p->arena, AST_DATA_DECL, data_token->line, data_token->column);
     
     Token* name = consume(p, TOKEN_IDENTIFIER, "Esperado nome do tipo de dado");
     if (!name) {
-        free_ast(node);
         return NULL;
     }
-    node->data_decl.name = strdup(name->lexema);
+    node->data_decl.name = name->lexema;
     
     consume(p, TOKEN_LBRACE, "Esperado '{' antes dos campos");
     
     int field_capacity = 5;
-    node->data_decl.fields = malloc(field_capacity * sizeof(ASTNode*));
+    node->data_decl.fields = arena_alloc(p->arena, field_capacity * sizeof(ASTNode*));
     node->data_decl.field_count = 0;
     
     while (!check(p, TOKEN_RBRACE) && !is_at_end(p)) {
         Token* field_name = consume(p, TOKEN_IDENTIFIER, "Esperado nome do campo");
         if (!field_name) break;
         
+        ASTNode* field = create_node(p->arena, AST_FIELD_DECL, field_name->line, field_name->column);
+        field->field_decl.field_name = field_name->lexema;
+        
         consume(p, TOKEN_COLON, "Esperado ':' após nome do campo");
-        ASTNode* field_type = parse_type(p);
+        field->field_decl.field_type = parse_type(p);
         consume(p, TOKEN_SEMICOLON, "Esperado ';' após campo");
         
-        ASTNode* field = create_node(AST_FIELD_DECL, field_name->line, field_name->column);
-        field->field_decl.field_name = strdup(field_name->lexema);
-        field->field_decl.field_type = field_type;
-        
         if (node->data_decl.field_count >= field_capacity) {
-            field_capacity *= 2;
-            node->data_decl.fields = realloc(node->data_decl.fields,
-                field_capacity * sizeof(ASTNode*));
+            node->data_decl.fields = parser_grow_array(p, node->data_decl.fields, &field_capacity, sizeof(ASTNode*));
         }
         node->data_decl.fields[node->data_decl.field_count++] = field;
     }
@@ -334,14 +343,13 @@ ASTNode* parse_import_decl(Parser* p) {
     Token* import_token = consume(p, TOKEN_IMPORT, "Esperado 'import'");
     if (!import_token) return NULL;
     
-    ASTNode* node = create_node(AST_IMPORT_DECL, import_token->line, import_token->column);
+    ASTNode* node = create_node(p->arena, AST_IMPORT_DECL, import_token->line, import_token->column);
     
     Token* path = consume(p, TOKEN_STRING, "Esperado caminho do módulo");
     if (!path) {
-        free_ast(node);
         return NULL;
     }
-    node->import_decl.module_path = strdup(path->lexema);
+    node->import_decl.module_path = (char*)intern(p->source + path->offset, path->length);
     
     if (match(p, 1, TOKEN_AS)) {
         Token* alias = NULL;
@@ -353,7 +361,7 @@ ASTNode* parse_import_decl(Parser* p) {
             alias = consume(p, TOKEN_IDENTIFIER, "Esperado identificador após 'as'");
         }
         if (alias) {
-            node->import_decl.alias = strdup(alias->lexema);
+            node->import_decl.alias = alias->lexema;
         }
     } else {
         node->import_decl.alias = NULL;
@@ -368,14 +376,13 @@ ASTNode* parse_export_decl(Parser* p) {
     Token* export_token = consume(p, TOKEN_EXPORT, "Esperado 'export'");
     if (!export_token) return NULL;
     
-    ASTNode* node = create_node(AST_EXPORT_DECL, export_token->line, export_token->column);
+    ASTNode* node = create_node(p->arena, AST_EXPORT_DECL, export_token->line, export_token->column);
     
     Token* name = consume(p, TOKEN_IDENTIFIER, "Esperado nome para exportar");
     if (!name) {
-        free_ast(node);
         return NULL;
     }
-    node->export_decl.export_name = strdup(name->lexema);
+    node->export_decl.export_name = name->lexema;
     
     consume(p, TOKEN_SEMICOLON, "Esperado ';' após export");
     
@@ -384,20 +391,20 @@ ASTNode* parse_export_decl(Parser* p) {
 
 ASTNode* parse_type(Parser* p) {
     Token* current = peek(p);
-    ASTNode* node = create_node(AST_TYPE, current->line, current->column);
+    ASTNode* node = create_node(p->arena, AST_TYPE, current->line, current->column);
     
     if (match(p, 7, TOKEN_INT_TYPE, TOKEN_FLOAT_TYPE, TOKEN_STRING_TYPE,
                TOKEN_BOOL_TYPE, TOKEN_DATAFRAME_TYPE, TOKEN_VECTOR_TYPE, 
                TOKEN_SERIES_TYPE)) {
         node->type_node.type_kind = previous(p)->type;
-        node->type_node.type_name = strdup(previous(p)->lexema);
+        node->type_node.type_name = previous(p)->lexema;
         node->type_node.inner_type = NULL;
         return node;
     }
     
     if (match(p, 1, TOKEN_IDENTIFIER)) {
         node->type_node.type_kind = TOKEN_IDENTIFIER;
-        node->type_node.type_name = strdup(previous(p)->lexema);
+        node->type_node.type_name = previous(p)->lexema;
         node->type_node.inner_type = NULL;
         return node;
     }
@@ -412,14 +419,12 @@ ASTNode* parse_type(Parser* p) {
     if (match(p, 1, TOKEN_LPAREN)) {
         node->type_node.type_kind = TOKEN_LPAREN;
         int capacity = 5;
-        node->type_node.tuple_types = malloc(capacity * sizeof(ASTNode*));
+        node->type_node.tuple_types = arena_alloc(p->arena, capacity * sizeof(ASTNode*));
         node->type_node.tuple_type_count = 0;
         
         do {
             if (node->type_node.tuple_type_count >= capacity) {
-                capacity *= 2;
-                node->type_node.tuple_types = realloc(node->type_node.tuple_types,
-                    capacity * sizeof(ASTNode*));
+                node->type_node.tuple_types = parser_grow_array(p, node->type_node.tuple_types, &capacity, sizeof(ASTNode*));
             }
             node->type_node.tuple_types[node->type_node.tuple_type_count++] = 
                 parse_type(p);
@@ -430,7 +435,6 @@ ASTNode* parse_type(Parser* p) {
     }
     
     error(p, "Esperado tipo");
-    free_ast(node);
     return NULL;
 }
 
@@ -440,19 +444,17 @@ ASTNode* parse_block(Parser* p) {
     Token* brace = consume(p, TOKEN_LBRACE, "Esperado '{'");
     if (!brace) return NULL;
     
-    ASTNode* node = create_node(AST_BLOCK, brace->line, brace->column);
+    ASTNode* node = create_node(p->arena, AST_BLOCK, brace->line, brace->column);
     
     int capacity = 10;
-    node->block.statements = malloc(capacity * sizeof(ASTNode*));
+    node->block.statements = arena_alloc(p->arena, capacity * sizeof(ASTNode*));
     node->block.stmt_count = 0;
     
     while (!check(p, TOKEN_RBRACE) && !is_at_end(p)) {
         ASTNode* stmt = parse_statement(p);
         if (stmt != NULL) {
             if (node->block.stmt_count >= capacity) {
-                capacity *= 2;
-                node->block.statements = realloc(node->block.statements,
-                    capacity * sizeof(ASTNode*));
+                node->block.statements = parser_grow_array(p, node->block.statements, &capacity, sizeof(ASTNode*));
             }
             node->block.statements[node->block.stmt_count++] = stmt;
         }
@@ -491,7 +493,7 @@ ASTNode* parse_if_statement(Parser* p) {
     Token* if_token = consume(p, TOKEN_IF, "Esperado 'if'");
     if (!if_token) return NULL;
     
-    ASTNode* node = create_node(AST_IF_STMT, if_token->line, if_token->column);
+    ASTNode* node = create_node(p->arena, AST_IF_STMT, if_token->line, if_token->column);
     
     node->if_stmt.condition = parse_expression(p);
     node->if_stmt.then_block = parse_block(p);
@@ -513,14 +515,13 @@ ASTNode* parse_for_statement(Parser* p) {
     Token* for_token = consume(p, TOKEN_FOR, "Esperado 'for'");
     if (!for_token) return NULL;
     
-    ASTNode* node = create_node(AST_FOR_STMT, for_token->line, for_token->column);
+    ASTNode* node = create_node(p->arena, AST_FOR_STMT, for_token->line, for_token->column);
     
     Token* iterator = consume(p, TOKEN_IDENTIFIER, "Esperado nome do iterador");
     if (!iterator) {
-        free_ast(node);
         return NULL;
     }
-    node->for_stmt.iterator = strdup(iterator->lexema);
+    node->for_stmt.iterator = iterator->lexema;
     
     consume(p, TOKEN_IN, "Esperado 'in' após iterador");
     node->for_stmt.iterable = parse_expression(p);
@@ -533,7 +534,7 @@ ASTNode* parse_return_statement(Parser* p) {
     Token* return_token = consume(p, TOKEN_RETURN, "Esperado 'return'");
     if (!return_token) return NULL;
     
-    ASTNode* node = create_node(AST_RETURN_STMT, return_token->line, return_token->column);
+    ASTNode* node = create_node(p->arena, AST_RETURN_STMT, return_token->line, return_token->column);
     
     if (!check(p, TOKEN_SEMICOLON)) {
         node->return_stmt.value = parse_expression(p);
@@ -551,13 +552,13 @@ ASTNode* parse_print_statement(Parser* p) {
     Token* print_token = consume(p, TOKEN_PRINT, "Esperado 'print'");
     if (!print_token) return NULL;
     
-    ASTNode* node = create_node(AST_PRINT_STMT, print_token->line, print_token->column);
+    ASTNode* node = create_node(p->arena, AST_PRINT_STMT, print_token->line, print_token->column);
     
     consume(p, TOKEN_LPAREN, "Esperado '(' após 'print'");
     
     // Parse lista de expressões
     int capacity = 4;
-    ASTNode** expressions = malloc(capacity * sizeof(ASTNode*));
+    ASTNode** expressions = arena_alloc(p->arena, capacity * sizeof(ASTNode*));
     int expr_count = 0;
     
     if (!check(p, TOKEN_RPAREN)) {
@@ -565,8 +566,7 @@ ASTNode* parse_print_statement(Parser* p) {
         
         while (match(p, 1, TOKEN_COMMA)) {
             if (expr_count >= capacity) {
-                capacity *= 2;
-                expressions = realloc(expressions, capacity * sizeof(ASTNode*));
+                expressions = parser_grow_array(p, expressions, &capacity, sizeof(ASTNode*));
             }
             expressions[expr_count++] = parse_expression(p);
         }
@@ -583,7 +583,7 @@ ASTNode* parse_print_statement(Parser* p) {
 
 ASTNode* parse_expr_statement(Parser* p) {
     Token* current = peek(p);
-    ASTNode* node = create_node(AST_EXPR_STMT, current->line, current->column);
+    ASTNode* node = create_node(p->arena, AST_EXPR_STMT, current->line, current->column);
     
     node->expr_stmt.expression = parse_expression(p);
     consume(p, TOKEN_SEMICOLON, "Esperado ';' após expressão");
@@ -593,14 +593,21 @@ ASTNode* parse_expr_statement(Parser* p) {
 
 // ==================== FUNÇÕES PÚBLICAS ====================
 
-Parser* create_parser(TokenStream* stream) {
-    if (!stream || !stream->tokens) return NULL;
+Parser* create_parser(const char* source, size_t length, AFD* afd, Arena* arena) {
+    if (!source || !afd) return NULL;
     
     Parser* parser = calloc(1, sizeof(Parser));
     if (!parser) return NULL;
     
-    parser->tokens = stream->tokens;
-    parser->token_count = stream->count;
+    parser->lexer = create_lexer(source, length, afd);
+    if (!parser->lexer) {
+        free(parser);
+        return NULL;
+    }
+    parser->token_count = 0;
+    parser->owns_arena = (arena == NULL);
+    parser->arena = arena ? arena : arena_create(0);
+    parser->source = source;
     parser->current = 0;
     parser->had_error = false;
     parser->panic_mode = false;
@@ -619,26 +626,29 @@ void free_parser(Parser* parser) {
         free(parser->error_messages[i]);
     }
     free(parser->error_messages);
+    free_lexer(parser->lexer);
+    if (parser->owns_arena) arena_destroy(parser->arena);
     free(parser);
 }
 
 ASTNode* parse(Parser* parser) {
     if (!parser) return NULL;
     
-    printf("\n╔════════════════════════════════════════════════════════════╗\n");
-    printf("║              INICIANDO ANÁLISE SINTÁTICA LL(1)            ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n\n");
+    log_info("\n╔════════════════════════════════════════════════════════════╗\n");
+    log_info("║              INICIANDO ANÁLISE SINTÁTICA LL(1)            ║\n");
+    log_info("╚════════════════════════════════════════════════════════════╝\n\n");
     
     ASTNode* ast = parse_program(parser);
     
+    // Os erros já foram para stderr quando encontrados; aqui só o resumo
     if (parser->had_error) {
-        printf("\nParsing concluído com %d erro(s)\n", parser->error_count);
-        printf("\nErros encontrados:\n");
+        log_info("\nParsing concluído com %d erro(s)\n", parser->error_count);
+        log_info("\nErros encontrados:\n");
         for (int i = 0; i < parser->error_count; i++) {
-            printf("  %d. %s\n", i + 1, parser->error_messages[i]);
+            log_info("  %d. %s\n", i + 1, parser->error_messages[i]);
         }
     } else {
-        printf("\nParsing concluído com sucesso\n");
+        log_info("\nParsing concluído com sucesso\n");
     }
     
     return ast;
@@ -302,21 +302,31 @@ struct ASTNode {
 
 // ==================== ESTRUTURA DO PARSER ====================
 
+// O parser puxa tokens do lexer sob demanda e guarda só os últimos
+// PARSER_TOKEN_WINDOW (potência de 2) num buffer circular. Um Token* vindo
+// de peek/previous/advance/consume vale até alguns tokens adiante: quem
+// precisa dele depois de um sub-parse copia o Token ou cria o nó antes.
+#define PARSER_TOKEN_WINDOW 16
+
 typedef struct {
-    Token* tokens;
-    int token_count;
-    int current;
+    Token tokens[PARSER_TOKEN_WINDOW];
+    int token_count;                 // Tokens já lidos do lexer (índice absoluto)
+    int current;                     // Índice absoluto do próximo token
+    Lexer* lexer;
     bool had_error;
     bool panic_mode;
     char** error_messages;
     int error_count;
     int error_capacity;
+    Arena* arena;                    // Arena da compilação: AST e nomes
+    bool owns_arena;                 // Arena criada pelo próprio parser
+    const char* source;              // Código-fonte dos spans dos tokens
 } Parser;
 
 // ==================== FUNÇÕES PÚBLICAS ====================
 
 // Funções principais do parser
-Parser* create_parser(TokenStream* stream);
+Parser* create_parser(const char* source, size_t length, AFD* afd, Arena* arena);
 void free_parser(Parser* parser);
 ASTNode* parse(Parser* parser);
 
@@ -331,7 +341,8 @@ void error(Parser* p, const char* message);
 void error_at(Parser* p, Token* token, const char* message);
 Token* consume(Parser* p, TokenType type, const char* message);
 void synchronize(Parser* p);
-ASTNode* create_node(ASTNodeType type, int line, int column);
+ASTNode* create_node(Arena* arena, ASTNodeType type, int line, int column);
+void* parser_grow_array(Parser* p, void* items, int* capacity, size_t elem_size);
 ASTNode* parse_program(Parser* p);
 
 // Funções de parsing (públicas para uso entre módulos)
@@ -340,8 +351,7 @@ ASTNode* parse_statement(Parser* p);
 ASTNode* parse_type(Parser* p);
 ASTNode* parse_block(Parser* p);
 
-// Funções para liberar AST
-void free_ast(ASTNode* node);
+// Funções de visualização da AST (a memória pertence à arena)
 void print_ast(ASTNode* node, int indent);
 bool write_ast_json(ASTNode* node, const char* filepath);
 
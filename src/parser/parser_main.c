@@ -1,6 +1,6 @@
 /*
  * DataLang - Parser Main
- * Funções de liberação de memória, visualização da AST e função main
+ * Visualização da AST e função main
  */
 
 #include <stdio.h>
@@ -9,200 +9,8 @@
 #include <stdbool.h>
 #include "parser.h"
 
-extern AFD* create_datalang_afd_from_afn();
-extern TokenStream* tokenize(const char* input, AFD* afd);
+extern AFD* create_datalang_afd();
 extern void free_afd(AFD* afd);
-extern void free_token_stream(TokenStream* stream);
-
-// ==================== LIBERAÇÃO DA AST ====================
-
-void free_ast(ASTNode* node) {
-    if (!node) return;
-    
-    switch (node->type) {
-        case AST_PROGRAM:
-            for (int i = 0; i < node->program.decl_count; i++) {
-                free_ast(node->program.declarations[i]);
-            }
-            free(node->program.declarations);
-            break;
-            
-        case AST_LET_DECL:
-            free(node->let_decl.name);
-            free_ast(node->let_decl.type_annotation);
-            free_ast(node->let_decl.initializer);
-            break;
-            
-        case AST_PRINT_STMT:
-            for (int i = 0; i < node->print_stmt.expr_count; i++) {
-                free_ast(node->print_stmt.expressions[i]);
-            }
-            free(node->print_stmt.expressions);
-            break;
-            
-        case AST_FN_DECL:
-            free(node->fn_decl.name);
-            for (int i = 0; i < node->fn_decl.param_count; i++) {
-                free_ast(node->fn_decl.params[i]);
-            }
-            free(node->fn_decl.params);
-            free_ast(node->fn_decl.return_type);
-            free_ast(node->fn_decl.body);
-            break;
-            
-        case AST_DATA_DECL:
-            free(node->data_decl.name);
-            for (int i = 0; i < node->data_decl.field_count; i++) {
-                free_ast(node->data_decl.fields[i]);
-            }
-            free(node->data_decl.fields);
-            break;
-            
-        case AST_FIELD_DECL:
-            free(node->field_decl.field_name);
-            free_ast(node->field_decl.field_type);
-            break;
-            
-        case AST_PARAM:
-            free(node->param.param_name);
-            free_ast(node->param.param_type);
-            break;
-            
-        case AST_IF_STMT:
-            free_ast(node->if_stmt.condition);
-            free_ast(node->if_stmt.then_block);
-            free_ast(node->if_stmt.else_block);
-            break;
-            
-        case AST_FOR_STMT:
-            free(node->for_stmt.iterator);
-            free_ast(node->for_stmt.iterable);
-            free_ast(node->for_stmt.body);
-            break;
-            
-        case AST_RETURN_STMT:
-            free_ast(node->return_stmt.value);
-            break;
-            
-        case AST_EXPR_STMT:
-            free_ast(node->expr_stmt.expression);
-            break;
-            
-        case AST_BLOCK:
-            for (int i = 0; i < node->block.stmt_count; i++) {
-                free_ast(node->block.statements[i]);
-            }
-            free(node->block.statements);
-            break;
-            
-        case AST_BINARY_EXPR:
-            free_ast(node->binary_expr.left);
-            free_ast(node->binary_expr.right);
-            break;
-            
-        case AST_UNARY_EXPR:
-            free_ast(node->unary_expr.operand);
-            break;
-            
-        case AST_CALL_EXPR:
-            free_ast(node->call_expr.callee);
-            for (int i = 0; i < node->call_expr.arg_count; i++) {
-                free_ast(node->call_expr.arguments[i]);
-            }
-            free(node->call_expr.arguments);
-            break;
-            
-        case AST_INDEX_EXPR:
-            free_ast(node->index_expr.object);
-            free_ast(node->index_expr.index);
-            break;
-            
-        case AST_MEMBER_EXPR:
-            free_ast(node->member_expr.object);
-            free(node->member_expr.member);
-            break;
-            
-        case AST_LAMBDA_EXPR:
-            for (int i = 0; i < node->lambda_expr.lambda_param_count; i++) {
-                free_ast(node->lambda_expr.lambda_params[i]);
-            }
-            free(node->lambda_expr.lambda_params);
-            free_ast(node->lambda_expr.lambda_body);
-            break;
-            
-        case AST_PIPELINE_EXPR:
-            for (int i = 0; i < node->pipeline_expr.stage_count; i++) {
-                free_ast(node->pipeline_expr.stages[i]);
-            }
-            free(node->pipeline_expr.stages);
-            break;
-            
-        case AST_FILTER_TRANSFORM:
-            free_ast(node->filter_transform.filter_predicate);
-            break;
-            
-        case AST_MAP_TRANSFORM:
-            free_ast(node->map_transform.map_function);
-            break;
-            
-        case AST_REDUCE_TRANSFORM:
-            free_ast(node->reduce_transform.initial_value);
-            free_ast(node->reduce_transform.reducer);
-            break;
-            
-        case AST_AGGREGATE_TRANSFORM:
-            for (int i = 0; i < node->aggregate_transform.agg_arg_count; i++) {
-                free_ast(node->aggregate_transform.agg_args[i]);
-            }
-            free(node->aggregate_transform.agg_args);
-            break;
-            
-        case AST_LITERAL:
-            if (node->literal.literal_type == TOKEN_STRING) {
-                free(node->literal.string_value);
-            }
-            break;
-            
-        case AST_IDENTIFIER:
-            free(node->identifier.id_name);
-            break;
-            
-        case AST_ARRAY_LITERAL:
-            for (int i = 0; i < node->array_literal.element_count; i++) {
-                free_ast(node->array_literal.elements[i]);
-            }
-            free(node->array_literal.elements);
-            break;
-            
-        case AST_LOAD_EXPR:
-            free(node->load_expr.file_path);
-            break;
-            
-        case AST_SAVE_EXPR:
-            free_ast(node->save_expr.data);
-            free(node->save_expr.save_path);
-            break;
-            
-        case AST_RANGE_EXPR:
-            free_ast(node->range_expr.range_start);
-            free_ast(node->range_expr.range_end);
-            break;
-            
-        case AST_TYPE:
-            free(node->type_node.type_name);
-            free_ast(node->type_node.inner_type);
-            for (int i = 0; i < node->type_node.tuple_type_count; i++) {
-                free_ast(node->type_node.tuple_types[i]);
-            }
-            free(node->type_node.tuple_types);
-            break;
-            
-        default:
-            break;
-    }
-    
-    free(node);
-}
 
 // ==================== VISUALIZAÇÃO DA AST ====================
 
@@ -920,23 +728,16 @@ void test_parser_with_code(const char* code) {
     printf("%s\n", code);
     printf("════════════════════════════════════════════════════════════\n");
     
-    AFD* afd = create_datalang_afd_from_afn();
+    AFD* afd = create_datalang_afd();
     if (!afd) {
         printf("Erro ao criar AFD\n");
         return;
     }
     
-    TokenStream* tokens = tokenize(code, afd);
-    if (!tokens) {
-        printf("Erro na tokenização\n");
-        free_afd(afd);
-        return;
-    }
-    
-    Parser* parser = create_parser(tokens);
+    // Tokens são lidos sob demanda pelo parser
+    Parser* parser = create_parser(code, strlen(code), afd, NULL);
     if (!parser) {
         printf("Erro ao criar parser\n");
-        free_token_stream(tokens);
         free_afd(afd);
         return;
     }
@@ -951,8 +752,6 @@ void test_parser_with_code(const char* code) {
         printf("\nAST construída com sucesso\n");
     }
     
-    if (ast) free_ast(ast);
     free_parser(parser);
-    free_token_stream(tokens);
     free_afd(afd);
 }
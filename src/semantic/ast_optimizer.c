@@ -0,0 +1,679 @@
+/*
+ * DataLang - Implementação do Otimizador da AST
+ *
+ * Passes, nesta ordem:
+ *   1. Dobra de constantes em expressões e intervalos, com propagação de
+ *      lets nunca reatribuídos cujo valor é um literal Int/Float/Bool
+ *   2. Eliminação de ifs com condição constante e de statements após return
+ *   3. Remoção de funções não alcançáveis a partir de main/top-level
+ *
+ * A AST continua válida para o analisador semântico usado pelo codegen:
+ * só literais do mesmo tipo substituem expressões.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "ast_optimizer.h"
+
+// ==================== ESTRUTURAS INTERNAS ====================
+
+typedef struct {
+    char** names;
+    int count;
+    int capacity;
+} NameList;
+
+// Valor conhecido de um nome no escopo atual (NULL = sombreado/não constante)
+typedef struct {
+    const char* name;
+    ASTNode* value;
+} ConstBinding;
+
+typedef struct {
+    ConstBinding* bindings;
+    int binding_count;
+    int binding_capacity;
+    NameList mutated;                // Nomes alvo de alguma atribuição
+    int depth;                       // 0 = statements top-level do programa
+    ASTOptimizerStats* stats;
+    Arena* arena;                    // Nós novos (literais dobrados, listas)
+} Optimizer;
+
+static ASTNode* optimize_expr(Optimizer* opt, ASTNode* node);
+static ASTNode* optimize_stmt(Optimizer* opt, ASTNode* node, bool* splice);
+static void optimize_stmt_list(Optimizer* opt, ASTNode*** list, int* count, bool is_program);
+
+// ==================== LISTA DE NOMES ====================
+
+// Nomes da AST são internados: a comparação é por ponteiro
+static void name_list_add(NameList* list, const char* name) {
+    if (!name) return;
+    for (int i = 0; i < list->count; i++) {
+        if (list->names[i] == name) return;
+    }
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        list->names = realloc(list->names, list->capacity * sizeof(char*));
+    }
+    list->names[list->count++] = (char*)name;
+}
+
+static bool name_list_contains(NameList* list, const char* name) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->names[i] == name) return true;
+    }
+    return false;
+}
+
+// ==================== ESCOPOS DE CONSTANTES ====================
+
+static void bind(Optimizer* opt, const char* name, ASTNode* value) {
+    if (opt->binding_count >= opt->binding_capacity) {
+        opt->binding_capacity = opt->binding_capacity ? opt->binding_capacity * 2 : 32;
+        opt->bindings = realloc(opt->bindings, opt->binding_capacity * sizeof(ConstBinding));
+    }
+    opt->bindings[opt->binding_count].name = name;
+    opt->bindings[opt->binding_count].value = value;
+    opt->binding_count++;
+}
+
+static ASTNode* lookup_constant(Optimizer* opt, const char* name) {
+    for (int i = opt->binding_count - 1; i >= 0; i--) {
+        if (opt->bindings[i].name == name) return opt->bindings[i].value;
+    }
+    return NULL;
+}
+
+// ==================== PERCURSO GENÉRICO ====================
+
+typedef void (*ASTVisitor)(ASTNode* node, void* data);
+
+// Chama visit em cada filho direto de node
+static void visit_children(ASTNode* node, ASTVisitor visit, void* data) {
+    if (!node) return;
+    switch (node->type) {
+        case AST_PROGRAM:
+            for (int i = 0; i < node->program.decl_count; i++) visit(node->program.declarations[i], data);
+            break;
+        case AST_LET_DECL: visit(node->let_decl.initializer, data); break;
+        case AST_PRINT_STMT:
+            for (int i = 0; i < node->print_stmt.expr_count; i++) visit(node->print_stmt.expressions[i], data);
+            break;
+        case AST_FN_DECL: visit(node->fn_decl.body, data); break;
+        case AST_IF_STMT:
+            visit(node->if_stmt.condition, data);
+            visit(node->if_stmt.then_block, data);
+            visit(node->if_stmt.else_block, data);
+            break;
+        case AST_FOR_STMT:
+            visit(node->for_stmt.iterable, data);
+            visit(node->for_stmt.body, data);
+            break;
+        case AST_RETURN_STMT: visit(node->return_stmt.value, data); break;
+        case AST_EXPR_STMT: visit(node->expr_stmt.expression, data); break;
+        case AST_BLOCK:
+            for (int i = 0; i < node->block.stmt_count; i++) visit(node->block.statements[i], data);
+            break;
+        case AST_BINARY_EXPR:
+            visit(node->binary_expr.left, data);
+            visit(node->binary_expr.right, data);
+            break;
+        case AST_UNARY_EXPR: visit(node->unary_expr.operand, data); break;
+        case AST_CALL_EXPR:
+            visit(node->call_expr.callee, data);
+            for (int i = 0; i < node->call_expr.arg_count; i++) visit(node->call_expr.arguments[i], data);
+            break;
+        case AST_INDEX_EXPR:
+            visit(node->index_expr.object, data);
+            visit(node->index_expr.index, data);
+            break;
+        case AST_MEMBER_EXPR: visit(node->member_expr.object, data); break;
+        case AST_ASSIGN_EXPR:
+            visit(node->assign_expr.target, data);
+            visit(node->assign_expr.value, data);
+            break;
+        case AST_LAMBDA_EXPR: visit(node->lambda_expr.lambda_body, data); break;
+        case AST_PIPELINE_EXPR:
+            for (int i = 0; i < node->pipeline_expr.stage_count; i++) visit(node->pipeline_expr.stages[i], data);
+            break;
+        case AST_FILTER_TRANSFORM: visit(node->filter_transform.filter_predicate, data); break;
+        case AST_MAP_TRANSFORM: visit(node->map_transform.map_function, data); break;
+        case AST_REDUCE_TRANSFORM:
+            visit(node->reduce_transform.initial_value, data);
+            visit(node->reduce_transform.reducer, data);
+            break;
+        case AST_AGGREGATE_TRANSFORM:
+            for (int i = 0; i < node->aggregate_transform.agg_arg_count; i++) {
+                visit(node->aggregate_transform.agg_args[i], data);
+            }
+            break;
+        case AST_ARRAY_LITERAL:
+            for (int i = 0; i < node->array_literal.element_count; i++) visit(node->array_literal.elements[i], data);
+            break;
+        case AST_SAVE_EXPR: visit(node->save_expr.data, data); break;
+        case AST_RANGE_EXPR:
+            visit(node->range_expr.range_start, data);
+            visit(node->range_expr.range_end, data);
+            break;
+        default:
+            break;
+    }
+}
+
+static void collect_mutated(ASTNode* node, void* data) {
+    if (!node) return;
+    if (node->type == AST_ASSIGN_EXPR && node->assign_expr.target &&
+        node->assign_expr.target->type == AST_IDENTIFIER) {
+        name_list_add((NameList*)data, node->assign_expr.target->identifier.id_name);
+    }
+    visit_children(node, collect_mutated, data);
+}
+
+static void collect_references(ASTNode* node, void* data) {
+    if (!node) return;
+    if (node->type == AST_IDENTIFIER) {
+        name_list_add((NameList*)data, node->identifier.id_name);
+    } else if (node->type == AST_EXPORT_DECL) {
+        name_list_add((NameList*)data, node->export_decl.export_name);
+    }
+    visit_children(node, collect_references, data);
+}
+
+// ==================== LITERAIS ====================
+
+static bool is_scalar_literal(ASTNode* node) {
+    if (!node || node->type != AST_LITERAL) return false;
+    TokenType t = node->literal.literal_type;
+    return t == TOKEN_INTEGER || t == TOKEN_FLOAT || t == TOKEN_BOOL_TYPE;
+}
+
+static ASTNode* make_literal(Arena* arena, ASTNode* at, TokenType literal_type) {
+    ASTNode* lit = create_node(arena, AST_LITERAL, at->line, at->column);
+    lit->literal.literal_type = literal_type;
+    return lit;
+}
+
+static ASTNode* make_int(Arena* arena, ASTNode* at, long long value) {
+    ASTNode* lit = make_literal(arena, at, TOKEN_INTEGER);
+    lit->literal.int_value = value;
+    return lit;
+}
+
+static ASTNode* make_float(Arena* arena, ASTNode* at, double value) {
+    // inf/nan não têm literal em LLVM IR decimal: fica para o runtime
+    if (!isfinite(value)) return NULL;
+    ASTNode* lit = make_literal(arena, at, TOKEN_FLOAT);
+    lit->literal.float_value = value;
+    return lit;
+}
+
+static ASTNode* make_bool(Arena* arena, ASTNode* at, bool value) {
+    ASTNode* lit = make_literal(arena, at, TOKEN_BOOL_TYPE);
+    lit->literal.bool_value = value;
+    return lit;
+}
+
+static ASTNode* clone_literal(Arena* arena, ASTNode* lit, ASTNode* at) {
+    ASTNode* copy = make_literal(arena, at, lit->literal.literal_type);
+    copy->literal.int_value = lit->literal.int_value;
+    copy->literal.float_value = lit->literal.float_value;
+    copy->literal.bool_value = lit->literal.bool_value;
+    return copy;
+}
+
+static double literal_as_double(ASTNode* lit) {
+    return lit->literal.literal_type == TOKEN_FLOAT ?
+        lit->literal.float_value : (double)lit->literal.int_value;
+}
+
+// O literal tem o mesmo tipo da anotação do let (ou não há anotação)?
+static bool literal_matches_annotation(ASTNode* lit, ASTNode* annotation) {
+    if (!annotation) return true;
+    if (annotation->type != AST_TYPE) return false;
+    switch (lit->literal.literal_type) {
+        case TOKEN_INTEGER: return annotation->type_node.type_kind == TOKEN_INT_TYPE;
+        case TOKEN_FLOAT: return annotation->type_node.type_kind == TOKEN_FLOAT_TYPE;
+        case TOKEN_BOOL_TYPE: return annotation->type_node.type_kind == TOKEN_BOOL_TYPE;
+        default: return false;
+    }
+}
+
+// ==================== DOBRA DE CONSTANTES ====================
+
+// Mesma semântica do codegen: i64 com wraparound, sdiv/srem, double IEEE
+static ASTNode* fold_binary(Arena* arena, ASTNode* node) {
+    ASTNode* l = node->binary_expr.left;
+    ASTNode* r = node->binary_expr.right;
+    if (!is_scalar_literal(l) || !is_scalar_literal(r)) return NULL;
+
+    TokenType lt = l->literal.literal_type;
+    TokenType rt = r->literal.literal_type;
+    BinaryOp op = node->binary_expr.op;
+
+    if (lt == TOKEN_BOOL_TYPE || rt == TOKEN_BOOL_TYPE) {
+        if (lt != rt) return NULL;
+        bool a = l->literal.bool_value, b = r->literal.bool_value;
+        switch (op) {
+            case BINOP_AND: return make_bool(arena, node, a && b);
+            case BINOP_OR: return make_bool(arena, node, a || b);
+            case BINOP_EQ: return make_bool(arena, node, a == b);
+            case BINOP_NEQ: return make_bool(arena, node, a != b);
+            default: return NULL;
+        }
+    }
+
+    if (lt == TOKEN_INTEGER && rt == TOKEN_INTEGER) {
+        long long a = l->literal.int_value, b = r->literal.int_value;
+        unsigned long long ua = (unsigned long long)a, ub = (unsigned long long)b;
+        switch (op) {
+            case BINOP_ADD: return make_int(arena, node, (long long)(ua + ub));
+            case BINOP_SUB: return make_int(arena, node, (long long)(ua - ub));
+            case BINOP_MUL: return make_int(arena, node, (long long)(ua * ub));
+            case BINOP_DIV:
+            case BINOP_MOD:
+                // Divisão por zero/overflow fica para o runtime
+                if (b == 0 || (a == LLONG_MIN && b == -1)) return NULL;
+                return make_int(arena, node, op == BINOP_DIV ? a / b : a % b);
+            case BINOP_EQ: return make_bool(arena, node, a == b);
+            case BINOP_NEQ: return make_bool(arena, node, a != b);
+            case BINOP_LT: return make_bool(arena, node, a < b);
+            case BINOP_LTE: return make_bool(arena, node, a <= b);
+            case BINOP_GT: return make_bool(arena, node, a > b);
+            case BINOP_GTE: return make_bool(arena, node, a >= b);
+            default: return NULL;
+        }
+    }
+
+    double a = literal_as_double(l), b = literal_as_double(r);
+    switch (op) {
+        case BINOP_ADD: return make_float(arena, node, a + b);
+        case BINOP_SUB: return make_float(arena, node, a - b);
+        case BINOP_MUL: return make_float(arena, node, a * b);
+        case BINOP_DIV: return make_float(arena, node, a / b);
+        case BINOP_EQ: return make_bool(arena, node, a == b);
+        case BINOP_NEQ: return make_bool(arena, node, a < b || a > b);   // fcmp one
+        case BINOP_LT: return make_bool(arena, node, a < b);
+        case BINOP_LTE: return make_bool(arena, node, a <= b);
+        case BINOP_GT: return make_bool(arena, node, a > b);
+        case BINOP_GTE: return make_bool(arena, node, a >= b);
+        default: return NULL;
+    }
+}
+
+static ASTNode* fold_unary(Arena* arena, ASTNode* node) {
+    ASTNode* operand = node->unary_expr.operand;
+    if (!is_scalar_literal(operand)) return NULL;
+
+    switch (node->unary_expr.op) {
+        case UNOP_NEG:
+            if (operand->literal.literal_type == TOKEN_INTEGER) {
+                return make_int(arena, node, (long long)(0ULL - (unsigned long long)operand->literal.int_value));
+            }
+            if (operand->literal.literal_type == TOKEN_FLOAT) {
+                return make_float(arena, node, -operand->literal.float_value);
+            }
+            return NULL;
+        case UNOP_NOT:
+            if (operand->literal.literal_type != TOKEN_BOOL_TYPE) return NULL;
+            return make_bool(arena, node, !operand->literal.bool_value);
+        default:
+            return NULL;
+    }
+}
+
+// Substitui node por folded (se houver); a subárvore antiga fica na arena
+static ASTNode* replace_folded(Optimizer* opt, ASTNode* node, ASTNode* folded) {
+    if (!folded) return node;
+    opt->stats->folded++;
+    return folded;
+}
+
+static void optimize_expr_list(Optimizer* opt, ASTNode** items, int count) {
+    for (int i = 0; i < count; i++) items[i] = optimize_expr(opt, items[i]);
+}
+
+static ASTNode* optimize_lambda(Optimizer* opt, ASTNode* node) {
+    int saved = opt->binding_count;
+    for (int i = 0; i < node->lambda_expr.lambda_param_count; i++) {
+        ASTNode* param = node->lambda_expr.lambda_params[i];
+        if (param && param->type == AST_PARAM) bind(opt, param->param.param_name, NULL);
+    }
+    node->lambda_expr.lambda_body = optimize_expr(opt, node->lambda_expr.lambda_body);
+    opt->binding_count = saved;
+    return node;
+}
+
+static ASTNode* optimize_expr(Optimizer* opt, ASTNode* node) {
+    if (!node) return NULL;
+
+    switch (node->type) {
+        case AST_IDENTIFIER: {
+            ASTNode* value = lookup_constant(opt, node->identifier.id_name);
+            if (!value) return node;
+            ASTNode* lit = clone_literal(opt->arena, value, node);
+            opt->stats->propagated++;
+            return lit;
+        }
+
+        case AST_BINARY_EXPR:
+            node->binary_expr.left = optimize_expr(opt, node->binary_expr.left);
+            node->binary_expr.right = optimize_expr(opt, node->binary_expr.right);
+            return replace_folded(opt, node, fold_binary(opt->arena, node));
+
+        case AST_UNARY_EXPR:
+            node->unary_expr.operand = optimize_expr(opt, node->unary_expr.operand);
+            return replace_folded(opt, node, fold_unary(opt->arena, node));
+
+        case AST_CALL_EXPR:
+            // O callee é o nome da função, nunca um valor propagável
+            optimize_expr_list(opt, node->call_expr.arguments, node->call_expr.arg_count);
+            return node;
+
+        case AST_INDEX_EXPR:
+            node->index_expr.object = optimize_expr(opt, node->index_expr.object);
+            node->index_expr.index = optimize_expr(opt, node->index_expr.index);
+            return node;
+
+        case AST_MEMBER_EXPR:
+            node->member_expr.object = optimize_expr(opt, node->member_expr.object);
+            return node;
+
+        case AST_ASSIGN_EXPR:
+            if (node->assign_expr.target && node->assign_expr.target->type != AST_IDENTIFIER) {
+                node->assign_expr.target = optimize_expr(opt, node->assign_expr.target);
+            }
+            node->assign_expr.value = optimize_expr(opt, node->assign_expr.value);
+            return node;
+
+        case AST_LAMBDA_EXPR:
+            return optimize_lambda(opt, node);
+
+        case AST_PIPELINE_EXPR:
+            node->pipeline_expr.stages[0] = optimize_expr(opt, node->pipeline_expr.stages[0]);
+            for (int i = 1; i < node->pipeline_expr.stage_count; i++) {
+                ASTNode* stage = node->pipeline_expr.stages[i];
+                // Argumentos de estágios como sum(coluna) são nomes de coluna
+                if (stage && stage->type == AST_CALL_EXPR) continue;
+                node->pipeline_expr.stages[i] = optimize_expr(opt, stage);
+            }
+            return node;
+
+        case AST_FILTER_TRANSFORM:
+            node->filter_transform.filter_predicate =
+                optimize_expr(opt, node->filter_transform.filter_predicate);
+            return node;
+
+        case AST_MAP_TRANSFORM:
+            node->map_transform.map_function = optimize_expr(opt, node->map_transform.map_function);
+            return node;
+
+        case AST_REDUCE_TRANSFORM:
+            node->reduce_transform.initial_value = optimize_expr(opt, node->reduce_transform.initial_value);
+            node->reduce_transform.reducer = optimize_expr(opt, node->reduce_transform.reducer);
+            return node;
+
+        case AST_ARRAY_LITERAL:
+            optimize_expr_list(opt, node->array_literal.elements, node->array_literal.element_count);
+            return node;
+
+        case AST_SAVE_EXPR:
+            node->save_expr.data = optimize_expr(opt, node->save_expr.data);
+            return node;
+
+        case AST_RANGE_EXPR:
+            node->range_expr.range_start = optimize_expr(opt, node->range_expr.range_start);
+            node->range_expr.range_end = optimize_expr(opt, node->range_expr.range_end);
+            return node;
+
+        default:
+            return node;
+    }
+}
+
+// ==================== STATEMENTS ====================
+
+static bool block_declares_lets(ASTNode* block) {
+    for (int i = 0; i < block->block.stmt_count; i++) {
+        ASTNode* stmt = block->block.statements[i];
+        if (stmt && stmt->type == AST_LET_DECL) return true;
+    }
+    return false;
+}
+
+// O main gerado para o top-level só emite print/for/if/expressões
+static bool block_fits_top_level(ASTNode* block) {
+    for (int i = 0; i < block->block.stmt_count; i++) {
+        ASTNodeType t = block->block.statements[i]->type;
+        if (t != AST_PRINT_STMT && t != AST_FOR_STMT && t != AST_IF_STMT && t != AST_EXPR_STMT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static ASTNode* optimize_block(Optimizer* opt, ASTNode* node) {
+    int saved = opt->binding_count;
+    opt->depth++;
+    optimize_stmt_list(opt, &node->block.statements, &node->block.stmt_count, false);
+    opt->depth--;
+    opt->binding_count = saved;
+    return node;
+}
+
+static void optimize_let(Optimizer* opt, ASTNode* node) {
+    node->let_decl.initializer = optimize_expr(opt, node->let_decl.initializer);
+
+    ASTNode* init = node->let_decl.initializer;
+    bool constant = is_scalar_literal(init) &&
+                    literal_matches_annotation(init, node->let_decl.type_annotation) &&
+                    !name_list_contains(&opt->mutated, node->let_decl.name);
+    bind(opt, node->let_decl.name, constant ? init : NULL);
+}
+
+// if com condição constante: devolve o ramo escolhido (NULL = removido).
+// Um bloco só é aberto no escopo pai quando não declara lets.
+static ASTNode* optimize_if(Optimizer* opt, ASTNode* node, bool* splice) {
+    node->if_stmt.condition = optimize_expr(opt, node->if_stmt.condition);
+    bool dummy;
+    node->if_stmt.then_block = optimize_stmt(opt, node->if_stmt.then_block, &dummy);
+    node->if_stmt.else_block = optimize_stmt(opt, node->if_stmt.else_block, &dummy);
+
+    ASTNode* cond = node->if_stmt.condition;
+    if (!cond || cond->type != AST_LITERAL || cond->literal.literal_type != TOKEN_BOOL_TYPE) {
+        return node;
+    }
+
+    ASTNode* chosen = cond->literal.bool_value ? node->if_stmt.then_block : node->if_stmt.else_block;
+    if (chosen && chosen->type == AST_BLOCK) {
+        if (block_declares_lets(chosen)) return node;
+        if (opt->depth == 0 && !block_fits_top_level(chosen)) return node;
+        *splice = true;
+    }
+
+    if (chosen == node->if_stmt.then_block) node->if_stmt.then_block = NULL;
+    else node->if_stmt.else_block = NULL;
+    opt->stats->branches_removed++;
+    return chosen;
+}
+
+static ASTNode* optimize_stmt(Optimizer* opt, ASTNode* node, bool* splice) {
+    *splice = false;
+    if (!node) return NULL;
+
+    switch (node->type) {
+        case AST_LET_DECL:
+            optimize_let(opt, node);
+            return node;
+
+        case AST_IF_STMT:
+            return optimize_if(opt, node, splice);
+
+        case AST_FOR_STMT: {
+            node->for_stmt.iterable = optimize_expr(opt, node->for_stmt.iterable);
+            int saved = opt->binding_count;
+            bind(opt, node->for_stmt.iterator, NULL);
+            bool dummy;
+            node->for_stmt.body = optimize_stmt(opt, node->for_stmt.body, &dummy);
+            opt->binding_count = saved;
+            return node;
+        }
+
+        case AST_RETURN_STMT:
+            node->return_stmt.value = optimize_expr(opt, node->return_stmt.value);
+            return node;
+
+        case AST_PRINT_STMT:
+            optimize_expr_list(opt, node->print_stmt.expressions, node->print_stmt.expr_count);
+            return node;
+
+        case AST_EXPR_STMT:
+            node->expr_stmt.expression = optimize_expr(opt, node->expr_stmt.expression);
+            return node;
+
+        case AST_BLOCK:
+            return optimize_block(opt, node);
+
+        default:
+            return node;
+    }
+}
+
+// Otimiza uma lista de statements no lugar: ramos escolhidos são abertos
+// na lista e tudo após um return é descartado.
+static void optimize_stmt_list(Optimizer* opt, ASTNode*** list, int* count, bool is_program) {
+    ASTNode** in = *list;
+    int n = *count;
+    int capacity = n > 0 ? n : 1;
+    ASTNode** out = arena_alloc(opt->arena, capacity * sizeof(ASTNode*));
+    int out_count = 0;
+    bool unreachable = false;
+
+    for (int i = 0; i < n; i++) {
+        ASTNode* stmt = in[i];
+        if (unreachable) {
+            opt->stats->statements_removed++;
+            continue;
+        }
+
+        // Funções são otimizadas depois, com todas as globais conhecidas
+        bool keep_as_is = is_program && stmt &&
+                          (stmt->type == AST_FN_DECL || stmt->type == AST_DATA_DECL ||
+                           stmt->type == AST_IMPORT_DECL || stmt->type == AST_EXPORT_DECL);
+
+        bool splice = false;
+        ASTNode* result = keep_as_is ? stmt : optimize_stmt(opt, stmt, &splice);
+        if (!result) continue;
+
+        int needed = splice ? result->block.stmt_count : 1;
+        if (out_count + needed > capacity) {
+            int old_capacity = capacity;
+            while (out_count + needed > capacity) capacity *= 2;
+            out = arena_realloc(opt->arena, out, old_capacity * sizeof(ASTNode*),
+                                capacity * sizeof(ASTNode*));
+        }
+
+        if (splice) {
+            for (int j = 0; j < result->block.stmt_count; j++) {
+                out[out_count++] = result->block.statements[j];
+            }
+        } else {
+            out[out_count++] = result;
+        }
+
+        if (!is_program && out_count > 0 && out[out_count - 1]->type == AST_RETURN_STMT) {
+            unreachable = true;
+        }
+    }
+
+    *list = out;
+    *count = out_count;
+}
+
+static void optimize_function(Optimizer* opt, ASTNode* fn) {
+    int saved = opt->binding_count;
+    for (int i = 0; i < fn->fn_decl.param_count; i++) {
+        ASTNode* param = fn->fn_decl.params[i];
+        if (param && param->type == AST_PARAM) bind(opt, param->param.param_name, NULL);
+    }
+    if (fn->fn_decl.body && fn->fn_decl.body->type == AST_BLOCK) {
+        optimize_block(opt, fn->fn_decl.body);
+    }
+    opt->binding_count = saved;
+}
+
+// ==================== FUNÇÕES NÃO USADAS ====================
+
+static void remove_unused_functions(Optimizer* opt, ASTNode* program) {
+    NameList refs = {0};
+    int n = program->program.decl_count;
+    bool* reachable = calloc(n > 0 ? n : 1, sizeof(bool));
+
+    // Raízes: tudo o que não é função (globais, statements top-level, exports)
+    for (int i = 0; i < n; i++) {
+        ASTNode* decl = program->program.declarations[i];
+        if (decl && decl->type != AST_FN_DECL) collect_references(decl, &refs);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < n; i++) {
+            ASTNode* decl = program->program.declarations[i];
+            if (!decl || decl->type != AST_FN_DECL || reachable[i]) continue;
+            if (strcmp(decl->fn_decl.name, "main") == 0 ||
+                name_list_contains(&refs, decl->fn_decl.name)) {
+                reachable[i] = true;
+                collect_references(decl->fn_decl.body, &refs);
+                changed = true;
+            }
+        }
+    }
+
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        ASTNode* decl = program->program.declarations[i];
+        if (decl && decl->type == AST_FN_DECL && !reachable[i]) {
+            opt->stats->functions_removed++;
+            continue;
+        }
+        program->program.declarations[kept++] = decl;
+    }
+    program->program.decl_count = kept;
+
+    free(reachable);
+    free(refs.names);
+}
+
+// ==================== INTERFACE PÚBLICA ====================
+
+void optimize_ast(ASTNode* program, Arena* arena, ASTOptimizerStats* stats) {
+    if (!program || program->type != AST_PROGRAM) return;
+
+    ASTOptimizerStats local_stats;
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+
+    Optimizer opt = {0};
+    opt.arena = arena;
+    opt.stats = stats;
+    collect_mutated(program, &opt.mutated);
+
+    // Globais e statements top-level, em ordem; as globais constantes
+    // continuam visíveis dentro das funções
+    optimize_stmt_list(&opt, &program->program.declarations, &program->program.decl_count, true);
+
+    for (int i = 0; i < program->program.decl_count; i++) {
+        ASTNode* decl = program->program.declarations[i];
+        if (decl && decl->type == AST_FN_DECL) optimize_function(&opt, decl);
+    }
+
+    remove_unused_functions(&opt, program);
+
+    free(opt.bindings);
+    free(opt.mutated.names);
+}
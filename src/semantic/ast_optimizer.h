@@ -0,0 +1,28 @@
+/*
+ * DataLang - Otimizador da AST
+ * Dobra de constantes, propagação de lets imutáveis e eliminação de
+ * código morto, executados entre a análise semântica e a geração de código
+ */
+
+#ifndef AST_OPTIMIZER_H
+#define AST_OPTIMIZER_H
+
+#include <stdbool.h>
+#include "parser.h"
+
+// ==================== ESTRUTURAS ====================
+
+typedef struct {
+    int folded;                      // Expressões constantes dobradas
+    int propagated;                  // Usos de lets imutáveis substituídos pelo valor
+    int branches_removed;            // Ifs com condição constante eliminados
+    int statements_removed;          // Statements inalcançáveis após return
+    int functions_removed;           // Funções nunca referenciadas
+} ASTOptimizerStats;
+
+// ==================== FUNÇÕES PÚBLICAS ====================
+
+// Otimiza a AST no lugar (deve rodar após analyze_semantics); nós novos vêm da arena
+void optimize_ast(ASTNode* program, Arena* arena, ASTOptimizerStats* stats);
+
+#endif // AST_OPTIMIZER_H
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "semantic_analyzer.h"
+#include "log.h"
 
 // ==================== DECLARAÇÕES FORWARD ====================
 
@@ -31,9 +32,11 @@ Type* analyze_groupby_transform(SemanticAnalyzer* analyzer, ASTNode* node);
 
 // ==================== CRIAÇÃO E DESTRUIÇÃO ====================
 
-SemanticAnalyzer* create_semantic_analyzer() {
+SemanticAnalyzer* create_semantic_analyzer(Arena* arena) {
     SemanticAnalyzer* analyzer = calloc(1, sizeof(SemanticAnalyzer));
-    analyzer->symbol_table = create_symbol_table();
+    analyzer->arena = arena;
+    type_system_set_arena(arena);
+    analyzer->symbol_table = create_symbol_table(arena);
     analyzer->inference_ctx = create_inference_context();
     analyzer->had_error = false;
     analyzer->warning_count = 0;
@@ -50,13 +53,14 @@ void free_semantic_analyzer(SemanticAnalyzer* analyzer) {
     if (analyzer->current_function_return_type) {
         free_type(analyzer->current_function_return_type);
     }
+    if (analyzer->arena) type_system_set_arena(NULL);
     free(analyzer);
 }
 
 // ==================== FUNÇÕES BUILT-IN ====================
 
 void register_builtin_functions(SemanticAnalyzer* analyzer) {
-    printf("[Semantic] Registrando funções built-in...\n");
+    log_debug("[Semantic] Registrando funções built-in...\n");
     
     // print(x) -> Void (polimórfico)
     {
@@ -100,7 +104,7 @@ void register_builtin_functions(SemanticAnalyzer* analyzer) {
         declare_function(analyzer->symbol_table, "max", return_type, param_types, 1, 0, 0);
     }
     
-    printf("[Semantic] Funções built-in registradas com sucesso\n");
+    log_debug("[Semantic] Funções built-in registradas com sucesso\n");
 }
 
 // ==================== ANÁLISE PRINCIPAL ====================
@@ -108,19 +112,19 @@ void register_builtin_functions(SemanticAnalyzer* analyzer) {
 bool analyze_semantics(SemanticAnalyzer* analyzer, ASTNode* program) {
     if (!analyzer || !program) return false;
     
-    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
-    printf("║          ANÁLISE SEMÂNTICA E INFERÊNCIA DE TIPOS          ║\n");
-    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
+    log_info("\n╔═══════════════════════════════════════════════════════════╗\n");
+    log_info("║          ANÁLISE SEMÂNTICA E INFERÊNCIA DE TIPOS          ║\n");
+    log_info("╚═══════════════════════════════════════════════════════════╝\n\n");
     
     if (program->type != AST_PROGRAM) {
-        fprintf(stderr, "Erro: Nodo raiz não é um programa\n");
+        log_error("Erro: Nodo raiz não é um programa\n");
         return false;
     }
     
     register_builtin_functions(analyzer);
     
     // Fase 1: Coleta de Declarações
-    printf("[Fase 1] Coletando declarações de nível superior...\n");
+    log_debug("[Fase 1] Coletando declarações de nível superior...\n");
     for (int i = 0; i < program->program.decl_count; i++) {
         ASTNode* decl = program->program.declarations[i];
         
@@ -161,8 +165,8 @@ bool analyze_semantics(SemanticAnalyzer* analyzer, ASTNode* program) {
                 ASTNode* field = decl->data_decl.fields[j];
                 Type* field_type = ast_type_to_type(analyzer, field->field_decl.field_type);
                 
-                Symbol* field_symbol = calloc(1, sizeof(Symbol));
-                field_symbol->name = strdup(field->field_decl.field_name);
+                Symbol* field_symbol = symbol_table_alloc(analyzer->symbol_table, sizeof(Symbol));
+                field_symbol->name = (char*)intern_cstr(field->field_decl.field_name);
                 field_symbol->kind = SYMBOL_FIELD;
                 field_symbol->type = field_type;
                 field_symbol->line = field->line;
@@ -180,7 +184,7 @@ bool analyze_semantics(SemanticAnalyzer* analyzer, ASTNode* program) {
     }
     
     // Fase 2: Analisa corpos
-    printf("[Fase 2] Analisando corpos e instruções...\n");
+    log_debug("[Fase 2] Analisando corpos e instruções...\n");
     for (int i = 0; i < program->program.decl_count; i++) {
         ASTNode* decl = program->program.declarations[i];
         
@@ -200,7 +204,7 @@ bool analyze_semantics(SemanticAnalyzer* analyzer, ASTNode* program) {
     }
     
     // Fase 3: Verificações finais
-    printf("[Fase 3] Verificações finais...\n");
+    log_debug("[Fase 3] Verificações finais...\n");
     check_unused_symbols(analyzer->symbol_table);
     
     print_semantic_analysis_report(analyzer);
@@ -298,7 +302,7 @@ Type* analyze_fn_decl(SemanticAnalyzer* analyzer, ASTNode* node) {
         if (!check_all_paths_return(analyzer, node->fn_decl.body)) {
             // Aviso apenas, não erro
             analyzer->warning_count++;
-            printf("Aviso [linha %d]: Função '%s' pode não retornar valor em todos os caminhos\n",
+            log_warn("Aviso [linha %d]: Função '%s' pode não retornar valor em todos os caminhos\n",
                    node->line, node->fn_decl.name);
         }
     }
@@ -467,7 +471,7 @@ Type* analyze_print_stmt(SemanticAnalyzer* analyzer, ASTNode* node) {
             expr_type->kind != TYPE_ERROR) {
             
             analyzer->warning_count++;
-            printf("Aviso [linha %d]: print() argumento %d com tipo complexo %s\n",
+            log_warn("Aviso [linha %d]: print() argumento %d com tipo complexo %s\n",
                    node->line, i+1, type_to_string(expr_type));
         }
     }
@@ -870,15 +874,94 @@ Type* analyze_lambda_expr(SemanticAnalyzer* analyzer, ASTNode* node) {
     return analyze_lambda_with_expectations(analyzer, node, NULL, 0, NULL);
 }
 
+// sum/mean/count/min/max logo após groupby: argumentos são nomes de coluna
+bool extract_group_aggregate(ASTNode* stage, AggregateType* agg, ASTNode*** args, int* arg_count) {
+    static const struct { const char* name; AggregateType agg; } aggregates[] = {
+        {"sum", AGG_SUM}, {"mean", AGG_MEAN}, {"count", AGG_COUNT}, {"min", AGG_MIN}, {"max", AGG_MAX}
+    };
+    if (!stage) return false;
+
+    if (stage->type == AST_AGGREGATE_TRANSFORM) {
+        *agg = stage->aggregate_transform.agg_type;
+        *args = stage->aggregate_transform.agg_args;
+        *arg_count = stage->aggregate_transform.agg_arg_count;
+    } else if (stage->type == AST_CALL_EXPR && stage->call_expr.callee &&
+               stage->call_expr.callee->type == AST_IDENTIFIER) {
+        const char* name = stage->call_expr.callee->identifier.id_name;
+        int found = -1;
+        for (int i = 0; i < (int)(sizeof(aggregates) / sizeof(aggregates[0])); i++) {
+            if (strcmp(name, aggregates[i].name) == 0) found = i;
+        }
+        if (found < 0) return false;
+        *agg = aggregates[found].agg;
+        *args = stage->call_expr.arguments;
+        *arg_count = stage->call_expr.arg_count;
+    } else {
+        return false;
+    }
+
+    for (int i = 0; i < *arg_count; i++) {
+        if (!(*args)[i] || (*args)[i]->type != AST_IDENTIFIER) return false;
+    }
+    return true;
+}
+
+// Campo de um tipo de dados declarado (NULL se não existe)
+static Symbol* find_type_field(SemanticAnalyzer* analyzer, const char* type_name, const char* field) {
+    Symbol* type_symbol = lookup_symbol(analyzer->symbol_table, type_name);
+    if (!type_symbol || type_symbol->kind != SYMBOL_TYPE) return NULL;
+    for (int i = 0; i < type_symbol->field_count; i++) {
+        if (strcmp(type_symbol->fields[i]->name, field) == 0) return type_symbol->fields[i];
+    }
+    return NULL;
+}
+
+/*
+ * groupby(chaves) |> agg(colunas) sobre input_type (o tipo que entra no
+ * groupby). Em DataFrame as colunas só existem em tempo de execução; em
+ * array de tipo de dados cada chave e coluna precisa ser um campo.
+ * Devolve false quando a entrada não admite agregação por grupo, e o
+ * estágio é então analisado como uma expressão comum.
+ */
+static bool analyze_group_aggregate(SemanticAnalyzer* analyzer, Type* input_type,
+                                    ASTNode* groupby, ASTNode* stage) {
+    AggregateType agg;
+    ASTNode** args;
+    int arg_count;
+    if (!input_type || !extract_group_aggregate(stage, &agg, &args, &arg_count)) return false;
+    if (input_type->kind == TYPE_DATAFRAME) return true;
+
+    if (input_type->kind != TYPE_ARRAY || !input_type->element_type ||
+        input_type->element_type->kind != TYPE_CUSTOM) {
+        return false;
+    }
+    const char* type_name = input_type->element_type->custom_name;
+    int key_count = groupby->groupby_transform.group_column_count;
+    for (int i = 0; i < key_count + arg_count; i++) {
+        const char* column = i < key_count ? groupby->groupby_transform.group_columns[i]
+                                           : args[i - key_count]->identifier.id_name;
+        ASTNode* where = i < key_count ? groupby : args[i - key_count];
+        if (!find_type_field(analyzer, type_name, column)) {
+            symbol_table_error(analyzer->symbol_table, where->line, where->column,
+                "Tipo '%s' não possui campo '%s'", type_name, column);
+            analyzer->had_error = true;
+        }
+    }
+    return true;
+}
+
 Type* analyze_pipeline_expr(SemanticAnalyzer* analyzer, ASTNode* node) {
     if (node->pipeline_expr.stage_count == 0) {
         return create_error_type();
     }
     
     Type* current_type = analyze_expression(analyzer, node->pipeline_expr.stages[0]);
+    Type* groupby_input = NULL;   // Tipo que entrou no último estágio groupby
     
     for (int i = 1; i < node->pipeline_expr.stage_count; i++) {
         ASTNode* stage = node->pipeline_expr.stages[i];
+        ASTNode* prev = node->pipeline_expr.stages[i - 1];
+        Type* input_type = current_type;
         
         if (stage->type == AST_FILTER_TRANSFORM) {
             current_type = analyze_filter_transform(analyzer, stage, current_type);
@@ -889,12 +972,18 @@ Type* analyze_pipeline_expr(SemanticAnalyzer* analyzer, ASTNode* node) {
         else if (stage->type == AST_REDUCE_TRANSFORM) {
             current_type = analyze_reduce_transform(analyzer, stage, current_type);
         }
+        else if (prev->type == AST_GROUPBY_TRANSFORM &&
+                 analyze_group_aggregate(analyzer, groupby_input, prev, stage)) {
+            // Agregação por grupo: resultado é um DataFrame (chaves + agregados)
+            current_type = create_primitive_type(TYPE_DATAFRAME);
+        }
         else if (stage->type == AST_AGGREGATE_TRANSFORM) {
             current_type = analyze_expression(analyzer, stage);
         }
         else {
             current_type = analyze_expression(analyzer, stage);
         }
+        groupby_input = stage->type == AST_GROUPBY_TRANSFORM ? input_type : NULL;
     }
     
     return current_type;
@@ -928,7 +1017,7 @@ Type* analyze_identifier(SemanticAnalyzer* analyzer, ASTNode* node) {
     
     if (!symbol->initialized && symbol->kind == SYMBOL_VARIABLE) {
         analyzer->warning_count++;
-        printf("Aviso [linha %d]: Variável '%s' pode estar sendo usada antes de ser inicializada\n",
+        log_warn("Aviso [linha %d]: Variável '%s' pode estar sendo usada antes de ser inicializada\n",
                node->line, node->identifier.id_name);
     }
     
@@ -1257,7 +1346,9 @@ Type* ast_type_to_type(SemanticAnalyzer* analyzer, ASTNode* type_node) {
             for (int i = 0; i < type_node->type_node.tuple_type_count; i++) {
                 types[i] = ast_type_to_type(analyzer, type_node->type_node.tuple_types[i]);
             }
-            return create_tuple_type(types, type_node->type_node.tuple_type_count);
+            Type* tuple = create_tuple_type(types, type_node->type_node.tuple_type_count);
+            free(types);
+            return tuple;
         }
         
         case TOKEN_IDENTIFIER: {
@@ -1275,9 +1366,9 @@ Type* ast_type_to_type(SemanticAnalyzer* analyzer, ASTNode* type_node) {
 // ==================== RELATÓRIOS ====================
 
 void print_semantic_analysis_report(SemanticAnalyzer* analyzer) {
-    printf("\n╔═══════════════════════════════════════════════════════════╗\n");
-    printf("║           RELATÓRIO DE ANÁLISE SEMÂNTICA                  ║\n");
-    printf("╚═══════════════════════════════════════════════════════════╝\n\n");
+    log_info("\n╔═══════════════════════════════════════════════════════════╗\n");
+    log_info("║           RELATÓRIO DE ANÁLISE SEMÂNTICA                  ║\n");
+    log_info("╚═══════════════════════════════════════════════════════════╝\n\n");
     
     if (analyzer->symbol_table->error_count > 0) {
         print_symbol_table_errors(analyzer->symbol_table);
@@ -1287,18 +1378,20 @@ void print_semantic_analysis_report(SemanticAnalyzer* analyzer) {
         print_inference_errors(analyzer->inference_ctx);
     }
     
-    printf("Estatísticas:\n");
-    printf("────────────────────────────────────────────────────────────\n");
-    printf("  Erros: %d\n", analyzer->symbol_table->error_count + 
-                               analyzer->inference_ctx->error_count);
-    printf("  Avisos: %d\n", analyzer->warning_count);
+    log_info("Estatísticas:\n");
+    log_info("────────────────────────────────────────────────────────────\n");
+    log_info("  Erros: %d\n", analyzer->symbol_table->error_count + 
+                                 analyzer->inference_ctx->error_count);
+    log_info("  Avisos: %d\n", analyzer->warning_count);
     
     if (analyzer->had_error) {
-        printf("\nAnálise semântica concluída com erros\n");
+        log_info("\nAnálise semântica concluída com erros\n");
     } else {
-        printf("\nAnálise semântica concluída com sucesso\n");
-        printf("\nTabela de Símbolos Final:\n");
-        printf("────────────────────────────────────────────────────────────\n");
-        print_symbol_table(analyzer->symbol_table);
+        log_info("\nAnálise semântica concluída com sucesso\n");
+        if (log_enabled(LOG_DEBUG)) {
+            log_debug("\nTabela de Símbolos Final:\n");
+            log_debug("────────────────────────────────────────────────────────────\n");
+            print_symbol_table(analyzer->symbol_table);
+        }
     }
 }
@@ -20,11 +20,13 @@ typedef struct SemanticAnalyzer {
     bool in_function;
     Type* current_function_return_type;
     bool in_loop;
+    
+    Arena* arena;            // Tipos e símbolos da compilação (NULL = heap)
 } SemanticAnalyzer;
 
 // ==================== CRIAÇÃO E DESTRUIÇÃO ====================
 
-SemanticAnalyzer* create_semantic_analyzer();
+SemanticAnalyzer* create_semantic_analyzer(Arena* arena);
 void free_semantic_analyzer(SemanticAnalyzer* analyzer);
 
 // ==================== ANÁLISE PRINCIPAL ====================
@@ -69,6 +71,11 @@ bool check_binary_op_types(SemanticAnalyzer* analyzer,
                            Type* left, Type* right, const char* op,
                            int line, int column);
 
+// Estágio sum/mean/count/min/max (chamada ou AggregateTransform) cujos
+// argumentos são todos nomes de coluna, como os aceitos logo após groupby.
+// Usado pela análise e pelo codegen para decidirem juntos a fusão.
+bool extract_group_aggregate(ASTNode* stage, AggregateType* agg, ASTNode*** args, int* arg_count);
+
 // ==================== CONVERSÃO DE TIPOS DA AST ====================
 
 Type* ast_type_to_type(SemanticAnalyzer* analyzer, ASTNode* type_node);
@@ -9,13 +9,20 @@
 #include <string.h>
 #include <stdarg.h>
 #include "symbol_table.h"
+#include "log.h"
 
 // ==================== FUNÇÕES AUXILIARES ====================
 
-static Symbol* create_symbol(const char* name, SymbolKind kind, Type* type,
-                             int line, int column) {
-    Symbol* symbol = calloc(1, sizeof(Symbol));
-    symbol->name = strdup(name);
+// Memória de símbolos: arena da tabela (liberada junto com ela) ou heap
+void* symbol_table_alloc(SymbolTable* table, size_t size) {
+    return table->arena ? arena_calloc(table->arena, 1, size) : calloc(1, size);
+}
+
+static Symbol* create_symbol(SymbolTable* table, const char* name, SymbolKind kind,
+                             Type* type, int line, int column) {
+    Symbol* symbol = symbol_table_alloc(table, sizeof(Symbol));
+    symbol->name = (char*)intern_cstr(name);
+    symbol->name_hash = intern_hash(symbol->name);
     symbol->kind = kind;
     symbol->type = type;
     symbol->line = line;
@@ -28,7 +35,6 @@ static Symbol* create_symbol(const char* name, SymbolKind kind, Type* type,
 
 static void free_symbol(Symbol* symbol) {
     if (!symbol) return;
-    free(symbol->name);
     if (symbol->type) free_type(symbol->type);
     if (symbol->param_types) {
         for (int i = 0; i < symbol->param_count; i++) {
@@ -47,27 +53,69 @@ static void free_symbol(Symbol* symbol) {
 
 static Scope* create_scope(Scope* parent) {
     Scope* scope = calloc(1, sizeof(Scope));
-    scope->symbol_capacity = 10;
+    scope->symbol_capacity = 8;
     scope->symbols = malloc(scope->symbol_capacity * sizeof(Symbol*));
     scope->symbol_count = 0;
+    scope->bucket_capacity = 16;
+    scope->buckets = calloc(scope->bucket_capacity, sizeof(Symbol*));
     scope->parent = parent;
     scope->depth = parent ? parent->depth + 1 : 0;
     return scope;
 }
 
-static void free_scope(Scope* scope) {
+static void free_scope(SymbolTable* table, Scope* scope) {
     if (!scope) return;
-    for (int i = 0; i < scope->symbol_count; i++) {
+    for (int i = 0; !table->arena && i < scope->symbol_count; i++) {
         free_symbol(scope->symbols[i]);
     }
     free(scope->symbols);
+    free(scope->buckets);
     free(scope);
 }
 
+// ==================== TABELA HASH DOS ESCOPOS ====================
+
+static void scope_insert_bucket(Scope* scope, Symbol* symbol) {
+    unsigned mask = (unsigned)scope->bucket_capacity - 1;
+    unsigned i = symbol->name_hash & mask;
+    while (scope->buckets[i]) i = (i + 1) & mask;
+    scope->buckets[i] = symbol;
+}
+
+// Mantém a ocupação da tabela abaixo de 50%
+static void scope_add_symbol(Scope* scope, Symbol* symbol) {
+    if (scope->symbol_count >= scope->symbol_capacity) {
+        scope->symbol_capacity *= 2;
+        scope->symbols = realloc(scope->symbols, scope->symbol_capacity * sizeof(Symbol*));
+    }
+    scope->symbols[scope->symbol_count++] = symbol;
+
+    if (scope->symbol_count * 2 > scope->bucket_capacity) {
+        free(scope->buckets);
+        scope->bucket_capacity *= 2;
+        scope->buckets = calloc(scope->bucket_capacity, sizeof(Symbol*));
+        for (int i = 0; i < scope->symbol_count; i++) {
+            scope_insert_bucket(scope, scope->symbols[i]);
+        }
+    } else {
+        scope_insert_bucket(scope, symbol);
+    }
+}
+
+// name precisa ser internado: a comparação é por ponteiro
+static Symbol* scope_find(Scope* scope, const char* name, uint32_t hash) {
+    unsigned mask = (unsigned)scope->bucket_capacity - 1;
+    for (unsigned i = hash & mask; scope->buckets[i]; i = (i + 1) & mask) {
+        if (scope->buckets[i]->name == name) return scope->buckets[i];
+    }
+    return NULL;
+}
+
 // ==================== CRIAÇÃO E DESTRUIÇÃO ====================
 
-SymbolTable* create_symbol_table() {
+SymbolTable* create_symbol_table(Arena* arena) {
     SymbolTable* table = calloc(1, sizeof(SymbolTable));
+    table->arena = arena;
     table->global_scope = create_scope(NULL);
     table->current_scope = table->global_scope;
     table->error_capacity = 10;
@@ -83,7 +131,7 @@ void free_symbol_table(SymbolTable* table) {
     Scope* scope = table->current_scope;
     while (scope) {
         Scope* parent = scope->parent;
-        free_scope(scope);
+        free_scope(table, scope);
         scope = parent;
     }
     
@@ -104,7 +152,7 @@ void enter_scope(SymbolTable* table) {
 
 void exit_scope(SymbolTable* table) {
     if (!table->current_scope->parent) {
-        fprintf(stderr, "Erro: tentativa de sair do escopo global!\n");
+        log_error("Erro: tentativa de sair do escopo global!\n");
         return;
     }
     
@@ -119,7 +167,7 @@ void exit_scope(SymbolTable* table) {
     
     Scope* old_scope = table->current_scope;
     table->current_scope = old_scope->parent;
-    free_scope(old_scope);
+    free_scope(table, old_scope);
 }
 
 int get_scope_depth(SymbolTable* table) {
@@ -139,16 +187,8 @@ Symbol* declare_symbol(SymbolTable* table, const char* name, SymbolKind kind,
         return NULL;
     }
     
-    Symbol* symbol = create_symbol(name, kind, type, line, column);
-    
-    // Adiciona ao escopo atual
-    if (table->current_scope->symbol_count >= table->current_scope->symbol_capacity) {
-        table->current_scope->symbol_capacity *= 2;
-        table->current_scope->symbols = realloc(table->current_scope->symbols,
-            table->current_scope->symbol_capacity * sizeof(Symbol*));
-    }
-    
-    table->current_scope->symbols[table->current_scope->symbol_count++] = symbol;
+    Symbol* symbol = create_symbol(table, name, kind, type, line, column);
+    scope_add_symbol(table->current_scope, symbol);
     return symbol;
 }
 
@@ -160,7 +200,7 @@ Symbol* declare_function(SymbolTable* table, const char* name, Type* return_type
     Symbol* symbol = declare_symbol(table, name, SYMBOL_FUNCTION, func_type, line, column);
     if (symbol) {
         symbol->param_count = param_count;
-        symbol->param_types = malloc(param_count * sizeof(Type*));
+        symbol->param_types = symbol_table_alloc(table, param_count * sizeof(Type*));
         for (int i = 0; i < param_count; i++) {
             symbol->param_types[i] = clone_type(param_types[i]);
         }
@@ -176,7 +216,7 @@ Symbol* declare_type(SymbolTable* table, const char* name, Symbol** fields,
     
     if (symbol) {
         symbol->field_count = field_count;
-        symbol->fields = malloc(field_count * sizeof(Symbol*));
+        symbol->fields = symbol_table_alloc(table, field_count * sizeof(Symbol*));
         for (int i = 0; i < field_count; i++) {
             symbol->fields[i] = fields[i];
         }
@@ -188,28 +228,23 @@ Symbol* declare_type(SymbolTable* table, const char* name, Symbol** fields,
 // ==================== BUSCA DE SÍMBOLOS ====================
 
 Symbol* lookup_symbol(SymbolTable* table, const char* name) {
-    Scope* scope = table->current_scope;
+    // Nome nunca internado não pode ter sido declarado
+    const char* key = intern_find(name);
+    if (!key) return NULL;
+    uint32_t hash = intern_hash(key);
     
     // Busca do escopo mais interno para o mais externo
-    while (scope) {
-        for (int i = 0; i < scope->symbol_count; i++) {
-            if (strcmp(scope->symbols[i]->name, name) == 0) {
-                return scope->symbols[i];
-            }
-        }
-        scope = scope->parent;
+    for (Scope* scope = table->current_scope; scope; scope = scope->parent) {
+        Symbol* symbol = scope_find(scope, key, hash);
+        if (symbol) return symbol;
     }
     
     return NULL;
 }
 
 Symbol* lookup_in_current_scope(SymbolTable* table, const char* name) {
-    for (int i = 0; i < table->current_scope->symbol_count; i++) {
-        if (strcmp(table->current_scope->symbols[i]->name, name) == 0) {
-            return table->current_scope->symbols[i];
-        }
-    }
-    return NULL;
+    const char* key = intern_find(name);
+    return key ? scope_find(table->current_scope, key, intern_hash(key)) : NULL;
 }
 
 // ==================== MARCAÇÃO DE USO ====================
@@ -244,7 +279,7 @@ void check_unused_symbols(SymbolTable* table) {
         for (int i = 0; i < scope->symbol_count; i++) {
             Symbol* sym = scope->symbols[i];
             if (!sym->used && sym->kind == SYMBOL_VARIABLE) {
-                printf("Aviso [linha %d]: Variável '%s' declarada mas nunca usada\n",
+                log_warn("Aviso [linha %d]: Variável '%s' declarada mas nunca usada\n",
                        sym->line, sym->name);
             }
         }
@@ -282,15 +317,15 @@ void symbol_table_error(SymbolTable* table, int line, int column,
 
 void print_symbol_table_errors(SymbolTable* table) {
     if (table->error_count > 0) {
-        printf("\n╔════════════════════════════════════════════════════════════╗\n");
-        printf("║         ERROS SEMÂNTICOS ENCONTRADOS (%d)                  \n", 
-               table->error_count);
-        printf("╚════════════════════════════════════════════════════════════╝\n\n");
+        log_error("\n╔════════════════════════════════════════════════════════════╗\n");
+        log_error("║         ERROS SEMÂNTICOS ENCONTRADOS (%d)                  \n", 
+                  table->error_count);
+        log_error("╚════════════════════════════════════════════════════════════╝\n\n");
         
         for (int i = 0; i < table->error_count; i++) {
-            printf("  %d. %s\n", i + 1, table->error_messages[i]);
+            log_error("  %d. %s\n", i + 1, table->error_messages[i]);
         }
-        printf("\n");
+        log_error("\n");
     }
 }
 
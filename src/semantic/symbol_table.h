@@ -8,6 +8,8 @@
 
 #include <stdbool.h>
 #include "type_system.h"
+#include "arena.h"
+#include "intern.h"
 
 // ==================== ESTRUTURAS ====================
 
@@ -20,7 +22,8 @@ typedef enum {
 } SymbolKind;
 
 typedef struct Symbol {
-    char* name;              // Nome do símbolo
+    char* name;              // Nome do símbolo (internado)
+    uint32_t name_hash;      // intern_hash(name)
     SymbolKind kind;         // Tipo de símbolo
     Type* type;              // Tipo do símbolo
     int line;                // Linha onde foi declarado
@@ -41,9 +44,11 @@ typedef struct Symbol {
 } Symbol;
 
 typedef struct Scope {
-    Symbol** symbols;        // Array de símbolos neste escopo
+    Symbol** symbols;        // Array de símbolos neste escopo (ordem de declaração)
     int symbol_count;
     int symbol_capacity;
+    Symbol** buckets;        // Tabela hash (endereçamento aberto) sobre symbols
+    int bucket_capacity;     // Potência de 2
     struct Scope* parent;    // Escopo pai (NULL se global)
     int depth;               // Profundidade do escopo (0 = global)
 } Scope;
@@ -54,13 +59,15 @@ typedef struct SymbolTable {
     int error_count;
     char** error_messages;
     int error_capacity;
+    Arena* arena;            // Símbolos e nomes (NULL = heap)
 } SymbolTable;
 
 // ==================== FUNÇÕES PÚBLICAS ====================
 
 // Criação e destruição
-SymbolTable* create_symbol_table();
+SymbolTable* create_symbol_table(Arena* arena);
 void free_symbol_table(SymbolTable* table);
+void* symbol_table_alloc(SymbolTable* table, size_t size);
 
 // Gerenciamento de escopos
 void enter_scope(SymbolTable* table);
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include "type_inference.h"
+#include "log.h"
 
 // ==================== SUBSTITUIÇÃO ====================
 
@@ -70,8 +71,14 @@ Type* apply_substitution(Substitution* sub, Type* type) {
         return type;
     }
     
+    // Tipos primitivos não mudam
+    if (type->kind != TYPE_ARRAY && type->kind != TYPE_TUPLE &&
+        type->kind != TYPE_FUNCTION && type->kind != TYPE_CUSTOM) {
+        return type;
+    }
+    
     // Aplica recursivamente para tipos compostos
-    Type* result = calloc(1, sizeof(Type));
+    Type* result = type_alloc(sizeof(Type));
     result->kind = type->kind;
     
     switch (type->kind) {
@@ -81,7 +88,7 @@ Type* apply_substitution(Substitution* sub, Type* type) {
             
         case TYPE_TUPLE:
             result->tuple_count = type->tuple_count;
-            result->tuple_types = malloc(type->tuple_count * sizeof(Type*));
+            result->tuple_types = type_alloc(type->tuple_count * sizeof(Type*));
             for (int i = 0; i < type->tuple_count; i++) {
                 result->tuple_types[i] = apply_substitution(sub, type->tuple_types[i]);
             }
@@ -89,7 +96,7 @@ Type* apply_substitution(Substitution* sub, Type* type) {
             
         case TYPE_FUNCTION:
             result->param_count = type->param_count;
-            result->param_types = malloc(type->param_count * sizeof(Type*));
+            result->param_types = type_alloc(type->param_count * sizeof(Type*));
             for (int i = 0; i < type->param_count; i++) {
                 result->param_types[i] = apply_substitution(sub, type->param_types[i]);
             }
@@ -97,13 +104,11 @@ Type* apply_substitution(Substitution* sub, Type* type) {
             break;
             
         case TYPE_CUSTOM:
-            result->custom_name = strdup(type->custom_name);
+            result->custom_name = type_strdup(type->custom_name);
             break;
             
         default:
-            // Tipos primitivos não mudam
-            free(result);
-            return type;
+            break;
     }
     
     return result;
@@ -379,14 +384,14 @@ void inference_error(InferenceContext* ctx, const char* format, ...) {
 
 void print_inference_errors(InferenceContext* ctx) {
     if (ctx->error_count > 0) {
-        printf("\n╔════════════════════════════════════════════════════════════╗\n");
-        printf("║         ERROS DE INFERÊNCIA DE TIPOS (%d)                  \n", 
-               ctx->error_count);
-        printf("╚════════════════════════════════════════════════════════════╝\n\n");
+        log_error("\n╔════════════════════════════════════════════════════════════╗\n");
+        log_error("║         ERROS DE INFERÊNCIA DE TIPOS (%d)                  \n", 
+                  ctx->error_count);
+        log_error("╚════════════════════════════════════════════════════════════╝\n\n");
         
         for (int i = 0; i < ctx->error_count; i++) {
-            printf("  %d. %s\n", i + 1, ctx->error_messages[i]);
+            log_error("  %d. %s\n", i + 1, ctx->error_messages[i]);
         }
-        printf("\n");
+        log_error("\n");
     }
 }
\ No newline at end of file
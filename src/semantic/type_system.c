@@ -9,25 +9,42 @@
 #include <string.h>
 #include "type_system.h"
 
+// ==================== ALOCAÇÃO ====================
+
+// Arena dos tipos da compilação atual (NULL = heap, liberado por free_type)
+static Arena* type_arena = NULL;
+
+void type_system_set_arena(Arena* arena) {
+    type_arena = arena;
+}
+
+void* type_alloc(size_t size) {
+    return type_arena ? arena_calloc(type_arena, 1, size) : calloc(1, size);
+}
+
+char* type_strdup(const char* str) {
+    return type_arena ? arena_strdup(type_arena, str) : strdup(str);
+}
+
 // ==================== CRIAÇÃO DE TIPOS ====================
 
 Type* create_primitive_type(TypeKind kind) {
-    Type* type = calloc(1, sizeof(Type));
+    Type* type = type_alloc(sizeof(Type));
     type->kind = kind;
     return type;
 }
 
 Type* create_array_type(Type* element_type) {
-    Type* type = calloc(1, sizeof(Type));
+    Type* type = type_alloc(sizeof(Type));
     type->kind = TYPE_ARRAY;
     type->element_type = element_type;
     return type;
 }
 
 Type* create_tuple_type(Type** types, int count) {
-    Type* type = calloc(1, sizeof(Type));
+    Type* type = type_alloc(sizeof(Type));
     type->kind = TYPE_TUPLE;
-    type->tuple_types = malloc(count * sizeof(Type*));
+    type->tuple_types = type_alloc(count * sizeof(Type*));
     type->tuple_count = count;
     for (int i = 0; i < count; i++) {
         type->tuple_types[i] = types[i];
@@ -36,9 +53,9 @@ Type* create_tuple_type(Type** types, int count) {
 }
 
 Type* create_function_type(Type** param_types, int param_count, Type* return_type) {
-    Type* type = calloc(1, sizeof(Type));
+    Type* type = type_alloc(sizeof(Type));
     type->kind = TYPE_FUNCTION;
-    type->param_types = malloc(param_count * sizeof(Type*));
+    type->param_types = type_alloc(param_count * sizeof(Type*));
     type->param_count = param_count;
     for (int i = 0; i < param_count; i++) {
         type->param_types[i] = param_types[i];
@@ -48,21 +65,21 @@ Type* create_function_type(Type** param_types, int param_count, Type* return_typ
 }
 
 Type* create_custom_type(const char* name) {
-    Type* type = calloc(1, sizeof(Type));
+    Type* type = type_alloc(sizeof(Type));
     type->kind = TYPE_CUSTOM;
-    type->custom_name = strdup(name);
+    type->custom_name = type_strdup(name);
     return type;
 }
 
 Type* create_type_var(int id) {
-    Type* type = calloc(1, sizeof(Type));
+    Type* type = type_alloc(sizeof(Type));
     type->kind = TYPE_VAR;
     type->var_id = id;
     
     // Gera nome único
     char buffer[32];
     snprintf(buffer, sizeof(buffer), "T%d", id);
-    type->var_name = strdup(buffer);
+    type->var_name = type_strdup(buffer);
     
     return type;
 }
@@ -76,13 +93,13 @@ Type* create_error_type() {
 Type* clone_type(Type* type) {
     if (!type) return NULL;
     
-    Type* clone = calloc(1, sizeof(Type));
+    Type* clone = type_alloc(sizeof(Type));
     clone->kind = type->kind;
     
     switch (type->kind) {
         case TYPE_VAR:
             clone->var_id = type->var_id;
-            clone->var_name = strdup(type->var_name);
+            clone->var_name = type_strdup(type->var_name);
             break;
             
         case TYPE_ARRAY:
@@ -91,7 +108,7 @@ Type* clone_type(Type* type) {
             
         case TYPE_TUPLE:
             clone->tuple_count = type->tuple_count;
-            clone->tuple_types = malloc(type->tuple_count * sizeof(Type*));
+            clone->tuple_types = type_alloc(type->tuple_count * sizeof(Type*));
             for (int i = 0; i < type->tuple_count; i++) {
                 clone->tuple_types[i] = clone_type(type->tuple_types[i]);
             }
@@ -99,7 +116,7 @@ Type* clone_type(Type* type) {
             
         case TYPE_FUNCTION:
             clone->param_count = type->param_count;
-            clone->param_types = malloc(type->param_count * sizeof(Type*));
+            clone->param_types = type_alloc(type->param_count * sizeof(Type*));
             for (int i = 0; i < type->param_count; i++) {
                 clone->param_types[i] = clone_type(type->param_types[i]);
             }
@@ -107,7 +124,7 @@ Type* clone_type(Type* type) {
             break;
             
         case TYPE_CUSTOM:
-            clone->custom_name = strdup(type->custom_name);
+            clone->custom_name = type_strdup(type->custom_name);
             break;
             
         default:
@@ -118,7 +135,8 @@ Type* clone_type(Type* type) {
 }
 
 void free_type(Type* type) {
-    if (!type) return;
+    // Tipos da arena são liberados junto com ela
+    if (!type || type_arena) return;
     
     switch (type->kind) {
         case TYPE_VAR:
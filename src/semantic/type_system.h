@@ -7,6 +7,8 @@
 #define TYPE_SYSTEM_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
 
 // ==================== TIPOS PRIMITIVOS E COMPOSTOS ====================
 
@@ -51,6 +53,14 @@ typedef struct Type {
     
 } Type;
 
+// ==================== ALOCAÇÃO ====================
+
+// Com uma arena definida, todos os tipos passam a ser alocados nela e
+// free_type não faz nada; NULL volta a usar o heap
+void type_system_set_arena(Arena* arena);
+void* type_alloc(size_t size);
+char* type_strdup(const char* str);
+
 // ==================== CRIAÇÃO DE TIPOS ====================
 
 Type* create_primitive_type(TypeKind kind);